@@ -0,0 +1,406 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_DOMAIN_DECOMPOSITION_H
+#define INTEGRATORS_DOMAIN_DECOMPOSITION_H
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <type_traits>
+
+#include <mpi.h>
+
+#include "../exception/exception.h"
+
+// Returns the MPI datatype that matches the real number type
+template <typename real_t>
+MPI_Datatype mpi_real_type() {
+    if constexpr (std::is_same_v<real_t, float>)
+        return MPI_FLOAT;
+    else if constexpr (std::is_same_v<real_t, long double>)
+        return MPI_LONG_DOUBLE;
+    else
+        return MPI_DOUBLE;
+}
+
+// This class splits the simulation domain between the ranks of an MPI communicator into slabs along one axis
+// Each rank owns the fields inside of its slab and keeps copies (ghosts) of the fields of the adjacent ranks
+// that are closer than r_halo to its slab
+//
+// The field buffers of a rank have a fixed capacity and are laid out as [owned | ghosts | free]
+// Free slots have zero velocity and acceleration, so they can be integrated with the rest of the buffer
+//
+// Notes:
+// Field values are sent as raw bytes, so the field type must not own heap memory (for example, fixed-size Eigen vectors)
+// Every rank keeps the global ids of the fields in its buffers, so the results can be gathered in the global order
+template <typename field_value_t, typename real_t>
+class domain_decomposition {
+public:
+    typedef std::vector<field_value_t> field_container_t;
+    typedef std::vector<long> index_container_t;
+
+    // Class constructor
+    //
+    // Notes:
+    // Global ids are assigned in the rank order, i.e. the fields initially held by rank 0 come first
+    // Until rebalance() is called, the slabs between the first and the last one are r_halo wide and centered at zero
+    domain_decomposition(MPI_Comm comm,             // communicator of the ranks that share the domain
+                         long capacity,             // number of field slots on this rank
+                         int axis,                  // axis along which the domain is split into slabs
+                         real_t r_halo,             // distance from the slab boundary within which fields are copied to the adjacent rank
+                         long n_local,              // number of fields initially held by this rank
+                         field_value_t field_zero) :// zero value of the primary field type used
+            comm(comm), capacity(capacity), axis(axis), r_halo(r_halo), field_zero(std::move(field_zero)),
+            n_owned(n_local), global_ids(capacity, -1) {
+
+        if (n_local > capacity)
+            throw CapacityExceededException("domain_decomposition(MPI_Comm, long, int, real_t, long, field_value_t)");
+
+        MPI_Comm_rank(comm, &rank);
+        MPI_Comm_size(comm, &size);
+
+        // The result of the exclusive scan is undefined on rank 0
+        long first_id = 0;
+        MPI_Exscan(&n_local, &first_id, 1, MPI_LONG, MPI_SUM, comm);
+        if (rank == 0)
+            first_id = 0;
+
+        std::iota(global_ids.begin(), global_ids.begin() + n_local, first_id);
+        MPI_Allreduce(&n_local, &n_global, 1, MPI_LONG, MPI_SUM, comm);
+
+        boundaries.resize(size + 1, real_t(0));
+        boundaries.front() = std::numeric_limits<real_t>::lowest();
+        boundaries.back() = std::numeric_limits<real_t>::max();
+        spread_boundaries(real_t(0));
+    }
+
+    // Moves the owned fields to the ranks whose slabs contain them
+    // Ghosts are dropped, so select_ghosts() has to be called afterwards
+    //
+    // Notes:
+    // The first buffer must contain positions, all buffers are moved along with them
+    // The buffers must hold the state that the integrator carries between steps (x, v, a, ...)
+    void migrate(std::vector<field_container_t *> const & fields) {
+        field_container_t const & x = *fields.front();
+        const long n_fields = (long) fields.size();
+
+        std::vector<int> destination(n_owned);
+        std::vector<int> send_counts(size, 0), receive_counts(size);
+        for (long i = 0; i < n_owned; i ++) {
+            destination[i] = owner_of(x[i][axis]);
+            if (destination[i] != rank)
+                send_counts[destination[i]] ++;
+        }
+
+        MPI_Alltoall(send_counts.data(), 1, MPI_INT, receive_counts.data(), 1, MPI_INT, comm);
+
+        std::vector<int> send_offsets(size, 0), receive_offsets(size, 0);
+        std::exclusive_scan(send_counts.begin(), send_counts.end(), send_offsets.begin(), 0);
+        std::exclusive_scan(receive_counts.begin(), receive_counts.end(), receive_offsets.begin(), 0);
+        const long n_sent = send_offsets.back() + send_counts.back();
+        const long n_received = receive_offsets.back() + receive_counts.back();
+
+        // Each departing field is packed as a record of n_fields consecutive values
+        index_container_t send_ids(n_sent), receive_ids(n_received);
+        send_buffer.resize(n_sent * n_fields);
+        receive_buffer.resize(n_received * n_fields);
+
+        std::vector<int> positions = send_offsets;
+        for (long i = 0; i < n_owned; i ++) {
+            if (destination[i] == rank)
+                continue;
+
+            const long k = positions[destination[i]] ++;
+            send_ids[k] = global_ids[i];
+            for (long f = 0; f < n_fields; f ++)
+                send_buffer[k * n_fields + f] = (*fields[f])[i];
+        }
+
+        MPI_Alltoallv(send_ids.data(), send_counts.data(), send_offsets.data(), MPI_LONG,
+                      receive_ids.data(), receive_counts.data(), receive_offsets.data(), MPI_LONG, comm);
+
+        scale_counts(send_counts, send_offsets, n_fields);
+        scale_counts(receive_counts, receive_offsets, n_fields);
+        MPI_Alltoallv(send_buffer.data(), send_counts.data(), send_offsets.data(), MPI_BYTE,
+                      receive_buffer.data(), receive_counts.data(), receive_offsets.data(), MPI_BYTE, comm);
+
+        // The fields that stay are compacted in their original order
+        long n_kept = 0;
+        for (long i = 0; i < n_owned; i ++) {
+            if (destination[i] != rank)
+                continue;
+
+            if (n_kept != i) {
+                global_ids[n_kept] = global_ids[i];
+                for (long f = 0; f < n_fields; f ++)
+                    (*fields[f])[n_kept] = (*fields[f])[i];
+            }
+            n_kept ++;
+        }
+
+        if (n_kept + n_received > capacity)
+            throw CapacityExceededException("domain_decomposition::migrate()");
+
+        for (long k = 0; k < n_received; k ++) {
+            global_ids[n_kept + k] = receive_ids[k];
+            for (long f = 0; f < n_fields; f ++)
+                (*fields[f])[n_kept + k] = receive_buffer[k * n_fields + f];
+        }
+
+        // Slots released by departed fields and by ghosts become free
+        const long n_used = n_owned + n_ghost;
+        n_owned = n_kept + n_received;
+        n_ghost_lower = n_ghost_upper = n_ghost = 0;
+        send_lower.clear();
+        send_upper.clear();
+
+        for (long i = n_owned; i < n_used; i ++) {
+            global_ids[i] = -1;
+            for (long f = 0; f < n_fields; f ++)
+                (*fields[f])[i] = field_zero;
+        }
+    }
+
+    // Selects the owned fields that are copied to the adjacent ranks and receives the ghosts from them
+    // The same fields are exchanged by exchange_halo() until the next call
+    //
+    // Notes:
+    // The first buffer must contain positions, the buffers must be those exchanged by exchange_halo()
+    // Must be called after migrate()
+    void select_ghosts(std::vector<field_container_t *> const & fields) {
+        field_container_t const & x = *fields.front();
+
+        for (long i = 0; i < n_owned; i ++) {
+            const real_t coordinate = x[i][axis];
+            if (rank > 0 && coordinate < boundaries[rank] + r_halo)
+                send_lower.emplace_back(i);
+            if (rank < size - 1 && coordinate >= boundaries[rank + 1] - r_halo)
+                send_upper.emplace_back(i);
+        }
+
+        long n_send_lower = (long) send_lower.size(), n_send_upper = (long) send_upper.size();
+        n_ghost_lower = n_ghost_upper = 0;
+        MPI_Sendrecv(&n_send_lower, 1, MPI_LONG, lower_rank(), 0,
+                     &n_ghost_upper, 1, MPI_LONG, upper_rank(), 0, comm, MPI_STATUS_IGNORE);
+        MPI_Sendrecv(&n_send_upper, 1, MPI_LONG, upper_rank(), 1,
+                     &n_ghost_lower, 1, MPI_LONG, lower_rank(), 1, comm, MPI_STATUS_IGNORE);
+
+        n_ghost = n_ghost_lower + n_ghost_upper;
+        if (n_owned + n_ghost > capacity)
+            throw CapacityExceededException("domain_decomposition::select_ghosts()");
+
+        // Ghosts of the lower rank are placed right after the owned fields, followed by ghosts of the upper rank
+        index_container_t send_ids_lower(n_send_lower), send_ids_upper(n_send_upper);
+        for (long k = 0; k < n_send_lower; k ++)
+            send_ids_lower[k] = global_ids[send_lower[k]];
+        for (long k = 0; k < n_send_upper; k ++)
+            send_ids_upper[k] = global_ids[send_upper[k]];
+
+        MPI_Sendrecv(send_ids_lower.data(), (int) n_send_lower, MPI_LONG, lower_rank(), 2,
+                     global_ids.data() + n_owned + n_ghost_lower, (int) n_ghost_upper, MPI_LONG, upper_rank(), 2,
+                     comm, MPI_STATUS_IGNORE);
+        MPI_Sendrecv(send_ids_upper.data(), (int) n_send_upper, MPI_LONG, upper_rank(), 3,
+                     global_ids.data() + n_owned, (int) n_ghost_lower, MPI_LONG, lower_rank(), 3,
+                     comm, MPI_STATUS_IGNORE);
+
+        exchange_halo(fields);
+    }
+
+    // Refreshes the ghosts with the current values of the fields owned by the adjacent ranks
+    // Called every time the accelerations are computed
+    void exchange_halo(std::vector<field_container_t *> const & fields) {
+        exchange(fields, send_lower, lower_rank(), n_owned + n_ghost_lower, n_ghost_upper, upper_rank(), 4);
+        exchange(fields, send_upper, upper_rank(), n_owned, n_ghost_lower, lower_rank(), 5);
+    }
+
+    // Moves the slab boundaries so that every rank owns about the same number of fields
+    // Fields are not moved until the next call to migrate()
+    //
+    // Notes:
+    // Slabs between two other slabs are kept at least r_halo wide, so ghosts only come from the adjacent ranks
+    void rebalance(field_container_t const & x /* buffer with positions */) {
+        if (size == 1)
+            return;
+
+        real_t local_range[2] = {std::numeric_limits<real_t>::max(), std::numeric_limits<real_t>::max()};
+        for (long i = 0; i < n_owned; i ++) {
+            local_range[0] = std::min(local_range[0], x[i][axis]);
+            local_range[1] = std::min(local_range[1], real_t(-x[i][axis]));
+        }
+
+        real_t global_range[2];
+        MPI_Allreduce(local_range, global_range, 2, mpi_real_type<real_t>(), MPI_MIN, comm);
+        const real_t lower = global_range[0], upper = -global_range[1];
+
+        // Without a range to split (no fields, or all fields at one coordinate), the slabs are placed around the fields
+        if (!(upper > lower)) {
+            spread_boundaries(lower <= upper ? lower : real_t(0));
+            return;
+        }
+
+        // The global distribution of fields along the axis is estimated with a histogram
+        const long n_bins = 64 * size;
+        const real_t bin_width = (upper - lower) / real_t(n_bins);
+
+        std::vector<long> local_histogram(n_bins, 0), histogram(n_bins);
+        for (long i = 0; i < n_owned; i ++) {
+            const long bin = std::min(n_bins - 1, long((x[i][axis] - lower) / bin_width));
+            local_histogram[bin] ++;
+        }
+        MPI_Allreduce(local_histogram.data(), histogram.data(), (int) n_bins, MPI_LONG, MPI_SUM, comm);
+
+        long bin = 0, cumulative = histogram[0];
+        for (int k = 1; k < size; k ++) {
+            const long target = n_global * k / size;
+            while (cumulative < target && bin < n_bins - 1)
+                cumulative += histogram[++ bin];
+
+            boundaries[k] = lower + real_t(bin + 1) * bin_width;
+        }
+
+        for (int k = 2; k < size; k ++)
+            boundaries[k] = std::max(boundaries[k], boundaries[k - 1] + r_halo);
+    }
+
+    // Collects the values of the owned fields on the root rank, ordered by global id
+    // Returns an empty container on the other ranks
+    [[nodiscard]] field_container_t gather(field_container_t const & field,      // buffer with the values to collect
+                                           int root = 0) const {                // rank that receives the values
+        int count = (int) n_owned;
+        std::vector<int> counts(size), offsets(size, 0);
+        MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, root, comm);
+        std::exclusive_scan(counts.begin(), counts.end(), offsets.begin(), 0);
+
+        const long n_total = rank == root ? n_global : 0;
+        index_container_t ids(n_total);
+        field_container_t values(n_total);
+
+        MPI_Gatherv(global_ids.data(), count, MPI_LONG, ids.data(), counts.data(), offsets.data(), MPI_LONG, root, comm);
+
+        scale_counts(counts, offsets, 1);
+        MPI_Gatherv(field.data(), count * (int) sizeof(field_value_t), MPI_BYTE,
+                    values.data(), counts.data(), offsets.data(), MPI_BYTE, root, comm);
+
+        field_container_t result(n_total);
+        for (long k = 0; k < n_total; k ++)
+            result[ids[k]] = values[k];
+
+        return result;
+    }
+
+    // Returns the rank whose slab contains the coordinate
+    [[nodiscard]] int owner_of(real_t coordinate /* coordinate along the decomposition axis */) const {
+        return int(std::upper_bound(boundaries.begin() + 1, boundaries.end() - 1, coordinate) - (boundaries.begin() + 1));
+    }
+
+    // Getter for the number of fields owned by this rank
+    [[nodiscard]] long get_n_owned() const {
+        return n_owned;
+    }
+
+    // Getter for the number of ghosts held by this rank
+    [[nodiscard]] long get_n_ghost() const {
+        return n_ghost;
+    }
+
+    // Getter for the number of fields on all ranks
+    [[nodiscard]] long get_n_global() const {
+        return n_global;
+    }
+
+    // Getter for the global ids of the fields in the buffers of this rank (-1 for free slots)
+    [[nodiscard]] index_container_t const & get_global_ids() const {
+        return global_ids;
+    }
+
+    // Getter for the slab boundaries, slab of rank k is [boundaries[k], boundaries[k + 1])
+    [[nodiscard]] std::vector<real_t> const & get_boundaries() const {
+        return boundaries;
+    }
+
+    // Getter for the rank of this process
+    [[nodiscard]] int get_rank() const {
+        return rank;
+    }
+
+    // Getter for the communicator of the ranks that share the domain
+    [[nodiscard]] MPI_Comm get_communicator() const {
+        return comm;
+    }
+
+private:
+    // Places the boundaries between the slabs r_halo apart and centered at the given coordinate
+    void spread_boundaries(real_t center /* coordinate around which the slabs are placed */) {
+        for (int k = 1; k < size; k ++)
+            boundaries[k] = center + (real_t(k - 1) - real_t(size - 2) / real_t(2)) * r_halo;
+    }
+
+    // Sends the values of the fields in send_indices to one adjacent rank and receives n_receive ghosts
+    // from the other one into the slots starting at receive_offset
+    void exchange(std::vector<field_container_t *> const & fields,
+                  index_container_t const & send_indices,
+                  int destination,
+                  long receive_offset,
+                  long n_receive,
+                  int source,
+                  int tag) {
+        const long n_fields = (long) fields.size();
+        const long n_send = (long) send_indices.size();
+
+        send_buffer.resize(n_send * n_fields);
+        receive_buffer.resize(n_receive * n_fields);
+
+        for (long k = 0; k < n_send; k ++) {
+            for (long f = 0; f < n_fields; f ++)
+                send_buffer[k * n_fields + f] = (*fields[f])[send_indices[k]];
+        }
+
+        MPI_Sendrecv(send_buffer.data(), int(n_send * n_fields * sizeof(field_value_t)), MPI_BYTE, destination, tag,
+                     receive_buffer.data(), int(n_receive * n_fields * sizeof(field_value_t)), MPI_BYTE, source, tag,
+                     comm, MPI_STATUS_IGNORE);
+
+        for (long k = 0; k < n_receive; k ++) {
+            for (long f = 0; f < n_fields; f ++)
+                (*fields[f])[receive_offset + k] = receive_buffer[k * n_fields + f];
+        }
+    }
+
+    // Converts counts and offsets of records with n_fields values to bytes
+    static void scale_counts(std::vector<int> & counts, std::vector<int> & offsets, long n_fields) {
+        for (size_t k = 0; k < counts.size(); k ++) {
+            counts[k] *= int(n_fields * sizeof(field_value_t));
+            offsets[k] *= int(n_fields * sizeof(field_value_t));
+        }
+    }
+
+    [[nodiscard]] int lower_rank() const {
+        return rank > 0 ? rank - 1 : MPI_PROC_NULL;
+    }
+
+    [[nodiscard]] int upper_rank() const {
+        return rank < size - 1 ? rank + 1 : MPI_PROC_NULL;
+    }
+
+    const MPI_Comm comm;
+    const long capacity;
+    const int axis;
+    const real_t r_halo;
+    const field_value_t field_zero;
+
+    int rank = 0, size = 1;
+    long n_global = 0;
+    long n_owned, n_ghost = 0, n_ghost_lower = 0, n_ghost_upper = 0;
+    index_container_t global_ids;
+    std::vector<real_t> boundaries;
+
+    // Owned fields that are ghosts on the lower and upper adjacent ranks
+    index_container_t send_lower, send_upper;
+
+    // Buffers reused by every exchange
+    field_container_t send_buffer, receive_buffer;
+};
+
+#endif //INTEGRATORS_DOMAIN_DECOMPOSITION_H
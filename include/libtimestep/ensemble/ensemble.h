@@ -0,0 +1,158 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_ENSEMBLE_H
+#define INTEGRATORS_ENSEMBLE_H
+
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <utility>
+
+#include "../exception/exception.h"
+
+// This class holds many independent systems of the same type and steps them together,
+// spreading the members between OpenMP threads
+// The system objects are constructed in place in a single memory pool that is allocated once,
+// every member is aligned to its own cache line, so threads that step adjacent members do not share cache lines
+// Only the system objects are pooled, the field buffers (x, v, a, ...) of each member are allocated by the member itself
+//
+// Notes:
+// The systems are neither copied nor moved, so the integrators of the members keep pointing to their own buffers
+// OpenMP parallel regions of the members are nested inside of the region of the ensemble and run on the calling thread
+// (unless nested parallelism is enabled), so members built on the OpenMP systems are stepped serially
+// Members that use the parallel algorithms of the standard library (e.g. binary_system) still run them on all cores
+// from every thread of the ensemble and oversubscribe the machine, they should be built on serial or OpenMP systems
+template <typename system_t>
+class ensemble {
+public:
+    ensemble(ensemble const &) = delete;
+    ensemble & operator = (ensemble const &) = delete;
+
+    // Class constructor
+    // Allocates the memory for the members, which are then added with emplace()
+    explicit ensemble(long capacity /* largest number of members */) :
+            capacity(capacity),
+            pool(static_cast<std::byte *>(::operator new(capacity * stride, std::align_val_t(alignment)))) {
+        retired.reserve(capacity);
+        active.reserve(capacity);
+    }
+
+    // Class destructor
+    // Destroys the members in the reverse order of construction and releases the memory pool
+    ~ensemble() {
+        for (long member = n_members - 1; member >= 0; member --)
+            (*this)[member].~system_t();
+
+        ::operator delete(pool, std::align_val_t(alignment));
+    }
+
+    // Constructs a new member from the arguments, which carry the parameters of this member
+    // Returns the reference to the new member, it remains valid for the lifetime of the ensemble
+    template <typename... args_t>
+    system_t & emplace(args_t &&... args) {
+        if (n_members == capacity)
+            throw CapacityExceededException("ensemble::emplace()");
+
+        system_t * system = new (pool + n_members * stride) system_t(std::forward<args_t>(args)...);
+
+        retired.emplace_back(false);
+        active.emplace_back(n_members);
+        n_members ++;
+
+        return *system;
+    }
+
+    // Performs one time step of size dt of every active member
+    template <typename real_t>
+    void do_step(real_t dt /* time step */) {
+        do_steps(1, dt, [] (system_t const &, long) -> bool { return false; });
+    }
+
+    // Performs n_steps time steps of size dt of every active member
+    // Each member is stepped by one thread for all n_steps steps, so its buffers stay in the cache of that thread
+    // After every step, retire(member_system, member_index) is called, and the member is retired if it returns true
+    // Retired members are not stepped any more
+    // Returns the number of members that are still active
+    //
+    // Notes:
+    // The retire predicate is called concurrently for different members
+    template <typename real_t, typename predicate_t>
+    long do_steps(long n_steps,             // number of time steps
+                  real_t dt,                // time step
+                  predicate_t && retire) {  // predicate that tells if a member is finished
+        const long n_active = (long) active.size();
+
+        #pragma omp parallel for schedule(dynamic) default(none) shared(n_active, n_steps, dt, retire)
+        for (long k = 0; k < n_active; k ++) {
+            const long member = active[k];
+            system_t & system = (*this)[member];
+
+            for (long n = 0; n < n_steps; n ++) {
+                system.do_step(dt);
+
+                if (retire(static_cast<system_t const &>(system), member)) {
+                    retired[member] = true;
+                    break;
+                }
+            }
+        }
+
+        std::erase_if(active, [this] (long member) {
+            return retired[member];
+        });
+
+        return (long) active.size();
+    }
+
+    // Retires a member, so it is not stepped any more
+    void retire(long member /* index of the member */) {
+        if (retired[member])
+            return;
+
+        retired[member] = true;
+        std::erase(active, member);
+    }
+
+    // Returns true if the member has not been retired
+    [[nodiscard]] bool is_active(long member /* index of the member */) const {
+        return !retired[member];
+    }
+
+    // Returns the number of members
+    [[nodiscard]] long size() const {
+        return n_members;
+    }
+
+    // Returns the number of members that have not been retired
+    [[nodiscard]] long get_n_active() const {
+        return (long) active.size();
+    }
+
+    // Access to a member
+    system_t & operator [] (long member /* index of the member */) {
+        return *std::launder(reinterpret_cast<system_t *>(pool + member * stride));
+    }
+
+    // Constant access to a member
+    system_t const & operator [] (long member /* index of the member */) const {
+        return *std::launder(reinterpret_cast<system_t const *>(pool + member * stride));
+    }
+
+private:
+    // Members are aligned to cache lines, or stricter if the system type requires it
+    static constexpr size_t cache_line_size = 64;
+    static constexpr size_t alignment = alignof(system_t) > cache_line_size ? alignof(system_t) : cache_line_size;
+    static constexpr size_t stride = (sizeof(system_t) + alignment - 1) / alignment * alignment;
+
+    const long capacity;
+    long n_members = 0;
+    std::byte * pool;
+
+    // Flags are stored as char, so different threads can set the flags of different members
+    std::vector<char> retired;
+    std::vector<long> active;
+};
+
+#endif //INTEGRATORS_ENSEMBLE_H
@@ -26,4 +26,129 @@ private:
     std::string message;
 };
 
+// Exception thrown when a buffer with a fixed capacity
+// has to hold more values than it was allocated for
+struct CapacityExceededException : std::exception {
+
+    // Constructor takes one string - function/object that throws the exception
+    explicit CapacityExceededException(std::string const & source) :
+            message("buffer capacity exceeded in " + source) {}
+
+    // Returns the message with error description
+    [[nodiscard]]
+    const char * what() const noexcept override {
+        return message.c_str();
+    }
+
+private:
+    std::string message;
+};
+
+// Exception thrown when a mesh cannot be used by the
+// fast Fourier transform (its size is not a power of two)
+struct MeshSizeException : std::exception {
+
+    // Constructor takes one string - function/object that throws the exception
+    explicit MeshSizeException(std::string const & source) :
+            message("mesh size is not a power of two in " + source) {}
+
+    // Returns the message with error description
+    [[nodiscard]]
+    const char * what() const noexcept override {
+        return message.c_str();
+    }
+
+private:
+    std::string message;
+};
+
+// Exception thrown when a file cannot be written
+struct OutputException : std::exception {
+
+    // Constructor takes one string - function/object that throws the exception
+    explicit OutputException(std::string const & source) :
+            message("failed to write output in " + source) {}
+
+    // Returns the message with error description
+    [[nodiscard]]
+    const char * what() const noexcept override {
+        return message.c_str();
+    }
+
+private:
+    std::string message;
+};
+
+// Exception thrown when a file cannot be read or
+// does not have the expected format
+struct InputException : std::exception {
+
+    // Constructor takes one string - function/object that throws the exception
+    explicit InputException(std::string const & source) :
+            message("failed to read input in " + source) {}
+
+    // Returns the message with error description
+    [[nodiscard]]
+    const char * what() const noexcept override {
+        return message.c_str();
+    }
+
+private:
+    std::string message;
+};
+
+// Exception thrown when a particle cannot be placed
+// without overlaps (the packing is too dense)
+struct PackingException : std::exception {
+
+    // Constructor takes one string - function/object that throws the exception
+    explicit PackingException(std::string const & source) :
+            message("failed to place a particle without overlaps in " + source) {}
+
+    // Returns the message with error description
+    [[nodiscard]]
+    const char * what() const noexcept override {
+        return message.c_str();
+    }
+
+private:
+    std::string message;
+};
+
+// Exception thrown when a parameter is outside
+// of the range of values it can take
+struct InvalidArgumentException : std::exception {
+
+    // Constructor takes one string - function/object that throws the exception
+    explicit InvalidArgumentException(std::string const & source) :
+            message("invalid argument passed to " + source) {}
+
+    // Returns the message with error description
+    [[nodiscard]]
+    const char * what() const noexcept override {
+        return message.c_str();
+    }
+
+private:
+    std::string message;
+};
+
+// Exception thrown when an index (e.g. of a particle,
+// a frame, or a field) is outside of what an object holds
+struct OutOfRangeException : std::exception {
+
+    // Constructor takes one string - function/object that throws the exception
+    explicit OutOfRangeException(std::string const & source) :
+            message("index out of range in " + source) {}
+
+    // Returns the message with error description
+    [[nodiscard]]
+    const char * what() const noexcept override {
+        return message.c_str();
+    }
+
+private:
+    std::string message;
+};
+
 #endif //INTEGRATORS_EXCEPTION_H
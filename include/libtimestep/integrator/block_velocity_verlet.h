@@ -0,0 +1,216 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_BLOCK_VELOCITY_VERLET_H
+#define INTEGRATORS_BLOCK_VELOCITY_VERLET_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+
+#include "../exception/exception.h"
+
+// Integrator template that implements the Velocity Verlet (kick-drift-kick) scheme with hierarchical block time steps
+// Every field is assigned to a level l, on which it is integrated with time step dt / 2^l
+// Positions of all fields are drifted to the end of every substep, but only the fields whose step ends there
+// (the active fields) have their accelerations computed and their velocities kicked
+// The levels are reassigned at the end of the step of every field, a field can only move to a larger step
+// if the end of the new step coincides with the end of a step of the larger levels
+//
+// Notes:
+// The acceleration functor must implement operator() (index_container_t const & active, real_t t) that only computes
+// the accelerations of the fields in the active container (binary_system_omp and binary_system_neighbors_omp implement it)
+// The preferred time step of a field is dt_i = eta * sqrt(length / |a_i|), unless the acceleration functor
+// implements compute_time_step(long i), which is then used instead (e.g. to limit the steps of fields in stiff contacts)
+// All fields are synchronized at the end of every call to do_step()
+template <
+    typename field_container_t,
+    typename field_value_t,
+    typename real_t,
+    typename functor_t,
+    template <
+        typename _field_container_t,
+        typename _field_value_t>
+    typename step_handler_t>
+class block_velocity_verlet : public integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t> {
+public:
+    typedef std::vector<long> index_container_t;
+
+    // Class constructor
+    //
+    // Notes:
+    // Iterators passed to this constructor must remain valid for the duration of use of this integrator
+    // x, v, and a buffers must be of the same size
+    // The acceleration functor and the step handler must exist for the duration of use of this integrator
+    block_velocity_verlet(functor_t & acceleration_functor,                                     // reference to a functor that computes acceleration
+                          real_t t0,                                                            // integration start time
+                          typename field_container_t::iterator x_begin,                         // iterator pointing to the start of the x buffer
+                          typename field_container_t::iterator x_end,                           // iterator pointing to the end of the x buffer
+                          typename field_container_t::iterator v_begin,                         // iterator pointing to the start of the v buffer
+                          typename field_container_t::iterator a_begin,                         // iterator pointing to the start of the a buffer
+                          step_handler_t<field_container_t, field_value_t> & step_handler) :    // reference to an object that handles incrementing positions and velocities
+
+        // Call the superclass constructor
+        integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t> (
+            acceleration_functor, t0, x_begin, x_end, v_begin, a_begin, step_handler),
+            levels(x_end - x_begin, 0), next_tick(x_end - x_begin, 0) {}
+
+    // Sets the deepest level, i.e. the smallest time step is dt / 2^max_level
+    // The steps are counted in ticks of the deepest level with a long, so the level must be in [0, 62]
+    void set_max_level(int new_max_level /* deepest level */) {
+        if (new_max_level < 0 || new_max_level > 62)
+            throw InvalidArgumentException("block_velocity_verlet::set_max_level()");
+
+        this->max_level = new_max_level;
+    }
+
+    // Getter for the deepest level
+    [[nodiscard]] int get_max_level() const {
+        return this->max_level;
+    }
+
+    // Sets the parameters of the acceleration based time step criterion dt_i = eta * sqrt(length / |a_i|)
+    void set_time_step_criterion(real_t new_eta,        // dimensionless accuracy parameter
+                                 real_t new_length) {   // length scale of the system (e.g. particle radius)
+        this->eta = new_eta;
+        this->length = new_length;
+    }
+
+    // Getter for the levels of the fields
+    [[nodiscard]] std::vector<int> const & get_levels() const {
+        return this->levels;
+    }
+
+    // Getter for the total number of accelerations of individual fields computed so far
+    [[nodiscard]] long get_n_field_evaluations() const {
+        return this->n_field_evaluations;
+    }
+
+    // Perform one time step
+    void do_step(real_t dt /*time step*/) {
+        const long n_part = this->x_end_itr - this->x_begin_itr;
+        const long n_ticks = 1l << max_level;
+        const real_t tick = dt / real_t(n_ticks);
+        const real_t t_start = this->t;
+
+        // If this is the first step, compute the accelerations of all fields from the initial condition
+        if (!accelerations_initialized) [[unlikely]] {
+            accelerations_initialized = true;
+
+            this->update_acceleration();
+            n_field_evaluations += n_part;
+        }
+
+        // Every field starts a new step
+        for (long n = 0; n < n_part; n ++) {
+            levels[n] = assign_level(n, dt, 0);
+            next_tick[n] = 1l << (max_level - levels[n]);
+            kick(n, dt, levels[n]);
+        }
+
+        long current_tick = 0;
+        while (current_tick < n_ticks) {
+            // The next substep ends at the earliest end of the step of any field
+            const long end_tick = *std::min_element(next_tick.begin(), next_tick.end());
+
+            for (long n = 0; n < n_part; n ++) {
+                field_value_t const & v = *(this->v_begin_itr + n);
+
+                this->step_handler.increment_x(n, v * (real_t(end_tick - current_tick) * tick), this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+            }
+            current_tick = end_tick;
+
+            active.clear();
+            for (long n = 0; n < n_part; n ++) {
+                if (next_tick[n] == current_tick)
+                    active.emplace_back(n);
+            }
+
+            this->t = t_start + real_t(current_tick) * tick;
+            this->acceleration_functor(static_cast<index_container_t const &>(active), this->t);
+            n_field_evaluations += (long) active.size();
+
+            // Closing half kick of the step that ends, followed by the opening half kick of the next step
+            for (long n : active) {
+                kick(n, dt, levels[n]);
+
+                if (current_tick == n_ticks)
+                    continue;
+
+                levels[n] = assign_level(n, dt, current_tick);
+                next_tick[n] = current_tick + (1l << (max_level - levels[n]));
+                kick(n, dt, levels[n]);
+            }
+        }
+
+        this->t = t_start + dt;
+    }
+
+    // Visits the time, the levels of the fields, and their next ticks with an archive
+    template <typename archive_t>
+    void serialize(archive_t & archive) {
+        integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t>::serialize(archive);
+        archive(accelerations_initialized);
+        archive(n_field_evaluations);
+        archive(levels);
+        archive(next_tick);
+    }
+
+private:
+    // Increments the velocity of field n with half of its time step on the given level
+    void kick(long n, real_t dt, int level) {
+        field_value_t const & a = *(this->a_begin_itr + n);
+
+        this->step_handler.increment_v(n, a * (dt / real_t(2l << level)), this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+    }
+
+    // Returns the level of field n for a step that starts at the given tick
+    // A field without a limit on its step (e.g. without acceleration) takes the largest step, a field with an invalid
+    // (zero, negative, or NaN) preferred step takes the smallest one
+    int assign_level(long n, real_t dt, long current_tick) const {
+        const real_t preferred_step = preferred_time_step(n);
+
+        int level = max_level;
+        if (preferred_step == real_t(INFINITY))
+            level = 0;
+        else if (preferred_step > real_t(0) && std::isfinite(preferred_step))
+            level = std::clamp(int(std::ceil(std::log2(dt / preferred_step))), 0, max_level);
+
+        // The new step has to end together with the steps of all larger levels
+        while (level < max_level && current_tick % (1l << (max_level - level)) != 0)
+            level ++;
+
+        return level;
+    }
+
+    // Returns the time step preferred by field n
+    real_t preferred_time_step(long n) const {
+        if constexpr (requires (functor_t & functor) { functor.compute_time_step(0l); }) {
+            return this->acceleration_functor.compute_time_step(n);
+        } else {
+            const real_t magnitude = field_magnitude(*(this->a_begin_itr + n));
+            return magnitude > real_t(0) ? eta * std::sqrt(length / magnitude) : real_t(INFINITY);
+        }
+    }
+
+    // Magnitude of a field value
+    static real_t field_magnitude(field_value_t const & value) {
+        if constexpr (std::is_arithmetic_v<field_value_t>)
+            return std::abs(value);
+        else
+            return value.norm();
+    }
+
+    int max_level = 4;
+    real_t eta = real_t(0.1), length = real_t(1);
+    bool accelerations_initialized = false;
+    long n_field_evaluations = 0;
+
+    std::vector<int> levels;
+    std::vector<long> next_tick;
+    index_container_t active;
+};
+
+#endif //INTEGRATORS_BLOCK_VELOCITY_VERLET_H
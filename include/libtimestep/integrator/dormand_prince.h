@@ -0,0 +1,373 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_DORMAND_PRINCE_H
+#define INTEGRATORS_DORMAND_PRINCE_H
+
+#include <array>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+
+// Integrator template that implements the adaptive embedded Runge-Kutta scheme of Dormand and Prince,
+// doi:10.1016/0771-050X(80)90013-3, for the first order system dx/dt = v, dv/dt = a(x, v, t)
+// Each step is taken with the fifth order solution, the local error is estimated from the embedded fourth order one,
+// and the steps that violate the tolerances are rejected and repeated with a smaller step size
+// The last stage of an accepted step is the first stage of the next one (FSAL), so a step costs 6 acceleration evaluations
+// Dense output of the fourth order is available inside of the last accepted step (doi:10.1007/978-3-540-78862-1)
+//
+// Notes:
+// The intermediate stages are written to the x and v buffers directly,
+// the step handler is only called for the increments of accepted steps
+// After a step, the a buffer holds the accelerations at the new positions and velocities
+template <
+    typename field_container_t,
+    typename field_value_t,
+    typename real_t,
+    typename functor_t,
+    template <
+        typename _field_container_t,
+        typename _field_value_t>
+    typename step_handler_t>
+class dormand_prince : public integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t> {
+public:
+
+    // Class constructor
+    //
+    // Notes:
+    // Iterators passed to this constructor must remain valid for the duration of use of this integrator
+    // x, v, and a buffers must be of the same size
+    // The acceleration functor and the step handler must exist for the duration of use of this integrator
+    dormand_prince(functor_t & acceleration_functor,                                    // reference to a functor that computes acceleration
+                   real_t t0,                                                           // integration start time
+                   typename field_container_t::iterator x_begin,                        // iterator pointing to the start of the x buffer
+                   typename field_container_t::iterator x_end,                          // iterator pointing to the end of the x buffer
+                   typename field_container_t::iterator v_begin,                        // iterator pointing to the start of the v buffer
+                   typename field_container_t::iterator a_begin,                        // iterator pointing to the start of the a buffer
+                   step_handler_t<field_container_t, field_value_t> & step_handler) :   // reference to an object that handles incrementing positions and velocities
+
+        // Call the superclass constructor
+        integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t> (
+            acceleration_functor, t0, x_begin, x_end, v_begin, a_begin, step_handler),
+            n_part(x_end - x_begin), t_previous(t0),
+            x_start(n_part), v_start(n_part) {
+
+        for (auto & k : k_x)
+            k.resize(n_part);
+        for (auto & k : k_v)
+            k.resize(n_part);
+        for (auto & r : dense_x)
+            r.resize(n_part);
+        for (auto & r : dense_v)
+            r.resize(n_part);
+    }
+
+    // Sets the absolute and relative tolerances of the local error of every field
+    void set_tolerances(real_t new_absolute_tolerance,      // absolute tolerance
+                        real_t new_relative_tolerance) {    // relative tolerance
+        this->absolute_tolerance = new_absolute_tolerance;
+        this->relative_tolerance = new_relative_tolerance;
+    }
+
+    // Sets the size of the next step attempt, otherwise it is estimated from the initial condition
+    void set_initial_step(real_t new_step_size /* step size */) {
+        this->step_size = new_step_size;
+    }
+
+    // Discards the accelerations kept from the last stage of the previous step
+    // Must be called if the fields are modified between time steps
+    void restart() {
+        this->accelerations_initialized = false;
+    }
+
+    // Advances the solution by exactly dt, with as many adaptive steps as the tolerances require
+    void do_step(real_t dt /*time step*/) {
+        const real_t t_end = this->t + dt;
+
+        while (this->t < t_end) {
+            // The last step is shortened to end exactly at t_end
+            const bool last = initial_step_size() >= t_end - this->t;
+            advance(last ? t_end - this->t : this->step_size, last ? t_end : real_t(0), last);
+        }
+    }
+
+    // Makes one accepted step of the size chosen by the error control and returns its size
+    // Combined with interpolate(), this can be used to produce output at arbitrary times
+    real_t do_adaptive_step() {
+        initial_step_size();
+
+        const real_t t_begin = this->t;
+        advance(this->step_size, real_t(0), false);
+        return this->t - t_begin;
+    }
+
+    // Computes the positions and velocities at time t_out from the dense output of the last accepted step
+    //
+    // Notes:
+    // t_out must be inside of the last accepted step, i.e. between get_previous_t() and get_t()
+    void interpolate(real_t t_out,                              // time of the output
+                     field_container_t & x_out,                 // container that receives the positions
+                     field_container_t & v_out) const {         // container that receives the velocities
+        const real_t theta = (t_out - t_previous) / (this->t - t_previous);
+        const real_t theta_1 = real_t(1) - theta;
+
+        for (long n = 0; n < n_part; n ++) {
+            x_out[n] = dense_x[0][n] + theta * (dense_x[1][n] + theta_1 * (dense_x[2][n] + theta * (dense_x[3][n] + theta_1 * dense_x[4][n])));
+            v_out[n] = dense_v[0][n] + theta * (dense_v[1][n] + theta_1 * (dense_v[2][n] + theta * (dense_v[3][n] + theta_1 * dense_v[4][n])));
+        }
+    }
+
+    // Getter for the current time
+    [[nodiscard]] real_t get_t() const {
+        return this->t;
+    }
+
+    // Getter for the start time of the last accepted step
+    [[nodiscard]] real_t get_previous_t() const {
+        return this->t_previous;
+    }
+
+    // Getter for the size of the next step attempt
+    [[nodiscard]] real_t get_step_size() const {
+        return this->step_size;
+    }
+
+    // Getter for the number of acceleration evaluations
+    [[nodiscard]] long get_n_evaluations() const {
+        return this->n_evaluations;
+    }
+
+    // Getter for the number of rejected steps
+    [[nodiscard]] long get_n_rejected_steps() const {
+        return this->n_rejected_steps;
+    }
+
+    // Visits the time, the step size, the stages, and the dense output of the last step with an archive
+    template <typename archive_t>
+    void serialize(archive_t & archive) {
+        integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t>::serialize(archive);
+        archive(step_size);
+        archive(t_previous);
+        archive(accelerations_initialized);
+        archive(n_evaluations);
+        archive(n_rejected_steps);
+        for (auto & buffer : k_x)
+            archive(buffer);
+        for (auto & buffer : k_v)
+            archive(buffer);
+        for (auto & buffer : dense_x)
+            archive(buffer);
+        for (auto & buffer : dense_v)
+            archive(buffer);
+    }
+
+private:
+    // Repeats the step attempts until one is accepted
+    // If last is true, the time after the accepted step is set to t_end exactly
+    void advance(real_t h,          // size of the first attempt
+                 real_t t_end,      // time at which the step must end if it is the last one
+                 bool last) {
+        const real_t controller_step_size = this->step_size;
+
+        while (!attempt_step(h)) {
+            // A rejected step is repeated with the reduced step size, so it can no longer be the last one
+            h = this->step_size;
+            last = false;
+        }
+
+        if (last) {
+            this->t = t_end;
+
+            // A step shortened to end at t_end does not tell how large the next step can be, so the step size of the
+            // controller is kept, unless the error of the shortened step calls for a smaller one
+            this->step_size = controller_step_size * std::min(this->step_size / h, real_t(1));
+        }
+    }
+
+    // Estimates the initial step size from the initial condition if it was not set
+    // Returns the size of the next step attempt
+    real_t initial_step_size() {
+        if (!accelerations_initialized) {
+            evaluate_acceleration(0);
+            accelerations_initialized = true;
+        }
+
+        if (this->step_size > real_t(0))
+            return this->step_size;
+
+        real_t d0 = 0, d1 = 0;
+        for (long n = 0; n < n_part; n ++) {
+            const field_value_t & x = *(this->x_begin_itr + n);
+            const field_value_t & v = *(this->v_begin_itr + n);
+            const real_t scale_x = absolute_tolerance + relative_tolerance * magnitude(x);
+            const real_t scale_v = absolute_tolerance + relative_tolerance * magnitude(v);
+
+            d0 += std::pow(magnitude(x) / scale_x, 2) + std::pow(magnitude(v) / scale_v, 2);
+            d1 += std::pow(magnitude(k_x[0][n]) / scale_x, 2) + std::pow(magnitude(k_v[0][n]) / scale_v, 2);
+        }
+
+        this->step_size = d0 < real_t(1e-10) || d1 < real_t(1e-10) ? real_t(1e-6) : real_t(0.01) * std::sqrt(d0 / d1);
+        return this->step_size;
+    }
+
+    // Attempts one step of size h, returns true if the step is accepted
+    // Sets the size of the next attempt in either case
+    bool attempt_step(real_t h /* step size */) {
+        const real_t t_start = this->t;
+
+        std::copy(this->x_begin_itr, this->x_end_itr, x_start.begin());
+        std::copy(this->v_begin_itr, this->v_begin_itr + n_part, v_start.begin());
+
+        // Stages 2 to 7, the last one is at the fifth order solution
+        for (long s = 1; s < n_stages; s ++) {
+            for (long n = 0; n < n_part; n ++) {
+                field_value_t dx = a[s][0] * k_x[0][n];
+                field_value_t dv = a[s][0] * k_v[0][n];
+                for (long j = 1; j < s; j ++) {
+                    dx += a[s][j] * k_x[j][n];
+                    dv += a[s][j] * k_v[j][n];
+                }
+
+                *(this->x_begin_itr + n) = x_start[n] + h * dx;
+                *(this->v_begin_itr + n) = v_start[n] + h * dv;
+            }
+
+            this->t = t_start + c[s] * h;
+            evaluate_acceleration(s);
+        }
+
+        // The local error is the difference between the fifth and the fourth order solutions
+        real_t error = 0;
+        for (long n = 0; n < n_part; n ++) {
+            field_value_t error_x = e[0] * k_x[0][n];
+            field_value_t error_v = e[0] * k_v[0][n];
+            for (long j = 1; j < n_stages; j ++) {
+                error_x += e[j] * k_x[j][n];
+                error_v += e[j] * k_v[j][n];
+            }
+
+            const real_t scale_x = absolute_tolerance + relative_tolerance *
+                    std::max(magnitude(x_start[n]), magnitude(*(this->x_begin_itr + n)));
+            const real_t scale_v = absolute_tolerance + relative_tolerance *
+                    std::max(magnitude(v_start[n]), magnitude(*(this->v_begin_itr + n)));
+
+            error += std::pow(h * magnitude(error_x) / scale_x, 2) + std::pow(h * magnitude(error_v) / scale_v, 2);
+        }
+        error = std::sqrt(error / real_t(2 * std::max(n_part, 1l)));
+
+        // Standard step size controller with a safety factor
+        const real_t factor = error > real_t(0) ? real_t(0.9) * std::pow(error, real_t(-0.2)) : max_factor;
+
+        if (!(error <= real_t(1))) {
+            // The fields and the accelerations of the first stage are restored
+            std::copy(x_start.begin(), x_start.end(), this->x_begin_itr);
+            std::copy(v_start.begin(), v_start.end(), this->v_begin_itr);
+            std::copy(k_v[0].begin(), k_v[0].end(), this->a_begin_itr);
+
+            this->t = t_start;
+            this->step_size = h * std::clamp(factor, min_factor, real_t(1));
+            n_rejected_steps ++;
+            return false;
+        }
+
+        // Coefficients of the dense output
+        for (long n = 0; n < n_part; n ++) {
+            fill_dense_output(dense_x, n, x_start[n], *(this->x_begin_itr + n), k_x, h);
+            fill_dense_output(dense_v, n, v_start[n], *(this->v_begin_itr + n), k_v, h);
+        }
+
+        // The accepted increments are applied through the step handler
+        for (long n = 0; n < n_part; n ++) {
+            const field_value_t dx = *(this->x_begin_itr + n) - x_start[n];
+            const field_value_t dv = *(this->v_begin_itr + n) - v_start[n];
+
+            *(this->x_begin_itr + n) = x_start[n];
+            *(this->v_begin_itr + n) = v_start[n];
+
+            this->step_handler.increment_x(n, dx, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+            this->step_handler.increment_v(n, dv, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+        }
+
+        // The last stage becomes the first stage of the next step
+        std::swap(k_x[0], k_x[n_stages - 1]);
+        std::swap(k_v[0], k_v[n_stages - 1]);
+
+        t_previous = t_start;
+        this->t = t_start + h;
+        this->step_size = h * std::clamp(factor, min_factor, max_factor);
+        return true;
+    }
+
+    // Computes the accelerations at the current fields and stores the derivatives of stage s
+    void evaluate_acceleration(long s /* index of the stage */) {
+        this->update_acceleration();
+        n_evaluations ++;
+
+        std::copy(this->v_begin_itr, this->v_begin_itr + n_part, k_x[s].begin());
+        std::copy(this->a_begin_itr, this->a_begin_itr + n_part, k_v[s].begin());
+    }
+
+    // Computes the coefficients of the dense output of one field
+    void fill_dense_output(std::array<field_container_t, 5> & dense,            // dense output coefficients of the component
+                           long n,                                              // index of the field
+                           field_value_t const & y_0,                           // value at the start of the step
+                           field_value_t const & y_1,                           // value at the end of the step
+                           std::array<field_container_t, 7> const & k,          // stage derivatives of the component
+                           real_t h) {                                          // step size
+        const field_value_t difference = y_1 - y_0;
+        const field_value_t b_spline = h * k[0][n] - difference;
+
+        dense[0][n] = y_0;
+        dense[1][n] = difference;
+        dense[2][n] = b_spline;
+        dense[3][n] = difference - h * k[6][n] - b_spline;
+        dense[4][n] = h * (d[0] * k[0][n] + d[2] * k[2][n] + d[3] * k[3][n] + d[4] * k[4][n] + d[5] * k[5][n] + d[6] * k[6][n]);
+    }
+
+    // Magnitude of a field value, used to scale the local error
+    static real_t magnitude(field_value_t const & value) {
+        if constexpr (std::is_arithmetic_v<field_value_t>)
+            return std::abs(value);
+        else
+            return value.norm();
+    }
+
+    static constexpr long n_stages = 7;
+
+    // Butcher tableau, the last row is also the weights of the fifth order solution
+    static constexpr real_t c[n_stages] = {0, real_t(1) / 5, real_t(3) / 10, real_t(4) / 5, real_t(8) / 9, 1, 1};
+    static constexpr real_t a[n_stages][n_stages] = {
+            {},
+            {real_t(1) / 5},
+            {real_t(3) / 40, real_t(9) / 40},
+            {real_t(44) / 45, real_t(-56) / 15, real_t(32) / 9},
+            {real_t(19372) / 6561, real_t(-25360) / 2187, real_t(64448) / 6561, real_t(-212) / 729},
+            {real_t(9017) / 3168, real_t(-355) / 33, real_t(46732) / 5247, real_t(49) / 176, real_t(-5103) / 18656},
+            {real_t(35) / 384, 0, real_t(500) / 1113, real_t(125) / 192, real_t(-2187) / 6784, real_t(11) / 84}
+    };
+
+    // Difference between the weights of the fifth and the fourth order solutions
+    static constexpr real_t e[n_stages] = {real_t(71) / 57600, 0, real_t(-71) / 16695, real_t(71) / 1920,
+                                           real_t(-17253) / 339200, real_t(22) / 525, real_t(-1) / 40};
+
+    // Weights of the dense output
+    static constexpr real_t d[n_stages] = {real_t(-12715105075.0) / real_t(11282082432.0), 0, real_t(87487479700.0) / real_t(32700410799.0),
+                                           real_t(-10690763975.0) / real_t(1880347072.0), real_t(701980252875.0) / real_t(199316789632.0),
+                                           real_t(-1453857185.0) / real_t(822651844.0), real_t(69997945.0) / real_t(29380423.0)};
+
+    static constexpr real_t min_factor = real_t(0.2), max_factor = real_t(5);
+
+    const long n_part;
+    real_t absolute_tolerance = real_t(1e-6), relative_tolerance = real_t(1e-6);
+    real_t step_size = 0;
+    real_t t_previous;
+    bool accelerations_initialized = false;
+    long n_evaluations = 0, n_rejected_steps = 0;
+
+    field_container_t x_start, v_start;
+    std::array<field_container_t, n_stages> k_x, k_v;
+    std::array<field_container_t, 5> dense_x, dense_v;
+};
+
+#endif //INTEGRATORS_DORMAND_PRINCE_H
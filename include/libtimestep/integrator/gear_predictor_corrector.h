@@ -0,0 +1,131 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_GEAR_PREDICTOR_CORRECTOR_H
+#define INTEGRATORS_GEAR_PREDICTOR_CORRECTOR_H
+
+#include <vector>
+
+// Integrator template that implements the fifth order (5-value) Gear predictor-corrector scheme for second order systems
+// Positions, velocities, and the first three derivatives of velocity are predicted with a Taylor expansion,
+// the accelerations are computed once per step at the predicted positions AND velocities,
+// and all the derivatives are corrected in proportion to the difference between the computed and predicted accelerations
+// Since velocity dependent (e.g. dashpot) forces are evaluated at velocities consistent with the positions,
+// the energy dissipated in damped contacts is reproduced accurately with larger time steps than with velocity_verlet_half
+//
+// Notes:
+// The corrector coefficients for velocity dependent forces are used (M.P. Allen, D.J. Tildesley, Computer Simulation of Liquids)
+// The scheme is not time reversible and needs the derivatives from previous steps, restart() should be called
+// after the fields are changed outside of the integrator
+// The a buffer holds the accelerations at the predicted state of the last step
+// The stability region of the scheme is smaller than that of velocity_verlet_half, contacts with damping close to critical
+// need about 50 steps per contact, linearly_implicit_euler should be used if the damping is not resolved by the time step
+template <
+    typename field_container_t,
+    typename field_value_t,
+    typename real_t,
+    typename functor_t,
+    template <
+        typename _field_container_t,
+        typename _field_value_t>
+    typename step_handler_t>
+class gear_predictor_corrector : public integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t> {
+public:
+
+    // Class constructor
+    //
+    // Notes:
+    // Iterators passed to this constructor must remain valid for the duration of use of this integrator
+    // x, v, and a buffers must be of the same size
+    // The acceleration functor and the step handler must exist for the duration of use of this integrator
+    gear_predictor_corrector(functor_t & acceleration_functor,                                  // reference to a functor that computes acceleration
+                             real_t t0,                                                         // integration start time
+                             typename field_container_t::iterator x_begin,                      // iterator pointing to the start of the x buffer
+                             typename field_container_t::iterator x_end,                        // iterator pointing to the end of the x buffer
+                             typename field_container_t::iterator v_begin,                      // iterator pointing to the start of the v buffer
+                             typename field_container_t::iterator a_begin,                      // iterator pointing to the start of the a buffer
+                             step_handler_t<field_container_t, field_value_t> & step_handler) : // reference to an object that handles incrementing positions and velocities
+
+        // Call the superclass constructor
+        integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t> (
+            acceleration_functor, t0, x_begin, x_end, v_begin, a_begin, step_handler),
+            a_predicted(x_end - x_begin), jerk(x_end - x_begin), snap(x_end - x_begin) {}
+
+    // Discards the higher derivatives, so that the next step starts from the accelerations at the current state
+    void restart() {
+        derivatives_initialized = false;
+    }
+
+    // Perform one time step
+    void do_step(real_t dt /*time step*/) {
+        const long n_part = this->x_end_itr - this->x_begin_itr;
+
+        // If this is the first step, the higher derivatives are unknown and start from zero
+        if (!derivatives_initialized) [[unlikely]] {
+            derivatives_initialized = true;
+
+            this->update_acceleration();
+
+            for (long n = 0; n < n_part; n ++) {
+                field_value_t const & a = *(this->a_begin_itr + n);
+
+                a_predicted[n] = a;
+                jerk[n] = a * real_t(0);
+                snap[n] = a * real_t(0);
+            }
+        }
+
+        // Predict the positions, the velocities, and the derivatives of the velocities
+        for (long n = 0; n < n_part; n ++) {
+            field_value_t const & v = *(this->v_begin_itr + n);
+
+            this->step_handler.increment_x(n, v * dt + a_predicted[n] * (dt * dt / 2.0) + jerk[n] * (dt * dt * dt / 6.0)
+                + snap[n] * (dt * dt * dt * dt / 24.0), this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+            this->step_handler.increment_v(n, a_predicted[n] * dt + jerk[n] * (dt * dt / 2.0) + snap[n] * (dt * dt * dt / 6.0),
+                this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+
+            a_predicted[n] += jerk[n] * dt + snap[n] * (dt * dt / 2.0);
+            jerk[n] += snap[n] * dt;
+        }
+
+        // Increment time
+        this->t += dt;
+
+        this->update_acceleration();
+
+        // Correct the predicted values
+        for (long n = 0; n < n_part; n ++) {
+            field_value_t const & a = *(this->a_begin_itr + n);
+            field_value_t correction = a - a_predicted[n];
+
+            this->step_handler.increment_x(n, correction * (corrector[0] * dt * dt / 2.0), this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+            this->step_handler.increment_v(n, correction * (corrector[1] * dt / 2.0), this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+
+            a_predicted[n] = a;
+            jerk[n] += correction * (3.0 * corrector[3] / dt);
+            snap[n] += correction * (12.0 * corrector[4] / (dt * dt));
+        }
+    }
+
+    // Visits the time and the predicted derivatives with an archive, to save or restore a checkpoint
+    template <typename archive_t>
+    void serialize(archive_t & archive) {
+        integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t>::serialize(archive);
+        archive(derivatives_initialized);
+        archive(a_predicted);
+        archive(jerk);
+        archive(snap);
+    }
+
+private:
+    // Corrector coefficients of the scaled derivatives x, v dt, a dt^2/2, j dt^3/6, s dt^4/24
+    static constexpr real_t corrector[5] = {real_t(19.0 / 90.0), real_t(3.0 / 4.0), real_t(1.0), real_t(1.0 / 2.0), real_t(1.0 / 12.0)};
+
+    bool derivatives_initialized = false;
+
+    // Predicted accelerations and the higher derivatives of velocity
+    std::vector<field_value_t> a_predicted, jerk, snap;
+};
+
+#endif //INTEGRATORS_GEAR_PREDICTOR_CORRECTOR_H
@@ -45,6 +45,13 @@ public:
                 "field_container_t must be a container of values of type field_value_t");
     }
 
+    // Visits the time with an archive, to save or restore a checkpoint (see io/checkpoint.h)
+    // Integrators with more state than the time extend this method
+    template <typename archive_t>
+    void serialize(archive_t & archive) {
+        archive(this->t);
+    }
+
 protected:
     // This method should be called by any derived class when accelerations need to be recalculated
     void update_acceleration() const {
@@ -57,6 +64,13 @@ protected:
         this->acceleration_functor(x_begin_const_itr, x_end_const_itr, v_begin_const_itr, this->a_begin_itr, this->t);
     }
 
+    // This method should be called by partitioned integrators from inside of a parallel region
+    // when accelerations of the fields in range [i_begin, i_end) need to be recalculated
+    void update_acceleration(long i_begin,      // index of the first field in the range
+                             long i_end) const {    // index past the last field in the range
+        this->acceleration_functor(i_begin, i_end, this->t);
+    }
+
     real_t t;
     typename field_container_t::iterator x_begin_itr, x_end_itr, v_begin_itr, a_begin_itr;
     functor_t & acceleration_functor;
@@ -64,6 +78,13 @@ protected:
 };
 
 #include "forward_euler.h"
+#include "linearly_implicit_euler.h"
+#include "gear_predictor_corrector.h"
 #include "velocity_verlet_half.h"
+#include "velocity_verlet_half_omp.h"
+#include "respa_velocity_verlet.h"
+#include "block_velocity_verlet.h"
+#include "dormand_prince.h"
+#include "symplectic_composition.h"
 
 #endif //INTEGRATORS_INTEGRATOR_H
@@ -0,0 +1,126 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_LINEARLY_IMPLICIT_EULER_H
+#define INTEGRATORS_LINEARLY_IMPLICIT_EULER_H
+
+#include <vector>
+#include <type_traits>
+#include <utility>
+
+#include "../parallel/partition.h"
+
+// Integrator template that implements the linearly implicit (semi-implicit) Euler scheme
+// The implicit Euler step v' = v + a(x + v' dt, v') dt is linearized around the current state with the local Jacobian
+// of each field, K = da_i/dx_i and C = da_i/dv_i, and the velocity increment is obtained from
+// (I - C dt - K dt^2) dv = (a + K v dt) dt, followed by x' = x + v' dt
+// The scheme is unconditionally stable for linear spring-dashpot forces, so stiff and strongly damped systems
+// can be integrated with steps much larger than the stability limit of forward_euler
+//
+// Notes:
+// The acceleration functor must implement compute_jacobian(long i, real_t t), which returns a pair of local Jacobians
+// {da_i/dx_i, da_i/dv_i} at the current state (the systems implement it if their acceleration handler does)
+// For vector fields, the Jacobians are matrices that must implement Identity() and inverse(), e.g. Eigen fixed size matrices
+// Coupling between the fields through off-diagonal Jacobian blocks is treated explicitly
+// If the acceleration functor implements use_parallel_execution() (the OpenMP systems do), the fields are split between
+// OpenMP threads as in the force loop, compute_jacobian() and the step handler must then be safe to call concurrently
+// for different indices
+template <
+    typename field_container_t,
+    typename field_value_t,
+    typename real_t,
+    typename functor_t,
+    template <
+        typename _field_container_t,
+        typename _field_value_t>
+    typename step_handler_t>
+class linearly_implicit_euler : public integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t> {
+public:
+
+    // Class constructor
+    //
+    // Notes:
+    // Iterators passed to this constructor must remain valid for the duration of use of this integrator
+    // x, v, and a buffers must be of the same size
+    // The acceleration functor and the step handler must exist for the duration of use of this integrator
+    linearly_implicit_euler(functor_t & acceleration_functor,                                   // reference to a functor that computes acceleration
+                            real_t t0,                                                          // integration start time
+                            typename field_container_t::iterator x_begin,                       // iterator pointing to the start of the x buffer
+                            typename field_container_t::iterator x_end,                         // iterator pointing to the end of the x buffer
+                            typename field_container_t::iterator v_begin,                       // iterator pointing to the start of the v buffer
+                            typename field_container_t::iterator a_begin,                       // iterator pointing to the start of the a buffer
+                            step_handler_t<field_container_t, field_value_t> & step_handler) :  // reference to an object that handles incrementing positions and velocities
+
+        // Call the superclass constructor
+        integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t> (
+            acceleration_functor, t0, x_begin, x_end, v_begin, a_begin, step_handler),
+            dv(x_end - x_begin) {}
+
+    // Perform one time step
+    void do_step(real_t dt /*time step*/) {
+        // Re-compute the acceleration
+        this->update_acceleration();
+
+        const long n_part = this->x_end_itr - this->x_begin_itr;
+        const real_t t = this->t;
+
+        bool parallel = false;
+        if constexpr (requires (functor_t & functor) { functor.use_parallel_execution(); })
+            parallel = this->acceleration_functor.use_parallel_execution();
+
+        #pragma omp parallel default(none) shared(dt, n_part, t) if(parallel)
+        {
+            auto [i_begin, i_end] = thread_partition(n_part);
+
+            // The velocity increments of all fields are found before any field is moved,
+            // so that the Jacobians are evaluated at the same state as the accelerations
+            for (long n = i_begin; n < i_end; n ++) {
+                field_value_t const & v = *(this->v_begin_itr + n);
+                field_value_t const & a = *(this->a_begin_itr + n);
+
+                auto [da_dx, da_dv] = this->acceleration_functor.compute_jacobian(n, t);
+                decltype(da_dx) matrix = identity<decltype(da_dx)>() - da_dv * dt - da_dx * (dt * dt);
+
+                dv[n] = solve(matrix, (a + da_dx * v * dt) * dt);
+            }
+
+            // Jacobians of other fields may still be evaluated at the current positions
+            #pragma omp barrier
+
+            // Integrate velocity and position
+            for (long n = i_begin; n < i_end; n ++) {
+                this->step_handler.increment_v(n, dv[n], this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+
+                field_value_t const & v = *(this->v_begin_itr + n);
+                this->step_handler.increment_x(n, v*dt, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+            }
+        }
+
+        // Increment time
+        this->t += dt;
+    }
+
+private:
+    // Identity element of the Jacobian type
+    template <typename jacobian_t>
+    static jacobian_t identity() {
+        if constexpr (std::is_arithmetic_v<jacobian_t>)
+            return jacobian_t(1);
+        else
+            return jacobian_t::Identity();
+    }
+
+    // Solves the local linear system for the velocity increment
+    template <typename jacobian_t>
+    static field_value_t solve(jacobian_t const & matrix, field_value_t const & rhs) {
+        if constexpr (std::is_arithmetic_v<jacobian_t>)
+            return rhs / matrix;
+        else
+            return matrix.inverse() * rhs;
+    }
+
+    std::vector<field_value_t> dv;
+};
+
+#endif //INTEGRATORS_LINEARLY_IMPLICIT_EULER_H
@@ -0,0 +1,41 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_RESPA_FUNCTOR_PAIR_H
+#define INTEGRATORS_RESPA_FUNCTOR_PAIR_H
+
+#include <utility>
+
+// Adapter that combines two separate functors into one acceleration functor for the RESPA integrators
+// The slow functor is called through operator(), the fast functor through compute_fast_accelerations()
+// Both functors must take the same arguments as an acceleration functor of a regular integrator
+template <typename slow_functor_t, typename fast_functor_t>
+class respa_functor_pair {
+public:
+    // Class constructor
+    //
+    // Notes:
+    // The functors must exist for the duration of use of this adapter
+    respa_functor_pair(slow_functor_t & slow_functor,   // reference to the functor that computes slowly varying accelerations
+                       fast_functor_t & fast_functor) : // reference to the functor that computes rapidly varying accelerations
+            slow_functor(slow_functor), fast_functor(fast_functor) {}
+
+    // Computes the slowly varying accelerations
+    template <typename... args_t>
+    void operator() (args_t &&... args) {
+        slow_functor(std::forward<args_t>(args)...);
+    }
+
+    // Computes the rapidly varying accelerations
+    template <typename... args_t>
+    void compute_fast_accelerations(args_t &&... args) {
+        fast_functor(std::forward<args_t>(args)...);
+    }
+
+private:
+    slow_functor_t & slow_functor;
+    fast_functor_t & fast_functor;
+};
+
+#endif //INTEGRATORS_RESPA_FUNCTOR_PAIR_H
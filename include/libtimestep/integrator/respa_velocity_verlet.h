@@ -0,0 +1,138 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_RESPA_VELOCITY_VERLET_H
+#define INTEGRATORS_RESPA_VELOCITY_VERLET_H
+
+#include "respa_functor_pair.h"
+#include "../exception/exception.h"
+
+// Integrator template that implements the multiple time step (r-RESPA) Velocity Verlet scheme from doi:10.1063/1.463137
+// The accelerations are split into slowly and rapidly varying parts, each slow step of size dt is made of
+// n_substeps Velocity Verlet substeps with the fast accelerations, surrounded by two half kicks with the slow accelerations
+// With one substep, this is the Velocity Verlet scheme with synchronized positions and velocities
+//
+// Notes:
+// The acceleration functor must compute the slow accelerations in operator() and must implement
+// compute_fast_accelerations() with the same arguments, which writes the fast accelerations to the buffer it is given
+// (respa_functor_pair combines two separate functors into one)
+// The a buffer holds the slow accelerations, the fast accelerations are kept in a buffer of the integrator
+template <
+    typename field_container_t,
+    typename field_value_t,
+    typename real_t,
+    typename functor_t,
+    template <
+        typename _field_container_t,
+        typename _field_value_t>
+    typename step_handler_t>
+class respa_velocity_verlet : public integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t> {
+public:
+
+    // Class constructor
+    //
+    // Notes:
+    // Iterators passed to this constructor must remain valid for the duration of use of this integrator
+    // x, v, and a buffers must be of the same size
+    // The acceleration functor and the step handler must exist for the duration of use of this integrator
+    respa_velocity_verlet(functor_t & acceleration_functor,                                     // reference to a functor that computes slow and fast accelerations
+                          real_t t0,                                                            // integration start time
+                          typename field_container_t::iterator x_begin,                         // iterator pointing to the start of the x buffer
+                          typename field_container_t::iterator x_end,                           // iterator pointing to the end of the x buffer
+                          typename field_container_t::iterator v_begin,                         // iterator pointing to the start of the v buffer
+                          typename field_container_t::iterator a_begin,                         // iterator pointing to the start of the a buffer
+                          step_handler_t<field_container_t, field_value_t> & step_handler) :    // reference to an object that handles incrementing positions and velocities
+
+        // Call the superclass constructor
+        integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t> (
+            acceleration_functor, t0, x_begin, x_end, v_begin, a_begin, step_handler),
+            a_fast(x_end - x_begin) {}
+
+    // Sets the number of fast substeps in every slow step
+    // Throws InvalidArgumentException if the number of substeps is smaller than one
+    void set_substeps(long new_n_substeps /* number of substeps */) {
+        if (new_n_substeps < 1)
+            throw InvalidArgumentException("respa_velocity_verlet::set_substeps()");
+
+        this->n_substeps = new_n_substeps;
+    }
+
+    // Getter for the number of fast substeps in every slow step
+    [[nodiscard]] long get_substeps() const {
+        return this->n_substeps;
+    }
+
+    // Perform one time step
+    void do_step(real_t dt /*time step*/) {
+        const long n_part = this->x_end_itr - this->x_begin_itr;
+        const real_t t_start = this->t;
+        const real_t h = dt / real_t(n_substeps);
+
+        // If this is the first step, compute both parts of the accelerations from the initial condition
+        if (!accelerations_initialized) [[unlikely]] {
+            accelerations_initialized = true;
+
+            this->update_acceleration();
+            update_fast_acceleration();
+        }
+
+        // Half kick with the slow accelerations
+        for (long n = 0; n < n_part; n ++) {
+            field_value_t const & a = *(this->a_begin_itr + n);
+
+            this->step_handler.increment_v(n, a * dt / 2.0, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+        }
+
+        // Velocity Verlet substeps with the fast accelerations
+        for (long s = 0; s < n_substeps; s ++) {
+            for (long n = 0; n < n_part; n ++) {
+                field_value_t const & v = *(this->v_begin_itr + n);
+
+                this->step_handler.increment_v(n, a_fast[n] * h / 2.0, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+                this->step_handler.increment_x(n, v * h, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+            }
+
+            this->t = t_start + real_t(s + 1) * h;
+            update_fast_acceleration();
+
+            for (long n = 0; n < n_part; n ++)
+                this->step_handler.increment_v(n, a_fast[n] * h / 2.0, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+        }
+
+        // Half kick with the slow accelerations at the new positions
+        this->t = t_start + dt;
+        this->update_acceleration();
+
+        for (long n = 0; n < n_part; n ++) {
+            field_value_t const & a = *(this->a_begin_itr + n);
+
+            this->step_handler.increment_v(n, a * dt / 2.0, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+        }
+    }
+
+    // Visits the time and the fast accelerations with an archive, to save or restore a checkpoint
+    template <typename archive_t>
+    void serialize(archive_t & archive) {
+        integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t>::serialize(archive);
+        archive(accelerations_initialized);
+        archive(a_fast);
+    }
+
+private:
+    // Recomputes the fast accelerations
+    void update_fast_acceleration() {
+        typename field_container_t::const_iterator x_begin_const_itr = this->x_begin_itr;
+        typename field_container_t::const_iterator x_end_const_itr = this->x_end_itr;
+        typename field_container_t::const_iterator v_begin_const_itr = this->v_begin_itr;
+
+        this->acceleration_functor.compute_fast_accelerations(x_begin_const_itr, x_end_const_itr, v_begin_const_itr,
+                                                              a_fast.begin(), this->t);
+    }
+
+    long n_substeps = 1;
+    bool accelerations_initialized = false;
+    field_container_t a_fast;
+};
+
+#endif //INTEGRATORS_RESPA_VELOCITY_VERLET_H
@@ -0,0 +1,54 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_SYMPLECTIC_COEFFICIENTS_H
+#define INTEGRATORS_SYMPLECTIC_COEFFICIENTS_H
+
+#include <array>
+
+// Coefficient tables of the splitting schemes used by symplectic_composition and rotational_symplectic_composition
+// A step of size h is made of drifts x += drift[i] * h * v, each followed by a kick v += kick[i] * h * a(x)
+// (except for the last drift), so a table with n kicks has n + 1 drifts
+// Drifts with zero coefficients are skipped, and a kick that directly follows another kick, or the end
+// of the previous step, reuses the accelerations that are already known
+
+// Fourth order scheme of Forest and Ruth, doi:10.1016/0167-2789(90)90019-L, 3 acceleration evaluations per step
+struct forest_ruth_coefficients {
+    static constexpr long double theta = 1.35120719195965763404768780897147L;  // 1 / (2 - 2^(1/3))
+
+    static constexpr std::array<long double, 4> drift = {theta / 2, (1 - theta) / 2, (1 - theta) / 2, theta / 2};
+    static constexpr std::array<long double, 3> kick = {theta, 1 - 2 * theta, theta};
+};
+
+// Fourth order composition of three velocity Verlet steps of Yoshida, doi:10.1016/0375-9601(90)90092-3,
+// 3 acceleration evaluations per step
+struct yoshida_4_coefficients {
+    static constexpr long double w_1 = 1.35120719195965763404768780897147L;    // 1 / (2 - 2^(1/3))
+    static constexpr long double w_0 = 1 - 2 * w_1;
+
+    static constexpr std::array<long double, 5> drift = {0, w_1, w_0, w_1, 0};
+    static constexpr std::array<long double, 4> kick = {w_1 / 2, (w_1 + w_0) / 2, (w_0 + w_1) / 2, w_1 / 2};
+};
+
+// Fourth order position extended Forest-Ruth like scheme of Omelyan, Mryglod, and Folk,
+// doi:10.1016/S0010-4655(02)00451-4, 4 acceleration evaluations per step, with an error about 100 times smaller than Forest-Ruth
+struct omelyan_pefrl_coefficients {
+    static constexpr long double xi = 0.1786178958448091L;
+    static constexpr long double lambda = -0.2123418310626054L;
+    static constexpr long double chi = -0.06626458266981849L;
+
+    static constexpr std::array<long double, 5> drift = {xi, chi, 1 - 2 * (chi + xi), chi, xi};
+    static constexpr std::array<long double, 4> kick = {(1 - 2 * lambda) / 2, lambda, lambda, (1 - 2 * lambda) / 2};
+};
+
+// Second order velocity form scheme of Omelyan, Mryglod, and Folk with minimal error norm,
+// doi:10.1016/S0010-4655(02)00451-4, 2 acceleration evaluations per step
+struct omelyan_2_coefficients {
+    static constexpr long double lambda = 0.1931833275037836L;
+
+    static constexpr std::array<long double, 4> drift = {0, 0.5L, 0.5L, 0};
+    static constexpr std::array<long double, 3> kick = {lambda, 1 - 2 * lambda, lambda};
+};
+
+#endif //INTEGRATORS_SYMPLECTIC_COEFFICIENTS_H
@@ -67,6 +67,13 @@ public:
         this->update_acceleration();
     }
 
+    // Visits the time and whether the velocities were already shifted by half a step with an archive
+    template <typename archive_t>
+    void serialize(archive_t & archive) {
+        integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t>::serialize(archive);
+        archive(velocities_initialized);
+    }
+
 private:
     bool velocities_initialized = false;
 };
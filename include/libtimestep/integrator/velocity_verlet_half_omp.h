@@ -0,0 +1,110 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_VELOCITY_VERLET_HALF_OMP_H
+#define INTEGRATORS_VELOCITY_VERLET_HALF_OMP_H
+
+#include "../parallel/partition.h"
+
+// Integrator template that implements the same Velocity Verlet scheme as velocity_verlet_half,
+// but performs the whole time step inside of a single OpenMP parallel region
+// Each thread keeps the same range of fields in every phase of the step (velocity and position update,
+// acceleration reset, force loop) and the phases are separated by barriers
+//
+// Notes:
+// The acceleration functor must implement operator() (long i_begin, long i_end, real_t t) that only computes
+// the accelerations of fields in range [i_begin, i_end) and is safe to call concurrently for disjoint ranges
+// (binary_system_omp and binary_system_neighbors_omp implement it)
+// The acceleration functor must also implement use_parallel_execution() that tells if the step is large enough to run in parallel
+// The step handler must be safe to call concurrently for different indices
+template <
+    typename field_container_t,
+    typename field_value_t,
+    typename real_t,
+    typename functor_t,
+    template <
+        typename _field_container_t,
+        typename _field_value_t>
+    typename step_handler_t>
+class velocity_verlet_half_omp : public integrator<field_container_t,field_value_t, real_t, functor_t, step_handler_t> {
+public:
+
+    // Class constructor
+    //
+    // Notes:
+    // Iterators passed to this constructor must remain valid for the duration of use of this integrator
+    // x, v, and a buffers must be of the same size
+    // The acceleration functor and the step handler must exist for the duration of use of this integrator
+    velocity_verlet_half_omp(functor_t & acceleration_functor,                                  // reference to a functor that computes acceleration
+                             real_t t0,                                                         // integration start time
+                             typename field_container_t::iterator x_begin,                      // iterator pointing to the start of the x buffer
+                             typename field_container_t::iterator x_end,                        // iterator pointing to the end of the x buffer
+                             typename field_container_t::iterator v_begin,                      // iterator pointing to the start of the v buffer
+                             typename field_container_t::iterator a_begin,                      // iterator pointing to the start of the a buffer
+                             step_handler_t<field_container_t, field_value_t> & step_handler) : // reference to an object that handles incrementing positions and velocities
+
+        // Call the superclass constructor
+        integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t> (
+            acceleration_functor, t0, x_begin, x_end, v_begin, a_begin, step_handler) {}
+
+    // Perform one time step
+    void do_step(real_t dt /*time step*/) {
+        const long n_part = this->x_end_itr - this->x_begin_itr;
+
+        #pragma omp parallel default(none) shared(dt, n_part) if(this->acceleration_functor.use_parallel_execution())
+        {
+            auto [i_begin, i_end] = thread_partition(n_part);
+
+            // If this is the first step, take half-a-timestep back in velocity
+            // Using Euler here
+            if (!velocities_initialized) [[unlikely]] {
+                this->update_acceleration(i_begin, i_end);
+
+                // Accelerations of all fields must be known before any velocity is modified
+                #pragma omp barrier
+
+                for (long n = i_begin; n < i_end; n ++) {
+                    field_value_t const & a = *(this->a_begin_itr + n);
+
+                    this->step_handler.increment_v(n, -a * dt / 2.0, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+                }
+
+                #pragma omp barrier
+
+                this->update_acceleration(i_begin, i_end);
+
+                // Other threads may still be reading positions and velocities of this range
+                #pragma omp barrier
+            }
+
+            // Integrate velocity and position
+            for (long n = i_begin; n < i_end; n ++) {
+                field_value_t const & v = *(this->v_begin_itr + n);
+                field_value_t const & a = *(this->a_begin_itr + n);
+
+                this->step_handler.increment_v(n, a*dt, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+                this->step_handler.increment_x(n, v*dt, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr);
+            }
+
+            // Positions and velocities of all fields must be updated before the accelerations are computed
+            #pragma omp barrier
+
+            this->update_acceleration(i_begin, i_end);
+        }
+
+        velocities_initialized = true;
+    }
+
+    // Visits the time and whether the velocities were already shifted by half a step with an archive
+    template <typename archive_t>
+    void serialize(archive_t & archive) {
+        integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t>::serialize(archive);
+        archive(velocities_initialized);
+    }
+
+private:
+    bool velocities_initialized = false;
+};
+
+#endif //INTEGRATORS_VELOCITY_VERLET_HALF_OMP_H
@@ -0,0 +1,189 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_ASYNC_OUTPUT_H
+#define INTEGRATORS_ASYNC_OUTPUT_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <algorithm>
+
+#include "../exception/exception.h"
+
+// Copy of the fields of a system at a dump, handed to the writer of an async_output
+// theta and omega are empty for systems without rotation
+template <typename field_value_t, typename real_t>
+struct output_snapshot {
+    long step;                              // index of the time step
+    real_t t;                               // time
+    std::vector<field_value_t> x, v;        // positions and velocities
+    std::vector<field_value_t> theta, omega;// angles and angular velocities
+};
+
+// Output stage that writes dumps on a background thread while the time stepping continues
+// At a dump, submit() copies the fields of the system into a staging buffer and returns, and the writer is called with
+// the buffer on the background thread. There are queue_depth staging buffers, which are reused, so there are at most
+// queue_depth dumps waiting to be written. If all of them are waiting, submit() blocks until the oldest one is written,
+// so that the simulation slows down to the speed of the output instead of running out of memory
+//
+// Notes:
+// The dumps are written in the order they are submitted
+// An exception thrown by the writer is rethrown by the next call to submit() or flush()
+// The destructor waits for all submitted dumps to be written
+template <typename field_value_t, typename real_t>
+class async_output {
+public:
+    typedef output_snapshot<field_value_t, real_t> snapshot_t;
+
+    async_output(async_output const &) = delete;
+    async_output & operator = (async_output const &) = delete;
+
+    // Class constructor
+    explicit async_output(std::function<void(snapshot_t const &)> writer,     // called with every dump on the background thread
+                          long queue_depth = 2) :                             // number of staging buffers
+            writer(std::move(writer)), buffers(std::max(queue_depth, 1l)) {
+        for (long n = 0; n < (long) buffers.size(); n ++)
+            free_buffers.emplace_back(n);
+
+        worker = std::thread([this] () { write_dumps(); });
+    }
+
+    ~async_output() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        dump_submitted.notify_one();
+        worker.join();
+    }
+
+    // Copies the fields of a system into a staging buffer to be written in the background
+    // Blocks while all staging buffers are waiting to be written
+    // Must be called between time steps
+    template <typename system_t>
+    void submit(system_t const & system,    // system whose fields are written
+                long step,                  // index of the time step
+                real_t t) {                 // time
+        long buffer;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (free_buffers.empty()) {
+                n_stalls ++;
+                buffer_freed.wait(lock, [this] () { return !free_buffers.empty() || error; });
+            }
+            rethrow_error();
+
+            buffer = free_buffers.front();
+            free_buffers.pop_front();
+        }
+
+        // The staging buffer is owned by this thread until it is queued, so it is filled without the lock
+        // (after the first dumps, the copies reuse the memory of the buffers)
+        // If the copy throws (e.g. std::bad_alloc), the buffer is returned, otherwise flush() would wait for it forever
+        try {
+            snapshot_t & snapshot = buffers[buffer];
+            snapshot.step = step;
+            snapshot.t = t;
+            snapshot.x.assign(system.get_x().begin(), system.get_x().end());
+            snapshot.v.assign(system.get_v().begin(), system.get_v().end());
+            if constexpr (requires { system.get_theta(); }) {
+                snapshot.theta.assign(system.get_theta().begin(), system.get_theta().end());
+                snapshot.omega.assign(system.get_omega().begin(), system.get_omega().end());
+            }
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                free_buffers.emplace_front(buffer);
+            }
+            buffer_freed.notify_all();
+            throw;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queued_buffers.emplace_back(buffer);
+        }
+        dump_submitted.notify_one();
+    }
+
+    // Waits until all submitted dumps are written
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        buffer_freed.wait(lock, [this] () { return (long) free_buffers.size() == (long) buffers.size() || error; });
+        rethrow_error();
+    }
+
+    // Getter for the number of dumps written so far
+    [[nodiscard]] long get_n_written() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return n_written;
+    }
+
+    // Getter for the number of times submit() had to wait for the output to catch up
+    [[nodiscard]] long get_n_stalls() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return n_stalls;
+    }
+
+private:
+    // Writes the queued dumps in order until the object is destroyed, runs on the background thread
+    void write_dumps() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            dump_submitted.wait(lock, [this] () { return !queued_buffers.empty() || stopping; });
+            if (queued_buffers.empty())
+                return;
+
+            const long buffer = queued_buffers.front();
+            queued_buffers.pop_front();
+
+            // The writer runs without the lock, so that submit() can fill other buffers in the meantime
+            lock.unlock();
+            std::exception_ptr writer_error;
+            try {
+                writer(buffers[buffer]);
+            } catch (...) {
+                writer_error = std::current_exception();
+            }
+            lock.lock();
+
+            if (writer_error && !error)
+                error = writer_error;
+            else if (!writer_error)
+                n_written ++;
+
+            free_buffers.emplace_back(buffer);
+            buffer_freed.notify_all();
+        }
+    }
+
+    // Rethrows an exception thrown by the writer, called with the lock held
+    void rethrow_error() {
+        if (error) {
+            auto pending_error = error;
+            error = nullptr;
+            std::rethrow_exception(pending_error);
+        }
+    }
+
+    std::function<void(snapshot_t const &)> writer;
+    std::vector<snapshot_t> buffers;
+
+    std::mutex mutex;
+    std::condition_variable dump_submitted, buffer_freed;
+    std::deque<long> free_buffers, queued_buffers;
+    std::exception_ptr error;
+    bool stopping = false;
+    long n_written = 0, n_stalls = 0;
+
+    // The thread is declared last, so it is started after the members it uses are initialized
+    std::thread worker;
+};
+
+#endif //INTEGRATORS_ASYNC_OUTPUT_H
@@ -0,0 +1,264 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_CHECKPOINT_H
+#define INTEGRATORS_CHECKPOINT_H
+
+#include <vector>
+#include <string>
+#include <array>
+#include <fstream>
+#include <filesystem>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <type_traits>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../exception/exception.h"
+
+// Layout of a checkpoint file:
+// - a checkpoint_header
+// - the payload of payload_size bytes, the state of the system in the order it is visited by system.serialize()
+// The state is stored as the bytes of the values in memory, so a restored system continues bit for bit as the saved one
+// would have, on any number of threads, as long as the computation of the system does not depend on the number of threads
+struct checkpoint_header {
+    char magic[8];                  // "LTSCKPT1"
+    std::uint32_t version;          // version of the layout of the payload
+    std::uint32_t value_size;       // size of a field value in bytes
+    std::uint64_t payload_size;     // size of the payload in bytes
+    std::uint32_t payload_crc;      // CRC-32 of the payload
+    std::uint32_t header_crc;       // CRC-32 of the header up to this member
+};
+
+constexpr char checkpoint_magic[8] = {'L', 'T', 'S', 'C', 'K', 'P', 'T', '1'};
+constexpr std::uint32_t checkpoint_version = 1;
+
+// Returns the CRC-32 (as in zlib and PNG) of n_bytes bytes, crc is the CRC-32 of the bytes before them, if any
+inline std::uint32_t crc32(void const * data, size_t n_bytes, std::uint32_t crc = 0) {
+    static constexpr auto table = [] () {
+        std::array<std::uint32_t, 256> values {};
+        for (std::uint32_t n = 0; n < 256; n ++) {
+            std::uint32_t value = n;
+            for (int k = 0; k < 8; k ++)
+                value = value & 1 ? 0xedb88320u ^ (value >> 1) : value >> 1;
+            values[n] = value;
+        }
+        return values;
+    }();
+
+    auto const * bytes = static_cast<unsigned char const *>(data);
+    crc = ~crc;
+    for (size_t n = 0; n < n_bytes; n ++)
+        crc = table[(crc ^ bytes[n]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+// True for the values that can be archived as their bytes in memory: trivially copyable values, and values that only
+// miss being trivially copyable because of a user-provided copy (e.g. std::pair of numbers or fixed-size Eigen matrices)
+// Values that own memory (e.g. std::string, std::map, std::unique_ptr, or dynamic Eigen matrices) would be stored as
+// pointers, so they cannot be archived
+template <typename value_t>
+constexpr bool is_checkpoint_value_v = std::is_trivially_copyable_v<value_t> || (std::is_trivially_destructible_v<value_t>
+        && (std::is_trivially_copy_constructible_v<value_t> || requires { requires value_t::SizeAtCompileTime > 0; }));
+
+// Archive that appends the state of a system to a buffer, passed to the serialize() methods of the systems and
+// integrators when a checkpoint is saved
+// Values are stored as their bytes in memory, vectors as their size followed by their elements
+class checkpoint_writer {
+public:
+    // Appends a value
+    template <typename value_t>
+    void operator () (value_t const & value) {
+        static_assert(is_checkpoint_value_v<value_t>, "values that own memory cannot be stored in a checkpoint");
+        append(&value, sizeof(value_t));
+    }
+
+    // Appends a vector
+    template <typename value_t>
+    void operator () (std::vector<value_t> const & values) {
+        const std::uint64_t size = values.size();
+        append(&size, sizeof(size));
+
+        if constexpr (requires { typename value_t::value_type; typename value_t::allocator_type; }) {
+            for (auto const & value : values)
+                (*this)(value);
+        } else {
+            static_assert(is_checkpoint_value_v<value_t>, "values that own memory cannot be stored in a checkpoint");
+            append(values.data(), values.size() * sizeof(value_t));
+        }
+    }
+
+    // Getter for the buffer with the state appended so far
+    [[nodiscard]] std::vector<char> const & get_buffer() const {
+        return buffer;
+    }
+
+private:
+    void append(void const * data, size_t n_bytes) {
+        const size_t size = buffer.size();
+        buffer.resize(size + n_bytes);
+        std::memcpy(buffer.data() + size, data, n_bytes);
+    }
+
+    std::vector<char> buffer;
+};
+
+// Archive that reads the state of a system back from a buffer, passed to the serialize() methods of the systems and
+// integrators when a checkpoint is restored
+class checkpoint_reader {
+public:
+    // Class constructor
+    checkpoint_reader(char const * data,    // pointer to the start of the buffer
+                      size_t size) :        // size of the buffer in bytes
+            data(data), size(size) {}
+
+    // Reads a value
+    template <typename value_t>
+    void operator () (value_t & value) {
+        static_assert(is_checkpoint_value_v<value_t>, "values that own memory cannot be restored from a checkpoint");
+        extract(&value, sizeof(value_t));
+    }
+
+    // Reads a vector, the vector is resized to the stored size
+    template <typename value_t>
+    void operator () (std::vector<value_t> & values) {
+        std::uint64_t new_size;
+        extract(&new_size, sizeof(new_size));
+        if (new_size > size - position)
+            throw InputException("checkpoint_reader (vector larger than the checkpoint)");
+        values.resize(new_size);
+
+        if constexpr (requires { typename value_t::value_type; typename value_t::allocator_type; }) {
+            for (auto & value : values)
+                (*this)(value);
+        } else {
+            static_assert(is_checkpoint_value_v<value_t>, "values that own memory cannot be restored from a checkpoint");
+            extract(values.data(), values.size() * sizeof(value_t));
+        }
+    }
+
+    // Returns true if the whole buffer has been read
+    [[nodiscard]] bool at_end() const {
+        return position == size;
+    }
+
+private:
+    void extract(void * value, size_t n_bytes) {
+        if (n_bytes > size - position)
+            throw InputException("checkpoint_reader (read past the end of the checkpoint)");
+        std::memcpy(value, data + position, n_bytes);
+        position += n_bytes;
+    }
+
+    char const * const data;
+    const size_t size;
+    size_t position = 0;
+};
+
+// Saves the full state of a system to a checkpoint file, e.g. every few minutes of a long run
+// The state is visited by system.serialize(archive), which the systems and the integrators implement, and which
+// systems derived by the user can override to add their own state (e.g. contact histories), calling the base first
+// The user state must be made of values and vectors accepted by is_checkpoint_value_v, other types do not compile
+//
+// Notes:
+// The file is written next to path and renamed to path when complete, so a failure while saving leaves the
+// previous checkpoint intact
+// The file is synced to disk before it is renamed, and the directory after it, so that a crash of the machine
+// leaves either the previous or the new checkpoint
+// Must be called between time steps
+template <typename system_t>
+void save_checkpoint(system_t & system,             // system whose state is saved
+                     std::string const & path) {    // path of the checkpoint file
+    checkpoint_writer archive;
+    system.serialize(archive);
+    auto const & payload = archive.get_buffer();
+
+    checkpoint_header header {};
+    std::memcpy(header.magic, checkpoint_magic, sizeof(header.magic));
+    header.version = checkpoint_version;
+    header.value_size = sizeof(typename system_t::field_container_t::value_type);
+    header.payload_size = payload.size();
+    header.payload_crc = crc32(payload.data(), payload.size());
+    header.header_crc = crc32(&header, offsetof(checkpoint_header, header_crc));
+
+    auto write_all = [] (int file, void const * data, size_t n_bytes) {
+        auto const * bytes = static_cast<char const *>(data);
+        while (n_bytes > 0) {
+            const ssize_t written = ::write(file, bytes, n_bytes);
+            if (written <= 0)
+                return false;
+
+            bytes += written;
+            n_bytes -= size_t(written);
+        }
+        return true;
+    };
+
+    const std::string temporary_path = path + ".tmp";
+    const int file = ::open(temporary_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (file < 0)
+        throw OutputException("save_checkpoint");
+
+    const bool written = write_all(file, &header, sizeof(header)) && write_all(file, payload.data(), payload.size())
+            && ::fsync(file) == 0;
+    if (::close(file) != 0 || !written)
+        throw OutputException("save_checkpoint");
+
+    std::error_code error;
+    std::filesystem::rename(temporary_path, path, error);
+    if (error)
+        throw OutputException("save_checkpoint (rename)");
+
+    // The rename is only durable once the directory is synced, file systems that cannot sync a directory report EINVAL
+    auto directory = std::filesystem::path(path).parent_path();
+    if (directory.empty())
+        directory = ".";
+
+    const int directory_file = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (directory_file < 0)
+        throw OutputException("save_checkpoint (directory sync)");
+
+    const bool synced = ::fsync(directory_file) == 0 || errno == EINVAL;
+    ::close(directory_file);
+    if (!synced)
+        throw OutputException("save_checkpoint (directory sync)");
+}
+
+// Restores the full state of a system from a checkpoint file saved by save_checkpoint()
+// The system must have been constructed the same way as the saved one (same number of fields, handlers, and
+// parameters), its state is then replaced by the saved state
+//
+// Notes:
+// Checkpoints that are truncated, corrupted, of another version, or of another field value type are rejected
+// with an InputException, and the system is left in an unspecified state if the payload does not match the system
+template <typename system_t>
+void restore_checkpoint(system_t & system,              // system whose state is restored
+                        std::string const & path) {     // path of the checkpoint file
+    std::ifstream ifs(path, std::ios::binary);
+
+    checkpoint_header header {};
+    if (!ifs.read(reinterpret_cast<char *>(&header), sizeof(header))
+            || std::memcmp(header.magic, checkpoint_magic, sizeof(header.magic)) != 0
+            || header.header_crc != crc32(&header, offsetof(checkpoint_header, header_crc)))
+        throw InputException("restore_checkpoint (not a checkpoint)");
+
+    if (header.version != checkpoint_version || header.value_size != sizeof(typename system_t::field_container_t::value_type))
+        throw InputException("restore_checkpoint (incompatible checkpoint)");
+
+    std::vector<char> payload(header.payload_size);
+    if (!ifs.read(payload.data(), long(payload.size())) || header.payload_crc != crc32(payload.data(), payload.size()))
+        throw InputException("restore_checkpoint (corrupted checkpoint)");
+
+    checkpoint_reader archive(payload.data(), payload.size());
+    system.serialize(archive);
+
+    if (!archive.at_end())
+        throw InputException("restore_checkpoint (checkpoint of another system)");
+}
+
+#endif //INTEGRATORS_CHECKPOINT_H
@@ -0,0 +1,321 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_COMPRESSED_TRAJECTORY_H
+#define INTEGRATORS_COMPRESSED_TRAJECTORY_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <exception>
+
+#include "../exception/exception.h"
+
+// Layout of a compressed trajectory file:
+// - a compressed_trajectory_header
+// - frames, each is a compressed_frame_header, the sizes of its n_blocks blocks in bytes (as std::uint64_t), and the
+//   blocks themselves
+// The positions are quantized to integer multiples of the precision. A block holds the quantized positions of
+// block_size consecutive particles, encoded as zigzag varints of their differences:
+// - in key frames, from the same component of the previous particle in the block (particles close in the buffer are
+//   usually close in space, e.g. after the buffer was sorted for locality), the first particle is stored as it is
+// - in the other frames, from the same component of the same particle in the previous frame
+// Blocks are encoded and decoded independently, so both are done in parallel
+struct compressed_trajectory_header {
+    char magic[8];                  // "LTSXTC01"
+    std::uint64_t n_particles;      // number of particles in every frame
+    std::uint64_t n_components;     // number of values of real_t in a field value
+    double precision;               // spacing of the quantized positions
+    std::uint64_t block_size;       // number of particles in a block
+};
+
+// Header of every compressed frame
+struct compressed_frame_header {
+    std::int64_t step;              // index of the time step
+    double t;                       // time
+    std::uint64_t key_frame;        // 1 if the frame does not depend on the previous one
+    std::uint64_t n_blocks;         // number of blocks in the frame
+};
+
+constexpr char compressed_trajectory_magic[8] = {'L', 'T', 'S', 'X', 'T', 'C', '0', '1'};
+
+// Appends a signed integer to a buffer as a zigzag varint, small magnitudes take few bytes
+inline void encode_varint(std::int64_t value, std::vector<unsigned char> & buffer) {
+    auto bits = (std::uint64_t(value) << 1) ^ std::uint64_t(value >> 63);
+    while (bits >= 0x80) {
+        buffer.push_back((unsigned char) (bits | 0x80));
+        bits >>= 7;
+    }
+    buffer.push_back((unsigned char) bits);
+}
+
+// Reads a zigzag varint from a buffer and advances the position past it
+inline std::int64_t decode_varint(unsigned char const * & position, unsigned char const * end) {
+    std::uint64_t bits = 0;
+    for (int shift = 0; position < end && shift < 64; shift += 7) {
+        const unsigned char byte = *position ++;
+        bits |= std::uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return std::int64_t(bits >> 1) ^ -std::int64_t(bits & 1);
+    }
+    throw InputException("decode_varint (truncated block)");
+}
+
+// Writer of compressed trajectories of the positions of a system, for analyses that only need the positions to a
+// known precision, e.g. a small fraction of the particle radius
+// The positions are quantized and stored as differences to the previous frame, which are small if the particles move
+// little between frames, and every key_frame_interval frames as differences between neighboring particles
+//
+// Notes:
+// field_value_t must be stored as values of real_t without padding (e.g. double or Eigen::Vector3d)
+// The error of a decoded position is at most precision / 2 in every component, and does not accumulate over frames
+template <typename field_value_t, typename real_t>
+class compressed_trajectory_writer {
+public:
+    static_assert(sizeof(field_value_t) % sizeof(real_t) == 0, "field_value_t must be an array of values of real_t");
+
+    static constexpr long n_components = sizeof(field_value_t) / sizeof(real_t);
+
+    // Class constructor
+    compressed_trajectory_writer(std::string const & path,      // path of the trajectory file, an existing file is replaced
+                                 long n_particles,              // number of particles in every frame
+                                 real_t precision,              // spacing of the quantized positions
+                                 long key_frame_interval = 100, // number of frames between key frames
+                                 long block_size = 4096) :      // number of particles encoded together
+            ofs(path, std::ios::binary | std::ios::trunc), n_particles(n_particles),
+            key_frame_interval(key_frame_interval), block_size(block_size), precision(precision),
+            quantized(n_particles * n_components, 0) {
+        if (!(precision > real_t(0)) || key_frame_interval < 1 || block_size < 1)
+            throw InvalidArgumentException("compressed_trajectory_writer constructor");
+
+        if (!ofs)
+            throw OutputException("compressed_trajectory_writer constructor");
+
+        compressed_trajectory_header header {};
+        std::memcpy(header.magic, compressed_trajectory_magic, sizeof(header.magic));
+        header.n_particles = n_particles;
+        header.n_components = n_components;
+        header.precision = double(precision);
+        header.block_size = block_size;
+        ofs.write(reinterpret_cast<char const *>(&header), sizeof(header));
+
+        blocks.resize((n_particles + block_size - 1) / block_size);
+        block_sizes.resize(blocks.size());
+    }
+
+    // Appends a frame with the positions of the system
+    template <typename system_t>
+    void write(system_t const & system,     // system whose positions are written
+               long step,                   // index of the time step
+               real_t t) {                  // time
+        write(system.get_x(), step, t);
+    }
+
+    // Appends a frame with the positions
+    void write(std::vector<field_value_t> const & x,    // positions of the particles
+               long step,                               // index of the time step
+               real_t t) {                              // time
+        if ((long) x.size() != n_particles)
+            throw SizeMismatchException("compressed_trajectory_writer::write");
+
+        const bool key_frame = n_frames % key_frame_interval == 0;
+        const real_t inverse_precision = real_t(1) / precision;
+        auto const * values = reinterpret_cast<real_t const *>(x.data());
+        const long n_blocks = (long) blocks.size();
+
+        #pragma omp parallel for schedule(dynamic)
+        for (long block = 0; block < n_blocks; block ++) {
+            auto & buffer = blocks[block];
+            buffer.clear();
+            buffer.reserve(block_size * n_components * 2);
+
+            const long i_begin = block * block_size;
+            const long i_end = std::min(i_begin + block_size, n_particles);
+            std::int64_t previous_particle[n_components] = {};
+            for (long i = i_begin; i < i_end; i ++) {
+                for (long c = 0; c < n_components; c ++) {
+                    const long k = i * n_components + c;
+                    const auto q = std::int64_t(std::lrint(values[k] * inverse_precision));
+                    encode_varint(q - (key_frame ? previous_particle[c] : quantized[k]), buffer);
+                    previous_particle[c] = q;
+                    quantized[k] = q;
+                }
+            }
+        }
+
+        compressed_frame_header frame_header {step, double(t), key_frame ? 1u : 0u, std::uint64_t(n_blocks)};
+        ofs.write(reinterpret_cast<char const *>(&frame_header), sizeof(frame_header));
+        for (long block = 0; block < n_blocks; block ++)
+            block_sizes[block] = blocks[block].size();
+        ofs.write(reinterpret_cast<char const *>(block_sizes.data()), long(block_sizes.size() * sizeof(std::uint64_t)));
+        for (auto const & buffer : blocks)
+            ofs.write(reinterpret_cast<char const *>(buffer.data()), long(buffer.size()));
+        ofs.flush();
+
+        if (!ofs)
+            throw OutputException("compressed_trajectory_writer::write");
+
+        n_frames ++;
+    }
+
+    // Getter for the number of frames written so far
+    [[nodiscard]] long get_n_frames() const {
+        return n_frames;
+    }
+
+private:
+    std::ofstream ofs;
+    const long n_particles, key_frame_interval, block_size;
+    const real_t precision;
+    long n_frames = 0;
+    std::vector<std::int64_t> quantized;
+    std::vector<std::vector<unsigned char>> blocks;
+    std::vector<std::uint64_t> block_sizes;
+};
+
+// Streaming reader of compressed trajectories, the frames are decoded one after another
+// A frame that is not completely written yet is not read, so a reader can follow a trajectory as it is written
+template <typename field_value_t, typename real_t>
+class compressed_trajectory_reader {
+public:
+    static_assert(sizeof(field_value_t) % sizeof(real_t) == 0, "field_value_t must be an array of values of real_t");
+
+    static constexpr long n_components = sizeof(field_value_t) / sizeof(real_t);
+
+    // Class constructor
+    explicit compressed_trajectory_reader(std::string const & path /* path of the trajectory file */) :
+            ifs(path, std::ios::binary) {
+        compressed_trajectory_header header {};
+        if (!ifs.read(reinterpret_cast<char *>(&header), sizeof(header))
+                || std::memcmp(header.magic, compressed_trajectory_magic, sizeof(header.magic)) != 0)
+            throw InputException("compressed_trajectory_reader constructor");
+
+        if (long(header.n_components) != n_components)
+            throw InputException("compressed_trajectory_reader constructor (different number of components)");
+
+        // A corrupted header would make read_frame() divide by zero or decode nonsense
+        if (header.block_size < 1 || !(header.precision > 0.0))
+            throw InputException("compressed_trajectory_reader constructor (corrupted header)");
+
+        n_particles = long(header.n_particles);
+        block_size = long(header.block_size);
+        precision = header.precision;
+        quantized.assign(n_particles * n_components, 0);
+    }
+
+    // Decodes the next frame into x and returns true, or returns false if there is no complete frame left
+    bool read_frame(std::vector<field_value_t> & x /* positions of the particles */) {
+        const auto frame_begin = ifs.tellg();
+
+        compressed_frame_header frame_header {};
+        if (!ifs.read(reinterpret_cast<char *>(&frame_header), sizeof(frame_header)))
+            return rewind(frame_begin);
+
+        const long n_blocks = long(frame_header.n_blocks);
+        if (n_blocks != (n_particles + block_size - 1) / block_size)
+            throw InputException("compressed_trajectory_reader::read_frame");
+
+        std::vector<std::uint64_t> block_offsets(n_blocks + 1, 0);
+        if (!ifs.read(reinterpret_cast<char *>(block_offsets.data() + 1), long(n_blocks * sizeof(std::uint64_t))))
+            return rewind(frame_begin);
+        for (long block = 0; block < n_blocks; block ++)
+            block_offsets[block + 1] += block_offsets[block];
+
+        payload.resize(block_offsets.back());
+        if (!ifs.read(reinterpret_cast<char *>(payload.data()), long(payload.size())))
+            return rewind(frame_begin);
+
+        const bool key_frame = frame_header.key_frame != 0;
+        x.resize(n_particles);
+        auto * values = reinterpret_cast<real_t *>(x.data());
+
+        // An exception cannot leave the parallel loop, the first one is kept and rethrown after it
+        std::exception_ptr error;
+
+        #pragma omp parallel for schedule(dynamic)
+        for (long block = 0; block < n_blocks; block ++) {
+            try {
+                unsigned char const * position = payload.data() + block_offsets[block];
+                unsigned char const * end = payload.data() + block_offsets[block + 1];
+
+                const long i_begin = block * block_size;
+                const long i_end = std::min(i_begin + block_size, n_particles);
+                std::int64_t previous_particle[n_components] = {};
+                for (long i = i_begin; i < i_end; i ++) {
+                    for (long c = 0; c < n_components; c ++) {
+                        const long k = i * n_components + c;
+                        const std::int64_t q = decode_varint(position, end) + (key_frame ? previous_particle[c] : quantized[k]);
+                        previous_particle[c] = q;
+                        quantized[k] = q;
+                        values[k] = real_t(double(q) * precision);
+                    }
+                }
+
+                if (position != end)
+                    throw InputException("compressed_trajectory_reader::read_frame (block longer than its particles)");
+            } catch (...) {
+                #pragma omp critical
+                {
+                    if (!error)
+                        error = std::current_exception();
+                }
+            }
+        }
+
+        if (error)
+            std::rethrow_exception(error);
+
+        step = frame_header.step;
+        t = real_t(frame_header.t);
+        n_frames_read ++;
+        return true;
+    }
+
+    // Getter for the index of the time step of the last frame read
+    [[nodiscard]] long get_step() const {
+        return step;
+    }
+
+    // Getter for the time of the last frame read
+    [[nodiscard]] real_t get_time() const {
+        return t;
+    }
+
+    // Getter for the number of frames read so far
+    [[nodiscard]] long get_n_frames_read() const {
+        return n_frames_read;
+    }
+
+    // Getter for the number of particles in every frame
+    [[nodiscard]] long get_n_particles() const {
+        return n_particles;
+    }
+
+    // Getter for the spacing of the quantized positions
+    [[nodiscard]] real_t get_precision() const {
+        return real_t(precision);
+    }
+
+private:
+    // Returns to the beginning of an incomplete frame, so that it is read again once it is complete
+    bool rewind(std::ifstream::pos_type frame_begin) {
+        ifs.clear();
+        ifs.seekg(frame_begin);
+        return false;
+    }
+
+    std::ifstream ifs;
+    long n_particles, block_size;
+    double precision;
+    long step = 0, n_frames_read = 0;
+    real_t t = 0;
+    std::vector<std::int64_t> quantized;
+    std::vector<unsigned char> payload;
+};
+
+#endif //INTEGRATORS_COMPRESSED_TRAJECTORY_H
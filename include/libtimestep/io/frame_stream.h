@@ -0,0 +1,196 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_FRAME_STREAM_H
+#define INTEGRATORS_FRAME_STREAM_H
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <utility>
+
+// Read-only view of the fields of a system at a frame of a frame_stream
+// The spans point into the buffers of the system, so they are only valid until the next frame is pulled
+// theta and omega are empty for systems without rotation
+template <typename field_value_t, typename real_t>
+struct frame_view {
+    long step;                                      // index of the time step
+    real_t t;                                       // time
+    std::span<field_value_t const> x, v;            // positions and velocities
+    std::span<field_value_t const> theta, omega;    // angles and angular velocities
+};
+
+// Lazy sequence of frames of a system, produced by a coroutine (see stream_frames())
+// The stream is an input range, so it can be iterated with a range-based for loop, or passed through standard range
+// adaptors (e.g. std::views::filter and std::views::take) that act as the stages of an analysis pipeline
+//
+// Notes:
+// The system is only stepped when the next frame is pulled, so the simulation runs as fast as the consumer reads
+// Frames are views into the system and are never copied, a stage that needs a frame later has to copy it
+// An exception thrown while stepping is rethrown by the pull that caused the step
+template <typename field_value_t, typename real_t>
+class frame_stream : public std::ranges::view_base {
+public:
+    typedef frame_view<field_value_t, real_t> frame_t;
+
+    struct promise_type {
+        frame_t const * frame = nullptr;
+        std::exception_ptr exception;
+        bool advance_pending = false;
+
+        frame_stream get_return_object() {
+            return frame_stream(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always yield_value(frame_t const & new_frame) noexcept {
+            frame = &new_frame;
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() {
+            exception = std::current_exception();
+        }
+    };
+
+    // Input iterator over the frames
+    // Advancing the iterator only marks the current frame as consumed, the coroutine is resumed when the next frame is
+    // read or compared with the end, so that e.g. std::views::take does not step the system past its last frame
+    class iterator {
+    public:
+        typedef std::input_iterator_tag iterator_concept;
+        typedef frame_t value_type;
+        typedef std::ptrdiff_t difference_type;
+
+        iterator() = default;
+
+        explicit iterator(std::coroutine_handle<promise_type> coroutine) : coroutine(coroutine) {}
+
+        frame_t const & operator * () const {
+            settle(coroutine);
+            return *coroutine.promise().frame;
+        }
+
+        frame_t const * operator -> () const {
+            settle(coroutine);
+            return coroutine.promise().frame;
+        }
+
+        iterator & operator ++ () {
+            coroutine.promise().advance_pending = true;
+            return *this;
+        }
+
+        void operator ++ (int) {
+            ++ *this;
+        }
+
+        friend bool operator == (iterator const & itr, std::default_sentinel_t) {
+            return itr.at_end();
+        }
+
+    private:
+        [[nodiscard]] bool at_end() const {
+            if (coroutine == nullptr)
+                return true;
+            settle(coroutine);
+            return coroutine.done();
+        }
+
+        std::coroutine_handle<promise_type> coroutine;
+    };
+
+    frame_stream(frame_stream const &) = delete;
+    frame_stream & operator = (frame_stream const &) = delete;
+
+    frame_stream(frame_stream && other) noexcept : coroutine(std::exchange(other.coroutine, nullptr)) {}
+
+    frame_stream & operator = (frame_stream && other) noexcept {
+        if (this != &other) {
+            if (coroutine)
+                coroutine.destroy();
+            coroutine = std::exchange(other.coroutine, nullptr);
+        }
+        return *this;
+    }
+
+    ~frame_stream() {
+        if (coroutine)
+            coroutine.destroy();
+    }
+
+    // Produces the first frame, the stream can only be iterated once
+    iterator begin() {
+        resume(coroutine);
+        return iterator(coroutine);
+    }
+
+    std::default_sentinel_t end() const {
+        return std::default_sentinel;
+    }
+
+private:
+    explicit frame_stream(std::coroutine_handle<promise_type> coroutine) : coroutine(coroutine) {}
+
+    // Produces the next frame if the current one was consumed
+    static void settle(std::coroutine_handle<promise_type> coroutine) {
+        if (coroutine.promise().advance_pending) {
+            coroutine.promise().advance_pending = false;
+            resume(coroutine);
+        }
+    }
+
+    static void resume(std::coroutine_handle<promise_type> coroutine) {
+        if (!coroutine || coroutine.done())
+            return;
+
+        coroutine.resume();
+        if (coroutine.promise().exception)
+            std::rethrow_exception(std::exchange(coroutine.promise().exception, nullptr));
+    }
+
+    std::coroutine_handle<promise_type> coroutine;
+};
+
+// Creates a stream that yields a frame of the system every period steps, starting with the current state
+// n_frames is the number of frames produced, a negative value makes the stream endless (e.g. for std::views::take)
+// e.g. for (auto const & frame : stream_frames<Eigen::Vector3d, double>(system, dt, 100, 50)) { analyze(frame.x); }
+//
+// Notes:
+// The system must exist for the duration of use of the stream, and must not be stepped by anything else in between
+// The time of the frames is counted from t0 in steps of dt
+template <typename field_value_t, typename real_t, typename system_t>
+frame_stream<field_value_t, real_t> stream_frames(system_t & system,    // system that is stepped
+                                                  real_t dt,            // time step
+                                                  long period,          // number of steps between the frames
+                                                  long n_frames = -1,   // number of frames, or negative for no limit
+                                                  long step0 = 0,       // index of the time step of the current state
+                                                  real_t t0 = 0) {      // time of the current state
+    for (long n = 0; n_frames < 0 || n < n_frames; n ++) {
+        if (n > 0)
+            system.do_steps(period, dt);
+
+        const long step = step0 + n * period;
+        frame_view<field_value_t, real_t> frame {step, t0 + real_t(step - step0) * dt, system.get_x(), system.get_v(), {}, {}};
+        if constexpr (requires { system.get_theta(); }) {
+            frame.theta = system.get_theta();
+            frame.omega = system.get_omega();
+        }
+
+        co_yield frame;
+    }
+}
+
+#endif //INTEGRATORS_FRAME_STREAM_H
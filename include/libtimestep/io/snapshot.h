@@ -0,0 +1,294 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_SNAPSHOT_H
+#define INTEGRATORS_SNAPSHOT_H
+
+#include <vector>
+#include <string>
+#include <span>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <new>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "async_output.h"
+#include "../exception/exception.h"
+
+// Layout of the memory shared by a snapshot_publisher and its snapshot_readers:
+// - a snapshot_ring_header padded to 64 bytes
+// - n_slots slots of slot_size bytes each, a slot is a snapshot_slot_header padded to 64 bytes, followed by the arrays
+//   of the fields, each padded to a multiple of 64 bytes, in the order x, v, theta, omega
+// Each slot is guarded by a sequence number (a seqlock), which is odd while the publisher writes the slot. A reader
+// copies or visits the most recently published slot and checks afterwards that the sequence number did not change,
+// so the publisher never waits for the readers, and a reader retries if the slot was overwritten while it was reading
+struct snapshot_ring_header {
+    char magic[8];                          // "LTSSNAP1"
+    std::uint64_t n_particles;              // number of particles in every snapshot
+    std::uint64_t n_fields;                 // 2 (x, v) or 4 (x, v, theta, omega)
+    std::uint64_t value_size;               // size of a field value in bytes
+    std::uint64_t n_slots;                  // number of slots in the ring
+    std::uint64_t slot_size;                // size of a slot in bytes
+    std::atomic<std::uint64_t> n_published; // number of snapshots published so far
+};
+
+// Header of every slot
+struct snapshot_slot_header {
+    std::atomic<std::uint64_t> sequence;    // odd while the slot is being written
+    std::int64_t step;                      // index of the time step
+    double t;                               // time
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "snapshots need lock-free 64-bit atomics to be shared between processes");
+
+constexpr long snapshot_alignment = 64;
+constexpr char snapshot_magic[8] = {'L', 'T', 'S', 'S', 'N', 'A', 'P', '1'};
+
+// Returns n rounded up to a multiple of the alignment of the snapshot arrays
+inline long snapshot_aligned(long n) {
+    return (n + snapshot_alignment - 1) / snapshot_alignment * snapshot_alignment;
+}
+
+// Publisher of consistent snapshots of the fields of a system to readers on other threads or in other processes
+// The snapshots are published at step boundaries into a ring of n_slots slots. The ring is in anonymous memory,
+// or, if a name is given, in a POSIX shared memory object that other processes on the same machine can map
+// (see snapshot_reader)
+//
+// Notes:
+// publish() never blocks, a reader that is too slow to copy a snapshot before n_slots - 1 newer ones are published
+// retries with the latest one
+// field_value_t must be stored without pointers to other memory (e.g. double or Eigen::Vector3d)
+template <typename field_value_t, typename real_t>
+class snapshot_publisher {
+public:
+    snapshot_publisher(snapshot_publisher const &) = delete;
+    snapshot_publisher & operator = (snapshot_publisher const &) = delete;
+
+    // Class constructor, the layout of the snapshots is taken from the system
+    template <typename system_t>
+    explicit snapshot_publisher(system_t const & system,                // system whose fields are published
+                                long n_slots = 3,                       // number of slots in the ring
+                                std::string shared_memory_name = "") :  // name of the shared memory object (e.g. "/simulation"), or empty
+            shared_memory_name(std::move(shared_memory_name)) {
+        const long n_particles = (long) system.get_x().size();
+        const long n_fields = requires { system.get_theta(); } ? 4 : 2;
+        const long slot_size = snapshot_alignment + n_fields * snapshot_aligned(n_particles * long(sizeof(field_value_t)));
+        mapping_size = snapshot_alignment + std::max(n_slots, 2l) * slot_size;
+
+        if (this->shared_memory_name.empty()) {
+            mapping = ::mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        } else {
+            const int file = ::shm_open(this->shared_memory_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (file < 0)
+                throw OutputException("snapshot_publisher constructor (shm_open)");
+
+            if (::ftruncate(file, long(mapping_size)) == 0)
+                mapping = ::mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+            ::close(file);
+        }
+
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+            if (!this->shared_memory_name.empty())
+                ::shm_unlink(this->shared_memory_name.c_str());
+            throw OutputException("snapshot_publisher constructor (mmap)");
+        }
+
+        // The mapping is zero filled, so the sequence numbers and the number of published snapshots start at zero
+        auto * header = new (mapping) snapshot_ring_header;
+        std::memcpy(header->magic, snapshot_magic, sizeof(header->magic));
+        header->n_particles = n_particles;
+        header->n_fields = n_fields;
+        header->value_size = sizeof(field_value_t);
+        header->n_slots = std::max(n_slots, 2l);
+        header->slot_size = slot_size;
+        header->n_published.store(0, std::memory_order_release);
+    }
+
+    ~snapshot_publisher() {
+        if (mapping != nullptr)
+            ::munmap(mapping, mapping_size);
+        if (!shared_memory_name.empty())
+            ::shm_unlink(shared_memory_name.c_str());
+    }
+
+    // Publishes the fields of the system, called between time steps
+    template <typename system_t>
+    void publish(system_t const & system,   // system whose fields are published
+                 long step,                 // index of the time step
+                 real_t t) {                // time
+        auto * header = static_cast<snapshot_ring_header *>(mapping);
+        if (system.get_x().size() != header->n_particles)
+            throw SizeMismatchException("snapshot_publisher::publish");
+
+        const std::uint64_t n_published = header->n_published.load(std::memory_order_relaxed);
+        char * slot = static_cast<char *>(mapping) + snapshot_alignment + (n_published % header->n_slots) * header->slot_size;
+        auto * slot_header = reinterpret_cast<snapshot_slot_header *>(slot);
+
+        // Readers that see an odd sequence number, or a different one after reading, discard what they read
+        const std::uint64_t sequence = slot_header->sequence.load(std::memory_order_relaxed);
+        slot_header->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot_header->step = step;
+        slot_header->t = double(t);
+
+        const long array_size = snapshot_aligned(long(header->n_particles * sizeof(field_value_t)));
+        auto copy_field = [slot, array_size] (std::vector<field_value_t> const & values, long field) {
+            std::memcpy(slot + snapshot_alignment + field * array_size, values.data(), values.size() * sizeof(field_value_t));
+        };
+
+        copy_field(system.get_x(), 0);
+        copy_field(system.get_v(), 1);
+        if constexpr (requires { system.get_theta(); }) {
+            copy_field(system.get_theta(), 2);
+            copy_field(system.get_omega(), 3);
+        }
+
+        slot_header->sequence.store(sequence + 2, std::memory_order_release);
+        header->n_published.store(n_published + 1, std::memory_order_release);
+    }
+
+    // Getter for the number of snapshots published so far
+    [[nodiscard]] long get_n_published() const {
+        return long(static_cast<snapshot_ring_header const *>(mapping)->n_published.load(std::memory_order_acquire));
+    }
+
+    // Getter for the memory of the ring, used by readers in the same process
+    [[nodiscard]] void const * get_mapping() const {
+        return mapping;
+    }
+
+private:
+    std::string shared_memory_name;
+    void * mapping = nullptr;
+    size_t mapping_size = 0;
+};
+
+// Reader of the snapshots published by a snapshot_publisher, in the same process or, through the shared memory
+// object, in another process
+// read() copies the latest snapshot, visit() passes the arrays of the latest snapshot in the ring to a callable
+// without copying them
+template <typename field_value_t, typename real_t>
+class snapshot_reader {
+public:
+    snapshot_reader(snapshot_reader const &) = delete;
+    snapshot_reader & operator = (snapshot_reader const &) = delete;
+
+    // Class constructor for readers in the same process as the publisher
+    explicit snapshot_reader(snapshot_publisher<field_value_t, real_t> const & publisher /* publisher of the snapshots */) :
+            mapping(publisher.get_mapping()) {
+        check_header();
+    }
+
+    // Class constructor for readers in another process, maps the shared memory object of the publisher read only
+    explicit snapshot_reader(std::string const & shared_memory_name /* name of the shared memory object */) {
+        const int file = ::shm_open(shared_memory_name.c_str(), O_RDONLY, 0);
+        if (file < 0)
+            throw InputException("snapshot_reader constructor (shm_open)");
+
+        struct stat status {};
+        if (::fstat(file, &status) == 0 && status.st_size >= snapshot_alignment) {
+            mapping_size = status.st_size;
+            void * new_mapping = ::mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, file, 0);
+            if (new_mapping != MAP_FAILED) {
+                mapping = new_mapping;
+                owns_mapping = true;
+            }
+        }
+        ::close(file);
+
+        if (mapping == nullptr)
+            throw InputException("snapshot_reader constructor (mmap)");
+
+        check_header();
+    }
+
+    ~snapshot_reader() {
+        if (owns_mapping)
+            ::munmap(const_cast<void *>(mapping), mapping_size);
+    }
+
+    // Calls visitor(step, t, x, v, theta, omega) with spans into the latest snapshot, theta and omega are empty for
+    // systems without rotation
+    // Returns true if the snapshot was not overwritten during the call, i.e. if the values seen by the visitor are
+    // consistent, and false if it was overwritten, or if nothing has been published yet
+    template <typename visitor_t>
+    bool visit(visitor_t && visitor) const {
+        const std::uint64_t n_published = header()->n_published.load(std::memory_order_acquire);
+        if (n_published == 0)
+            return false;
+
+        char const * slot = static_cast<char const *>(mapping) + snapshot_alignment + ((n_published - 1) % header()->n_slots) * header()->slot_size;
+        auto const * slot_header = reinterpret_cast<snapshot_slot_header const *>(slot);
+
+        const std::uint64_t sequence = slot_header->sequence.load(std::memory_order_acquire);
+        if (sequence % 2 != 0)
+            return false;
+
+        const long n = long(header()->n_particles);
+        const long array_size = snapshot_aligned(n * long(sizeof(field_value_t)));
+        auto field = [slot, array_size, n, this] (long index) {
+            if (index >= long(header()->n_fields))
+                return std::span<field_value_t const>();
+            return std::span<field_value_t const>(reinterpret_cast<field_value_t const *>(slot + snapshot_alignment + index * array_size), n);
+        };
+
+        visitor(long(slot_header->step), real_t(slot_header->t), field(0), field(1), field(2), field(3));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot_header->sequence.load(std::memory_order_relaxed) == sequence;
+    }
+
+    // Copies the latest snapshot, retrying if it is overwritten while being copied
+    // Returns false if nothing has been published yet
+    bool read(output_snapshot<field_value_t, real_t> & snapshot) const {
+        if (header()->n_published.load(std::memory_order_acquire) == 0)
+            return false;
+
+        auto copy = [&snapshot] (long step, real_t t, auto x, auto v, auto theta, auto omega) {
+            snapshot.step = step;
+            snapshot.t = t;
+            snapshot.x.assign(x.begin(), x.end());
+            snapshot.v.assign(v.begin(), v.end());
+            snapshot.theta.assign(theta.begin(), theta.end());
+            snapshot.omega.assign(omega.begin(), omega.end());
+        };
+
+        while (!visit(copy));
+        return true;
+    }
+
+    // Getter for the number of snapshots published so far
+    [[nodiscard]] long get_n_published() const {
+        return long(header()->n_published.load(std::memory_order_acquire));
+    }
+
+    // Getter for the number of particles in every snapshot
+    [[nodiscard]] long get_n_particles() const {
+        return long(header()->n_particles);
+    }
+
+private:
+    [[nodiscard]] snapshot_ring_header const * header() const {
+        return static_cast<snapshot_ring_header const *>(mapping);
+    }
+
+    void check_header() const {
+        if (std::memcmp(header()->magic, snapshot_magic, sizeof(snapshot_magic)) != 0 || header()->value_size != sizeof(field_value_t))
+            throw InputException("snapshot_reader constructor (incompatible snapshots)");
+    }
+
+    void const * mapping = nullptr;
+    size_t mapping_size = 0;
+    bool owns_mapping = false;
+};
+
+#endif //INTEGRATORS_SNAPSHOT_H
@@ -0,0 +1,346 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_TRAJECTORY_H
+#define INTEGRATORS_TRAJECTORY_H
+
+#include <vector>
+#include <string>
+#include <span>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../exception/exception.h"
+
+// Fields stored in every frame of a trajectory, rotational trajectories store all four
+enum class trajectory_field {
+    x = 0,
+    v = 1,
+    theta = 2,
+    omega = 3
+};
+
+// Layout of a trajectory file:
+// - a header of trajectory_header_size bytes (trajectory_header followed by zeros)
+// - frames of frame_size bytes each, frame k starts at trajectory_header_size + k * frame_size
+// - a frame is a trajectory_frame_header padded to 64 bytes, followed by the arrays of the fields, each array holds
+//   n_particles values in the memory layout of the writer and is padded to a multiple of 64 bytes
+// Since all frames have the same layout, the position of any frame and particle is known without reading the file,
+// and the arrays are aligned, so that a memory map of the file can be used as the arrays of the values directly
+struct trajectory_header {
+    char magic[8];                  // "LTSTRAJ1"
+    std::uint64_t n_particles;      // number of particles in every frame
+    std::uint64_t n_fields;         // 2 (x, v) or 4 (x, v, theta, omega)
+    std::uint64_t value_size;       // size of a field value in bytes
+    std::uint64_t real_size;        // size of a real number in bytes
+    std::uint64_t frame_size;       // size of a frame in bytes
+    std::uint64_t frames_per_chunk; // number of frames the file is extended by at a time
+    std::uint64_t n_frames;         // number of complete frames
+};
+
+// Header of every frame
+struct trajectory_frame_header {
+    std::int64_t step;              // index of the time step
+    double t;                       // time
+};
+
+constexpr long trajectory_header_size = 4096;
+constexpr long trajectory_alignment = 64;
+constexpr char trajectory_magic[8] = {'L', 'T', 'S', 'T', 'R', 'A', 'J', '1'};
+
+// Returns n rounded up to a multiple of the alignment of the trajectory arrays
+inline long trajectory_aligned(long n) {
+    return (n + trajectory_alignment - 1) / trajectory_alignment * trajectory_alignment;
+}
+
+// Writer of trajectories of a system too long to be kept in memory
+// Every frame is written to the end of the file from the buffers of the system, and the file is extended by
+// frames_per_chunk frames at a time, so that the file system allocates the space in large chunks
+// The number of frames in the header is updated after every frame, so a reader can follow a trajectory as it is written
+template <typename field_value_t, typename real_t>
+class trajectory_writer {
+public:
+    trajectory_writer(trajectory_writer const &) = delete;
+    trajectory_writer & operator = (trajectory_writer const &) = delete;
+
+    // Class constructor, the layout of the frames is taken from the system
+    template <typename system_t>
+    trajectory_writer(std::string const & path,         // path of the trajectory file, an existing file is replaced
+                      system_t const & system,          // system whose fields are written
+                      long frames_per_chunk = 64) {     // number of frames the file is extended by at a time
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, trajectory_magic, sizeof(header.magic));
+        header.n_particles = system.get_x().size();
+        header.n_fields = requires { system.get_theta(); } ? 4 : 2;
+        header.value_size = sizeof(field_value_t);
+        header.real_size = sizeof(real_t);
+        header.frame_size = trajectory_alignment + header.n_fields * trajectory_aligned(long(header.n_particles * header.value_size));
+        header.frames_per_chunk = frames_per_chunk;
+        header.n_frames = 0;
+
+        file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (file < 0)
+            throw OutputException("trajectory_writer constructor");
+
+        std::array<char, trajectory_header_size> header_page {};
+        std::memcpy(header_page.data(), &header, sizeof(header));
+        try {
+            write_at(header_page.data(), trajectory_header_size, 0);
+        } catch (...) {
+            ::close(file);
+            throw;
+        }
+    }
+
+    ~trajectory_writer() {
+        // The unused part of the last chunk is cut off
+        if (file >= 0) {
+            [[maybe_unused]] int result = ::ftruncate(file, frame_offset(long(header.n_frames)));
+            ::close(file);
+        }
+    }
+
+    // Appends a frame with the fields of the system
+    template <typename system_t>
+    void write(system_t const & system,     // system whose fields are written
+               long step,                   // index of the time step
+               real_t t) {                  // time
+        if (system.get_x().size() != header.n_particles)
+            throw SizeMismatchException("trajectory_writer::write");
+
+        const long frame = long(header.n_frames);
+
+        // Extend the file by a chunk
+        if (frame == capacity) {
+            capacity += long(header.frames_per_chunk);
+            if (::ftruncate(file, frame_offset(capacity)) != 0)
+                throw OutputException("trajectory_writer::write");
+        }
+
+        std::array<char, trajectory_alignment> frame_header {};
+        trajectory_frame_header values = {step, double(t)};
+        std::memcpy(frame_header.data(), &values, sizeof(values));
+        write_at(frame_header.data(), trajectory_alignment, frame_offset(frame));
+
+        write_field(system.get_x(), frame, trajectory_field::x);
+        write_field(system.get_v(), frame, trajectory_field::v);
+        if constexpr (requires { system.get_theta(); }) {
+            write_field(system.get_theta(), frame, trajectory_field::theta);
+            write_field(system.get_omega(), frame, trajectory_field::omega);
+        }
+
+        // The frame is complete
+        header.n_frames ++;
+        write_at(&header.n_frames, sizeof(header.n_frames), offsetof(trajectory_header, n_frames));
+    }
+
+    // Getter for the number of frames written so far
+    [[nodiscard]] long get_n_frames() const {
+        return long(header.n_frames);
+    }
+
+private:
+    void write_field(std::vector<field_value_t> const & values, long frame, trajectory_field field) {
+        const long array_size = trajectory_aligned(long(header.n_particles * header.value_size));
+        write_at(values.data(), long(header.n_particles * header.value_size),
+                 frame_offset(frame) + trajectory_alignment + long(field) * array_size);
+    }
+
+    void write_at(void const * data, long n_bytes, long offset) {
+        auto const * bytes = static_cast<char const *>(data);
+
+        while (n_bytes > 0) {
+            const ssize_t written = ::pwrite(file, bytes, n_bytes, offset);
+            if (written <= 0)
+                throw OutputException("trajectory_writer::write");
+
+            bytes += written;
+            n_bytes -= written;
+            offset += written;
+        }
+    }
+
+    [[nodiscard]] long frame_offset(long frame) const {
+        return trajectory_header_size + frame * long(header.frame_size);
+    }
+
+    trajectory_header header;
+    int file = -1;
+    long capacity = 0;
+};
+
+// Reader of trajectory files that maps the file into memory, so that any frame and any range of particles can be
+// accessed without reading the frames before it
+// get_field() returns the values in the mapped file without copying them, if the trajectory was written with the
+// same field_value_t and real_t, read_field() copies the values and converts them between float and double
+template <typename field_value_t, typename real_t>
+class trajectory_reader {
+public:
+    trajectory_reader(trajectory_reader const &) = delete;
+    trajectory_reader & operator = (trajectory_reader const &) = delete;
+
+    // Class constructor
+    explicit trajectory_reader(std::string const & path /* path of the trajectory file */) {
+        file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0)
+            throw InputException("trajectory_reader constructor");
+
+        // The destructor is not called if the constructor throws, so the file is released here
+        try {
+            map_file("trajectory_reader constructor");
+
+            if (std::memcmp(get_header().magic, trajectory_magic, sizeof(trajectory_magic)) != 0)
+                throw InputException("trajectory_reader constructor (not a trajectory file)");
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    ~trajectory_reader() {
+        release();
+    }
+
+    // Maps the file again to see the frames that were written since the file was mapped
+    // If the file cannot be mapped again, the current map is kept
+    void refresh() {
+        map_file("trajectory_reader::refresh");
+    }
+
+    // Getter for the number of complete frames in the mapped part of the file
+    [[nodiscard]] long get_n_frames() const {
+        const long mapped_frames = (long(mapping_size) - trajectory_header_size) / long(get_header().frame_size);
+        return std::min(long(get_header().n_frames), mapped_frames);
+    }
+
+    // Getter for the number of particles in every frame
+    [[nodiscard]] long get_n_particles() const {
+        return long(get_header().n_particles);
+    }
+
+    // Returns true if the frames store angles and angular velocities
+    [[nodiscard]] bool has_rotation() const {
+        return get_header().n_fields == 4;
+    }
+
+    // Getter for the index of the time step of a frame
+    [[nodiscard]] long get_step(long frame) const {
+        return get_frame_header(frame).step;
+    }
+
+    // Getter for the time of a frame
+    [[nodiscard]] real_t get_time(long frame) const {
+        return real_t(get_frame_header(frame).t);
+    }
+
+    // Returns the values of a field of the particles in range [i_begin, i_end) of a frame without copying them
+    // The values remain valid until the reader is refreshed or destroyed
+    [[nodiscard]] std::span<field_value_t const> get_field(trajectory_field field,     // field to read
+                                                           long frame,                  // index of the frame
+                                                           long i_begin,                // index of the first particle
+                                                           long i_end) const {          // index past the last particle
+        if (get_header().value_size != sizeof(field_value_t) || get_header().real_size != sizeof(real_t))
+            throw InputException("trajectory_reader::get_field (the trajectory was written with other types)");
+
+        return {reinterpret_cast<field_value_t const *>(field_data(field, frame, i_begin, i_end)), size_t(i_end - i_begin)};
+    }
+
+    // Returns a copy of the values of a field of the particles in range [i_begin, i_end) of a frame
+    // Values written with a different real number type (float or double) are converted
+    [[nodiscard]] std::vector<field_value_t> read_field(trajectory_field field,     // field to read
+                                                        long frame,                  // index of the frame
+                                                        long i_begin,                // index of the first particle
+                                                        long i_end) const {          // index past the last particle
+        trajectory_header const & header = get_header();
+        const long n_components = long(sizeof(field_value_t) / sizeof(real_t));
+
+        if (long(header.value_size / header.real_size) != n_components || (header.real_size != 4 && header.real_size != 8))
+            throw InputException("trajectory_reader::read_field (the trajectory was written with other types)");
+
+        char const * data = field_data(field, frame, i_begin, i_end);
+        std::vector<field_value_t> values(i_end - i_begin);
+
+        if (header.real_size == sizeof(real_t)) {
+            std::memcpy(static_cast<void *>(values.data()), data, values.size() * sizeof(field_value_t));
+            return values;
+        }
+
+        auto * destination = reinterpret_cast<real_t *>(values.data());
+        for (long k = 0; k < (i_end - i_begin) * n_components; k ++) {
+            if (header.real_size == sizeof(float))
+                destination[k] = real_t(reinterpret_cast<float const *>(data)[k]);
+            else
+                destination[k] = real_t(reinterpret_cast<double const *>(data)[k]);
+        }
+
+        return values;
+    }
+
+private:
+    // Maps the whole file, the previous map is only replaced once the new one is in place
+    void map_file(std::string const & source) {
+        struct stat status {};
+        if (::fstat(file, &status) != 0 || status.st_size < trajectory_header_size)
+            throw InputException(source);
+
+        void * new_mapping = ::mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+        if (new_mapping == MAP_FAILED)
+            throw InputException(source);
+
+        if (mapping != nullptr)
+            ::munmap(mapping, mapping_size);
+        mapping = new_mapping;
+        mapping_size = size_t(status.st_size);
+    }
+
+    void release() {
+        if (mapping != nullptr)
+            ::munmap(mapping, mapping_size);
+        if (file >= 0)
+            ::close(file);
+        mapping = nullptr;
+        file = -1;
+    }
+
+    [[nodiscard]] trajectory_header const & get_header() const {
+        return *static_cast<trajectory_header const *>(mapping);
+    }
+
+    [[nodiscard]] trajectory_frame_header const & get_frame_header(long frame) const {
+        check_frame(frame, 0, 0);
+        return *reinterpret_cast<trajectory_frame_header const *>(frame_data(frame));
+    }
+
+    [[nodiscard]] char const * frame_data(long frame) const {
+        return static_cast<char const *>(mapping) + trajectory_header_size + frame * long(get_header().frame_size);
+    }
+
+    [[nodiscard]] char const * field_data(trajectory_field field, long frame, long i_begin, long i_end) const {
+        check_frame(frame, i_begin, i_end);
+        if (long(field) >= long(get_header().n_fields))
+            throw InputException("trajectory_reader (the field is not stored in the trajectory)");
+
+        const long array_size = trajectory_aligned(long(get_header().n_particles * get_header().value_size));
+        return frame_data(frame) + trajectory_alignment + long(field) * array_size + i_begin * long(get_header().value_size);
+    }
+
+    void check_frame(long frame, long i_begin, long i_end) const {
+        if (frame < 0 || frame >= get_n_frames() || i_begin < 0 || i_end < i_begin || i_end > get_n_particles())
+            throw InputException("trajectory_reader (frame or particle out of range)");
+    }
+
+    int file = -1;
+    void * mapping = nullptr;
+    size_t mapping_size = 0;
+};
+
+#endif //INTEGRATORS_TRAJECTORY_H
@@ -0,0 +1,168 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_TRAJECTORY_RECORDER_H
+#define INTEGRATORS_TRAJECTORY_RECORDER_H
+
+#include <vector>
+#include <span>
+#include <algorithm>
+
+#include "trajectory.h"
+#include "../exception/exception.h"
+
+// What a trajectory_recorder does once all of its frames are used
+enum class recorder_mode {
+    ring,   // the oldest frame is overwritten, so the recorder holds the latest frames
+    fixed   // recording more frames throws a CapacityExceededException
+};
+
+// Recorder of the history of a system in memory, with all storage allocated by the constructor
+// Every decimation-th step is recorded, and only the selected fields of the selected particles are kept, so recording
+// a frame costs a copy of the kept values and nothing else
+//
+// Notes:
+// Frames are numbered from the oldest one held, i.e. after the ring wraps around, frame 0 is the oldest frame not
+// overwritten yet
+template <typename field_value_t, typename real_t>
+class trajectory_recorder {
+public:
+    // Class constructor, the number of particles is taken from the system
+    template <typename system_t>
+    trajectory_recorder(system_t const & system,                                            // system whose history is recorded
+                        long capacity,                                                      // number of frames held
+                        long decimation = 1,                                                // steps with indices divisible by this are recorded
+                        std::vector<trajectory_field> fields = {trajectory_field::x},       // fields that are recorded
+                        std::vector<long> particles = {},                                   // indices of the particles that are recorded, or empty for all
+                        recorder_mode mode = recorder_mode::ring) :                         // what happens once all frames are used
+            capacity(std::max(capacity, 1l)), decimation(std::max(decimation, 1l)),
+            fields(std::move(fields)), particles(std::move(particles)), mode(mode),
+            n_particles((long) system.get_x().size()),
+            n_recorded(this->particles.empty() ? n_particles : (long) this->particles.size()) {
+
+        for (auto field : this->fields) {
+            const bool rotational = field == trajectory_field::theta || field == trajectory_field::omega;
+            if (rotational && !requires { system.get_theta(); })
+                throw OutOfRangeException("trajectory_recorder constructor (angular field of a system without rotation)");
+        }
+
+        for (long i : this->particles) {
+            if (i < 0 || i >= n_particles)
+                throw OutOfRangeException("trajectory_recorder constructor (particle index)");
+        }
+
+        values.resize(this->capacity * (long) this->fields.size() * n_recorded);
+        steps.resize(this->capacity);
+        times.resize(this->capacity);
+    }
+
+    // Records a frame if the index of the step is divisible by the decimation, returns true if a frame was recorded
+    // Can be called after every step, e.g. as an observer of do_steps()
+    template <typename system_t>
+    bool record(system_t const & system,    // system whose fields are recorded
+                long step,                  // index of the time step
+                real_t t) {                 // time
+        if (step % decimation != 0)
+            return false;
+
+        if ((long) system.get_x().size() != n_particles)
+            throw SizeMismatchException("trajectory_recorder::record");
+
+        if (n_frames == capacity && mode == recorder_mode::fixed)
+            throw CapacityExceededException("trajectory_recorder::record");
+
+        const long slot = (first_frame + n_frames) % capacity;
+        steps[slot] = step;
+        times[slot] = t;
+
+        for (long k = 0; k < (long) fields.size(); k ++) {
+            field_value_t * destination = values.data() + (slot * (long) fields.size() + k) * n_recorded;
+
+            auto const & source = select_field(system, fields[k]);
+            if (particles.empty()) {
+                std::copy(source.begin(), source.end(), destination);
+            } else {
+                for (long n = 0; n < n_recorded; n ++)
+                    destination[n] = source[particles[n]];
+            }
+        }
+
+        if (n_frames < capacity)
+            n_frames ++;
+        else
+            first_frame = (first_frame + 1) % capacity;
+
+        return true;
+    }
+
+    // Removes all frames, the storage is kept
+    void clear() {
+        n_frames = 0;
+        first_frame = 0;
+    }
+
+    // Getter for the values of a recorded field in a frame, in the order of the recorded particles
+    [[nodiscard]] std::span<field_value_t const> get_field(trajectory_field field,    // recorded field
+                                                          long frame) const {       // index of the frame, 0 is the oldest one held
+        auto position = std::find(fields.begin(), fields.end(), field);
+        if (position == fields.end())
+            throw OutOfRangeException("trajectory_recorder::get_field (field not recorded)");
+
+        const long slot = slot_of(frame, "trajectory_recorder::get_field");
+        return {values.data() + (slot * (long) fields.size() + (position - fields.begin())) * n_recorded, size_t(n_recorded)};
+    }
+
+    // Getter for the index of the time step of a frame
+    [[nodiscard]] long get_step(long frame /* index of the frame */) const {
+        return steps[slot_of(frame, "trajectory_recorder::get_step")];
+    }
+
+    // Getter for the time of a frame
+    [[nodiscard]] real_t get_time(long frame /* index of the frame */) const {
+        return times[slot_of(frame, "trajectory_recorder::get_time")];
+    }
+
+    // Getter for the number of frames held
+    [[nodiscard]] long get_n_frames() const {
+        return n_frames;
+    }
+
+    // Getter for the indices of the recorded particles, empty if all particles are recorded
+    [[nodiscard]] std::vector<long> const & get_particles() const {
+        return particles;
+    }
+
+private:
+    // Returns the slot that holds a frame, frames that are not held are rejected
+    [[nodiscard]] long slot_of(long frame, char const * source) const {
+        if (frame < 0 || frame >= n_frames)
+            throw OutOfRangeException(source);
+
+        return (first_frame + frame) % capacity;
+    }
+
+    template <typename system_t>
+    static auto const & select_field(system_t const & system, trajectory_field field) {
+        if constexpr (requires { system.get_theta(); }) {
+            if (field == trajectory_field::theta)
+                return system.get_theta();
+            if (field == trajectory_field::omega)
+                return system.get_omega();
+        }
+        return field == trajectory_field::x ? system.get_x() : system.get_v();
+    }
+
+    const long capacity, decimation;
+    const std::vector<trajectory_field> fields;
+    const std::vector<long> particles;
+    const recorder_mode mode;
+    const long n_particles, n_recorded;
+
+    long n_frames = 0, first_frame = 0;
+    std::vector<field_value_t> values;
+    std::vector<long> steps;
+    std::vector<real_t> times;
+};
+
+#endif //INTEGRATORS_TRAJECTORY_RECORDER_H
@@ -0,0 +1,302 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_VTU_WRITER_H
+#define INTEGRATORS_VTU_WRITER_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <bit>
+#include <algorithm>
+
+#ifdef LIBTIMESTEP_ZLIB
+#include <zlib.h>
+#endif
+
+#include "../parallel/partition.h"
+#include "../exception/exception.h"
+
+// Compression of the arrays written by vtu_writer
+enum class vtu_compression {
+    none,   // arrays are written as they are in memory
+    zlib    // arrays are compressed in blocks (needs LIBTIMESTEP_ZLIB to be defined and zlib to be linked)
+};
+
+// Writer of the fields of a system to XML VTK unstructured grid files (.vtu) with appended binary data
+// The positions are written as the points, and the velocities (and the angles and angular velocities of rotational
+// systems) as point data named v, theta, and omega
+// The arrays are written from the buffers of the system without conversion to text, either as they are in memory
+// or compressed with zlib in the format of vtkZLibDataCompressor
+// A dump can be split into pieces that are written in parallel, and tied together by a .pvtu file
+//
+// Notes:
+// field_value_t must be stored as 1 to 3 values of real_t without padding (e.g. double or Eigen::Vector3d),
+// fields with less than 3 components are padded with zeros in the points
+// The files are written in the byte order of the machine
+template <typename field_value_t, typename real_t>
+class vtu_writer {
+public:
+    typedef std::vector<field_value_t> field_container_t;
+
+    static_assert(sizeof(field_value_t) % sizeof(real_t) == 0
+                  && sizeof(field_value_t) / sizeof(real_t) <= 3, "field_value_t must be an array of 1 to 3 values of real_t");
+
+    // Class constructor
+    vtu_writer(std::string directory,                                   // directory the files are written to
+               std::string prefix,                                      // files are named prefix_<index>.vtu
+               vtu_compression compression = vtu_compression::none) :   // compression of the arrays
+            directory(std::move(directory)), prefix(std::move(prefix)), compression(compression) {
+#ifndef LIBTIMESTEP_ZLIB
+        if (compression == vtu_compression::zlib)
+            throw OutputException("vtu_writer constructor (zlib support is not compiled in)");
+#endif
+    }
+
+    // Writes all fields of a system to prefix_<index>.vtu and returns the name of the file
+    template <typename system_t>
+    std::string write(system_t const & system,  // system to write
+                      long index) const {       // index of the dump
+        const std::string file_name = prefix + "_" + std::to_string(index) + ".vtu";
+        write_piece_file(system, file_name, 0, (long) system.get_x().size());
+        return file_name;
+    }
+
+    // Writes the fields in range [i_begin, i_end) of a system to piece prefix_<index>_<piece>.vtu and returns the name
+    // of the file, e.g. to write the owned fields of each rank of a distributed system
+    template <typename system_t>
+    std::string write_piece(system_t const & system,    // system to write
+                            long index,                 // index of the dump
+                            int piece,                  // index of the piece
+                            long i_begin,               // index of the first field in the piece
+                            long i_end) const {         // index past the last field in the piece
+        const std::string file_name = piece_file_name(index, piece);
+        write_piece_file(system, file_name, i_begin, i_end);
+        return file_name;
+    }
+
+    // Writes the fields of a system split into n_pieces pieces on the OpenMP threads, and the .pvtu file that ties
+    // them together, returns the name of the .pvtu file
+    template <typename system_t>
+    std::string write_pieces(system_t const & system,   // system to write
+                             long index,                // index of the dump
+                             int n_pieces) const {      // number of pieces
+        const long n_part = (long) system.get_x().size();
+        bool failed = false;
+
+#pragma omp parallel for default(none) shared(system, index, n_pieces, n_part) reduction(||:failed) schedule(dynamic, 1)
+        for (int piece = 0; piece < n_pieces; piece ++) {
+            auto [i_begin, i_end] = static_partition(n_part, piece, n_pieces);
+
+            try {
+                write_piece(system, index, piece, i_begin, i_end);
+            } catch (OutputException const &) {
+                failed = true;
+            }
+        }
+
+        if (failed)
+            throw OutputException("vtu_writer::write_pieces");
+
+        return write_parallel_file(system, index, n_pieces);
+    }
+
+    // Writes prefix_<index>.pvtu that ties together pieces 0 to n_pieces - 1 and returns the name of the file
+    // With a distributed system, one rank calls this after every rank has written its piece
+    template <typename system_t>
+    std::string write_parallel_file(system_t const & system [[maybe_unused]],  // system that was written
+                                    long index,                                 // index of the dump
+                                    int n_pieces) const {                       // number of pieces
+        const std::string file_name = prefix + "_" + std::to_string(index) + ".pvtu";
+        std::ofstream ofs(directory + "/" + file_name);
+
+        if (!ofs.good())
+            throw OutputException("vtu_writer::write_parallel_file");
+
+        ofs << "<?xml version=\"1.0\"?>\n";
+        ofs << "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\"" << byte_order() << "\" header_type=\"UInt64\">\n";
+        ofs << "  <PUnstructuredGrid GhostLevel=\"0\">\n";
+        ofs << "    <PPointData>\n";
+        for (auto const & name : point_data_names<system_t>())
+            ofs << "      <PDataArray type=\"" << real_type_name() << "\" Name=\"" << name << "\" NumberOfComponents=\"" << n_components << "\"/>\n";
+        ofs << "    </PPointData>\n";
+        ofs << "    <PPoints>\n";
+        ofs << "      <PDataArray type=\"" << real_type_name() << "\" NumberOfComponents=\"3\"/>\n";
+        ofs << "    </PPoints>\n";
+        for (int piece = 0; piece < n_pieces; piece ++)
+            ofs << "    <Piece Source=\"" << piece_file_name(index, piece) << "\"/>\n";
+        ofs << "  </PUnstructuredGrid>\n";
+        ofs << "</VTKFile>\n";
+
+        if (!ofs.good())
+            throw OutputException("vtu_writer::write_parallel_file");
+
+        return file_name;
+    }
+
+private:
+    static constexpr long n_components = long(sizeof(field_value_t) / sizeof(real_t));
+
+    // Size of the blocks that are compressed separately
+    static constexpr long compression_block_size = 1l << 20;
+
+    // Array in the appended data section, either a view of memory or an owned buffer
+    struct appended_array {
+        std::string element;                    // XML element of the array without the offset
+        char const * data;                      // uncompressed data
+        long n_bytes;                           // size of the uncompressed data
+        std::vector<std::uint64_t> header;      // header that precedes the data
+        std::vector<char> compressed;           // compressed blocks
+    };
+
+    // Writes one .vtu file with the fields in range [i_begin, i_end)
+    template <typename system_t>
+    void write_piece_file(system_t const & system, std::string const & file_name, long i_begin, long i_end) const {
+        const long n_points = i_end - i_begin;
+        std::vector<appended_array> arrays;
+
+        // Points must have 3 components
+        std::vector<real_t> padded_points;
+        if constexpr (n_components == 3) {
+            arrays.emplace_back(make_array("<DataArray type=\"" + real_type_name() + "\" NumberOfComponents=\"3\" format=\"appended\"",
+                                           system.get_x().data() + i_begin, n_points * sizeof(field_value_t)));
+        } else {
+            padded_points.resize(3 * n_points, real_t(0));
+            for (long i = 0; i < n_points; i ++) {
+                auto const * values = reinterpret_cast<real_t const *>(system.get_x().data() + i_begin + i);
+                std::copy(values, values + n_components, padded_points.begin() + 3 * i);
+            }
+            arrays.emplace_back(make_array("<DataArray type=\"" + real_type_name() + "\" NumberOfComponents=\"3\" format=\"appended\"",
+                                           padded_points.data(), long(padded_points.size() * sizeof(real_t))));
+        }
+
+        // Point data
+        std::vector<field_container_t const *> point_data = {&system.get_v()};
+        if constexpr (requires { system.get_theta(); }) {
+            point_data.emplace_back(&system.get_theta());
+            point_data.emplace_back(&system.get_omega());
+        }
+
+        const auto names = point_data_names<system_t>();
+        for (long k = 0; k < (long) point_data.size(); k ++) {
+            arrays.emplace_back(make_array("<DataArray type=\"" + real_type_name() + "\" Name=\"" + names[k] + "\" NumberOfComponents=\""
+                                           + std::to_string(n_components) + "\" format=\"appended\"",
+                                           point_data[k]->data() + i_begin, n_points * sizeof(field_value_t)));
+        }
+
+        // The fields are points without cells
+        arrays.emplace_back(make_array("<DataArray type=\"Int64\" Name=\"connectivity\" format=\"appended\"", nullptr, 0));
+        arrays.emplace_back(make_array("<DataArray type=\"Int64\" Name=\"offsets\" format=\"appended\"", nullptr, 0));
+        arrays.emplace_back(make_array("<DataArray type=\"UInt8\" Name=\"types\" format=\"appended\"", nullptr, 0));
+
+        // Offsets of the arrays from the start of the appended data
+        std::vector<long> offsets;
+        long offset = 0;
+        for (auto const & array : arrays) {
+            offsets.emplace_back(offset);
+            offset += long(array.header.size() * sizeof(std::uint64_t)) + (compression == vtu_compression::none ? array.n_bytes : (long) array.compressed.size());
+        }
+
+        std::ofstream ofs(directory + "/" + file_name, std::ios::binary);
+
+        if (!ofs.good())
+            throw OutputException("vtu_writer::write");
+
+        ofs << "<?xml version=\"1.0\"?>\n";
+        ofs << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"" << byte_order() << "\" header_type=\"UInt64\"";
+        if (compression == vtu_compression::zlib)
+            ofs << " compressor=\"vtkZLibDataCompressor\"";
+        ofs << ">\n";
+        ofs << "  <UnstructuredGrid>\n";
+        ofs << "    <Piece NumberOfPoints=\"" << n_points << "\" NumberOfCells=\"0\">\n";
+        ofs << "      <PointData>\n";
+        for (long k = 1; k < 1 + (long) point_data.size(); k ++)
+            ofs << "        " << arrays[k].element << " offset=\"" << offsets[k] << "\"/>\n";
+        ofs << "      </PointData>\n";
+        ofs << "      <Points>\n";
+        ofs << "        " << arrays[0].element << " offset=\"" << offsets[0] << "\"/>\n";
+        ofs << "      </Points>\n";
+        ofs << "      <Cells>\n";
+        for (long k = 1 + (long) point_data.size(); k < (long) arrays.size(); k ++)
+            ofs << "        " << arrays[k].element << " offset=\"" << offsets[k] << "\"/>\n";
+        ofs << "      </Cells>\n";
+        ofs << "    </Piece>\n";
+        ofs << "  </UnstructuredGrid>\n";
+        ofs << "  <AppendedData encoding=\"raw\">\n_";
+
+        for (auto const & array : arrays) {
+            ofs.write(reinterpret_cast<char const *>(array.header.data()), std::streamsize(array.header.size() * sizeof(std::uint64_t)));
+            if (compression == vtu_compression::none)
+                ofs.write(array.data, array.n_bytes);
+            else
+                ofs.write(array.compressed.data(), std::streamsize(array.compressed.size()));
+        }
+
+        ofs << "\n  </AppendedData>\n";
+        ofs << "</VTKFile>\n";
+
+        if (!ofs.good())
+            throw OutputException("vtu_writer::write");
+    }
+
+    // Prepares the header (and the compressed blocks) of an array
+    appended_array make_array(std::string element, void const * data, long n_bytes) const {
+        appended_array array {std::move(element), static_cast<char const *>(data), n_bytes, {}, {}};
+
+        if (compression == vtu_compression::none) {
+            array.header = {std::uint64_t(n_bytes)};
+            return array;
+        }
+
+#ifdef LIBTIMESTEP_ZLIB
+        // Header of vtkZLibDataCompressor: number of blocks, block size, size of the last block, compressed block sizes
+        const long n_blocks = (n_bytes + compression_block_size - 1) / compression_block_size;
+        const long last_block_size = n_bytes - (n_blocks - 1) * compression_block_size;
+        array.header = {std::uint64_t(n_blocks), std::uint64_t(compression_block_size), std::uint64_t(n_blocks > 0 ? last_block_size : 0)};
+
+        for (long block = 0; block < n_blocks; block ++) {
+            const long block_size = block == n_blocks - 1 ? last_block_size : compression_block_size;
+            uLongf compressed_size = compressBound(uLong(block_size));
+
+            const long begin = (long) array.compressed.size();
+            array.compressed.resize(begin + compressed_size);
+            if (compress2(reinterpret_cast<Bytef *>(array.compressed.data() + begin), &compressed_size,
+                          reinterpret_cast<Bytef const *>(array.data + block * compression_block_size), uLong(block_size), Z_DEFAULT_COMPRESSION) != Z_OK)
+                throw OutputException("vtu_writer::write (zlib)");
+
+            array.compressed.resize(begin + compressed_size);
+            array.header.emplace_back(compressed_size);
+        }
+#endif
+
+        return array;
+    }
+
+    // Names of the point data arrays of a system
+    template <typename system_t>
+    static std::vector<std::string> point_data_names() {
+        if constexpr (requires (system_t const & system) { system.get_theta(); })
+            return {"v", "theta", "omega"};
+        else
+            return {"v"};
+    }
+
+    [[nodiscard]] std::string piece_file_name(long index, int piece) const {
+        return prefix + "_" + std::to_string(index) + "_" + std::to_string(piece) + ".vtu";
+    }
+
+    static std::string real_type_name() {
+        return sizeof(real_t) == 4 ? "Float32" : "Float64";
+    }
+
+    static std::string byte_order() {
+        return std::endian::native == std::endian::little ? "LittleEndian" : "BigEndian";
+    }
+
+    const std::string directory, prefix;
+    const vtu_compression compression;
+};
+
+#endif //INTEGRATORS_VTU_WRITER_H
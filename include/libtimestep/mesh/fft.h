@@ -0,0 +1,79 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_FFT_H
+#define INTEGRATORS_FFT_H
+
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <utility>
+
+// Returns true if n is a positive power of two
+inline bool is_power_of_two(long n) {
+    return n > 0 && (n & (n - 1)) == 0;
+}
+
+// In-place radix-2 fast Fourier transform of n complex values, n must be a power of two
+// The forward transform uses exp(-i k x), the inverse transform uses exp(i k x) and is not normalized
+template <typename real_t>
+void fft(std::complex<real_t> * data,   // values that are transformed
+         long n,                        // number of values
+         bool inverse) {                // compute the inverse transform
+    // Bit reversal permutation
+    for (long i = 1, j = 0; i < n; i ++) {
+        long bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+
+        if (i < j)
+            std::swap(data[i], data[j]);
+    }
+
+    // Butterflies
+    for (long length = 2; length <= n; length <<= 1) {
+        const real_t angle = real_t(inverse ? 2.0 : -2.0) * real_t(M_PI) / real_t(length);
+
+        for (long k = 0; k < length / 2; k ++) {
+            const std::complex<real_t> twiddle = std::polar(real_t(1.0), angle * real_t(k));
+
+            for (long i = k; i < n; i += length) {
+                const std::complex<real_t> even = data[i];
+                const std::complex<real_t> odd = data[i + length / 2] * twiddle;
+
+                data[i] = even + odd;
+                data[i + length / 2] = even - odd;
+            }
+        }
+    }
+}
+
+// In-place fast Fourier transform of a cubic grid of n^3 complex values stored with the last index varying fastest
+// Along each axis, the n^2 lines of the grid are split between the threads
+// This is a collective call if it is made from inside of a parallel region
+template <typename real_t>
+void fft_3d(std::vector<std::complex<real_t>> & grid,   // values that are transformed
+            long n,                                     // number of grid points along each axis, a power of two
+            bool inverse) {                             // compute the inverse transform
+    std::vector<std::complex<real_t>> line(n);
+
+    for (long stride : {1l, n, n * n}) {
+#pragma omp for schedule(static)
+        for (long l = 0; l < n * n; l ++) {
+            // First value of line l of the grid along the axis with this stride
+            const long first = stride == 1 ? l * n : (l / stride) * stride * n + l % stride;
+
+            for (long m = 0; m < n; m ++)
+                line[m] = grid[first + m * stride];
+
+            fft(line.data(), n, inverse);
+
+            for (long m = 0; m < n; m ++)
+                grid[first + m * stride] = line[m];
+        }
+    }
+}
+
+#endif //INTEGRATORS_FFT_H
@@ -0,0 +1,216 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_PARTICLE_MESH_H
+#define INTEGRATORS_PARTICLE_MESH_H
+
+#include <vector>
+#include <array>
+#include <complex>
+#include <cmath>
+
+#include "fft.h"
+#include "../exception/exception.h"
+
+// Particle-particle particle-mesh (P3M) solver for Coulomb-like interactions in a periodic cubic box
+// The 1/r interaction is split into a short range part erfc(alpha r)/r, which is computed exactly between neighbors
+// with compute_short_range_field(), and a smooth long range part, which is computed on the mesh by solve() and
+// interpolated to the fields with get_field()
+// solve() assigns the weights to the mesh with the cloud-in-cell scheme, solves the Poisson equation with a fast Fourier
+// transform, differentiates the potential in Fourier space, and transforms the three components of the field back
+//
+// Notes:
+// field_value_t must be a three-dimensional vector that implements operator[] and norm() (e.g. Eigen::Vector3d)
+// The field at x_i is sum_j w_j (x_i - x_j) / |x_i - x_j|^3 over all periodic images, so weights of the same sign repel
+// (the acceleration of field i is its charge over its mass times the field, negative weights give attraction)
+// The mean weight is neutralized by a uniform background
+// The mesh resolves the long range part if alpha h is below about 1, h being the mesh spacing
+template <typename field_value_t, typename real_t>
+class particle_mesh {
+public:
+    typedef std::vector<field_value_t> field_container_t;
+
+    // Class constructor
+    particle_mesh(long n_mesh,              // number of mesh points along each axis, a power of two
+                  real_t box_length,        // side of the periodic box
+                  real_t alpha) :           // splitting parameter, the short range part decays as erfc(alpha r)
+            n_mesh(n_mesh), box_length(box_length), alpha(alpha), spacing(box_length / real_t(n_mesh)),
+            density(n_mesh * n_mesh * n_mesh), density_hat(n_mesh * n_mesh * n_mesh), influence(n_mesh * n_mesh * n_mesh) {
+
+        if (!is_power_of_two(n_mesh))
+            throw MeshSizeException("particle_mesh constructor");
+
+        for (auto & component : field)
+            component.resize(n_mesh * n_mesh * n_mesh);
+
+        compute_influence_function();
+    }
+
+    // Computes the long range field on the mesh from the positions and the weights of the fields
+    // This is a collective call if it is made from inside of a parallel region
+    void solve(field_container_t const & x,             // positions of the fields
+               std::vector<real_t> const & weights) {   // weights (charges) of the fields
+        const long n_points = n_mesh * n_mesh * n_mesh;
+        const long n_fields = (long) x.size();
+        const real_t cell_volume = spacing * spacing * spacing;
+
+#pragma omp for schedule(static)
+        for (long m = 0; m < n_points; m ++)
+            density[m] = 0.0;
+
+        // Cloud-in-cell assignment, fields of different threads may share mesh points
+#pragma omp for schedule(static)
+        for (long i = 0; i < n_fields; i ++) {
+            std::array<long, 3> lower;
+            std::array<real_t, 3> fraction;
+            locate(x[i], lower, fraction);
+
+            for (int corner = 0; corner < 8; corner ++) {
+                const auto [m, weight] = corner_weight(lower, fraction, corner);
+
+#pragma omp atomic
+                density[m] += weights[i] * weight / cell_volume;
+            }
+        }
+
+#pragma omp for schedule(static)
+        for (long m = 0; m < n_points; m ++)
+            density_hat[m] = density[m];
+
+        fft_3d(density_hat, n_mesh, false);
+
+        // The field is minus the gradient of the potential, -i k phi(k)
+#pragma omp for schedule(static)
+        for (long m = 0; m < n_points; m ++) {
+            const std::array<long, 3> index = {m / (n_mesh * n_mesh), (m / n_mesh) % n_mesh, m % n_mesh};
+            const std::complex<real_t> potential = density_hat[m] * influence[m];
+
+            for (int d = 0; d < 3; d ++)
+                field[d][m] = std::complex<real_t>(0.0, -derivative_wavenumber(index[d])) * potential;
+        }
+
+        for (auto & component : field)
+            fft_3d(component, n_mesh, true);
+    }
+
+    // Interpolates the long range field computed in the last solve() to a position
+    [[nodiscard]] field_value_t get_field(field_value_t const & position) const {
+        field_value_t value = position * real_t(0);
+
+        std::array<long, 3> lower;
+        std::array<real_t, 3> fraction;
+        locate(position, lower, fraction);
+
+        for (int corner = 0; corner < 8; corner ++) {
+            const auto [m, weight] = corner_weight(lower, fraction, corner);
+
+            for (int d = 0; d < 3; d ++)
+                value[d] += weight * field[d][m].real();
+        }
+
+        return value;
+    }
+
+    // Computes the short range field at x_i of a unit weight at x_j, distance is the minimum image of x_i - x_j
+    [[nodiscard]] field_value_t compute_short_range_field(field_value_t const & distance) const {
+        const real_t r = distance.norm();
+        const real_t factor = std::erfc(alpha * r) + real_t(2.0) * alpha * r / std::sqrt(real_t(M_PI)) * std::exp(-alpha * alpha * r * r);
+
+        return distance * (factor / (r * r * r));
+    }
+
+    // Returns the periodic image of a distance vector that is shortest
+    [[nodiscard]] field_value_t minimum_image(field_value_t distance) const {
+        for (int d = 0; d < 3; d ++)
+            distance[d] -= box_length * std::round(distance[d] / box_length);
+
+        return distance;
+    }
+
+    // Returns the distance beyond which the short range part is below tolerance times the full interaction
+    [[nodiscard]] real_t get_cutoff(real_t tolerance /* relative magnitude of the neglected short range part */) const {
+        real_t r = spacing / 8.0;
+        while (std::erfc(alpha * r) + real_t(2.0) * alpha * r / std::sqrt(real_t(M_PI)) * std::exp(-alpha * alpha * r * r) > tolerance)
+            r += spacing / 8.0;
+
+        return r;
+    }
+
+private:
+    // Finds the lowest mesh point of the cell that contains a position, and the fractional position inside of the cell
+    void locate(field_value_t const & position, std::array<long, 3> & lower, std::array<real_t, 3> & fraction) const {
+        for (int d = 0; d < 3; d ++) {
+            real_t scaled = real_t(position[d]) / spacing;
+            scaled -= real_t(n_mesh) * std::floor(scaled / real_t(n_mesh));
+
+            lower[d] = std::min(long(scaled), n_mesh - 1);
+            fraction[d] = scaled - real_t(lower[d]);
+        }
+    }
+
+    // Returns the index of a corner (0 to 7) of the cell of a position and its cloud-in-cell weight
+    [[nodiscard]] std::pair<long, real_t> corner_weight(std::array<long, 3> const & lower,
+                                                        std::array<real_t, 3> const & fraction,
+                                                        int corner) const {
+        long m = 0;
+        real_t weight = 1.0;
+
+        for (int d = 0; d < 3; d ++) {
+            const bool upper = (corner >> (2 - d)) & 1;
+            m = m * n_mesh + (lower[d] + (upper ? 1 : 0)) % n_mesh;
+            weight *= upper ? fraction[d] : real_t(1.0) - fraction[d];
+        }
+
+        return std::make_pair(m, weight);
+    }
+
+    // Wavenumber of mesh index m along one axis
+    [[nodiscard]] real_t wavenumber(long m) const {
+        return real_t(2.0) * real_t(M_PI) / box_length * real_t(m < n_mesh / 2 ? m : m - n_mesh);
+    }
+
+    // Wavenumber used for differentiation, the Nyquist mode has no well defined derivative
+    [[nodiscard]] real_t derivative_wavenumber(long m) const {
+        return m == n_mesh / 2 ? real_t(0.0) : wavenumber(m);
+    }
+
+    // Computes the Fourier space Green function of the long range part, divided by the square of the transform of the
+    // cloud-in-cell window (once for the assignment and once for the interpolation), and by the size of the inverse transform
+    void compute_influence_function() {
+        const long n_points = n_mesh * n_mesh * n_mesh;
+
+        for (long m = 0; m < n_points; m ++) {
+            const std::array<long, 3> index = {m / (n_mesh * n_mesh), (m / n_mesh) % n_mesh, m % n_mesh};
+
+            real_t k_squared = 0.0, window = 1.0;
+            for (int d = 0; d < 3; d ++) {
+                const real_t k = wavenumber(index[d]);
+                const real_t half_phase = k * spacing / real_t(2.0);
+                const real_t sinc = half_phase == 0.0 ? real_t(1.0) : std::sin(half_phase) / half_phase;
+
+                k_squared += k * k;
+                window *= sinc * sinc;
+            }
+
+            // The mean weight is neutralized
+            if (m == 0) {
+                influence[m] = 0.0;
+                continue;
+            }
+
+            influence[m] = real_t(4.0) * real_t(M_PI) * std::exp(-k_squared / (real_t(4.0) * alpha * alpha))
+                    / (k_squared * window * window * real_t(n_points));
+        }
+    }
+
+    const long n_mesh;
+    const real_t box_length, alpha, spacing;
+
+    std::vector<real_t> density;
+    std::vector<std::complex<real_t>> density_hat;
+    std::vector<real_t> influence;
+    std::array<std::vector<std::complex<real_t>>, 3> field;
+};
+
+#endif //INTEGRATORS_PARTICLE_MESH_H
@@ -0,0 +1,184 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_RANDOM_PACKING_H
+#define INTEGRATORS_RANDOM_PACKING_H
+
+#include <vector>
+#include <array>
+#include <numeric>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+#include "../exception/exception.h"
+
+// Returns the side of a cubic box in which spheres with the given radii occupy the given volume fraction
+template <typename real_t>
+real_t packing_box_length(std::vector<real_t> const & radii,    // radii of the spheres
+                          real_t packing_fraction) {            // fraction of the volume of the box occupied by the spheres
+    real_t volume = 0;
+    for (real_t r : radii)
+        volume += real_t(4.0 * M_PI / 3.0) * r * r * r;
+    return std::cbrt(volume / packing_fraction);
+}
+
+// Returns a uniformly distributed number in [0, 1) that only depends on the seed, the particle, and the counter
+// (splitmix64 is used as a counter based generator, so that the numbers do not depend on the order in which the
+// particles are placed, nor on the number of threads)
+inline double packing_uniform(std::uint64_t seed, std::uint64_t particle, std::uint64_t counter) {
+    auto mix = [] (std::uint64_t z) {
+        z += 0x9e3779b97f4a7c15ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    };
+    return double(mix(mix(seed ^ mix(particle)) + counter) >> 11) * 0x1.0p-53;
+}
+
+// Places spheres with the given radii at random, without overlaps, with their centers in the box [box_min, box_max]
+// (random sequential addition) and returns their positions in the order of the radii
+// Each candidate position is only checked against the spheres in the neighboring cells of a grid with cells at least
+// as wide as the largest sphere, so a packing of N spheres costs O(N) instead of O(N^2)
+// The spheres are placed from the largest to the smallest. The grid is split into blocks, every block gets an equal
+// share of the spheres, and the blocks are filled in parallel: in 8 phases, of which each fills blocks that are
+// not adjacent to each other, so that the spheres of one phase cannot overlap. The few spheres that do not fit into
+// their block are then placed anywhere in the box
+//
+// Notes:
+// field_value_t must be a three-dimensional vector that implements operator[] and norm() (e.g. Eigen::Vector3d)
+// The positions only depend on the radii, the box, and the seed, not on the number of threads
+// Random sequential addition jams at a volume fraction of about 0.38 for equal spheres, a PackingException is thrown
+// if a sphere fits neither into its block nor into the box in max_attempts attempts each
+template <typename field_value_t, typename real_t>
+std::vector<field_value_t> random_packing(std::vector<real_t> const & radii,   // radii of the spheres
+                                          field_value_t const & box_min,      // lower corner of the box
+                                          field_value_t const & box_max,      // upper corner of the box
+                                          std::uint64_t seed,                 // seed, the same seed gives the same packing
+                                          long max_attempts = 10000) {        // number of candidates tried for each sphere
+    const long n = (long) radii.size();
+    std::vector<field_value_t> x(n);
+    if (n == 0)
+        return x;
+
+    const real_t r_max = *std::max_element(radii.begin(), radii.end());
+
+    // The cells are no narrower than the largest sphere, and there are no more cells than about twice the spheres
+    real_t volume = 1;
+    for (long d = 0; d < 3; d ++)
+        volume *= box_max[d] - box_min[d];
+    if (!(volume > 0))
+        throw PackingException("random_packing (empty box)");
+
+    const real_t cell_width = std::max(real_t(2) * r_max, std::cbrt(volume / real_t(2 * n)));
+
+    // Each block is cells_per_block[d] cells wide, the number of cells is rounded down so that all blocks are equal
+    std::array<long, 3> n_cells {}, n_blocks {}, cells_per_block {};
+    std::array<real_t, 3> cell_size {};
+    for (long d = 0; d < 3; d ++) {
+        const real_t extent = box_max[d] - box_min[d];
+        const long max_cells = std::max(1l, long(extent / cell_width));
+        n_blocks[d] = std::max(1l, max_cells / 4);
+        cells_per_block[d] = max_cells / n_blocks[d];
+        n_cells[d] = n_blocks[d] * cells_per_block[d];
+        cell_size[d] = extent / real_t(n_cells[d]);
+    }
+
+    std::vector<std::vector<long>> cells(n_cells[0] * n_cells[1] * n_cells[2]);
+    auto cell_index = [&n_cells] (std::array<long, 3> const & cell) {
+        return (cell[2] * n_cells[1] + cell[1]) * n_cells[0] + cell[0];
+    };
+
+    // The spheres are dealt to the blocks in the order of decreasing radius
+    std::vector<long> order(n);
+    std::iota(order.begin(), order.end(), 0l);
+    std::stable_sort(order.begin(), order.end(), [&radii] (long i, long j) { return radii[i] > radii[j]; });
+
+    const long n_blocks_total = n_blocks[0] * n_blocks[1] * n_blocks[2];
+    std::array<std::vector<long>, 8> blocks_of_color;
+    for (long b = 0; b < n_blocks_total; b ++) {
+        const long bx = b % n_blocks[0], by = b / n_blocks[0] % n_blocks[1], bz = b / (n_blocks[0] * n_blocks[1]);
+        blocks_of_color[(bx % 2) + 2 * (by % 2) + 4 * (bz % 2)].emplace_back(b);
+    }
+
+    // Tries to place the sphere i in the cells [first_cell, last_cell) with the attempts [first_attempt, last_attempt),
+    // returns false if all attempts failed
+    auto place = [&] (long i,
+                      std::array<long, 3> const & first_cell, std::array<long, 3> const & last_cell,
+                      long first_attempt, long last_attempt) -> bool {
+        for (long attempt = first_attempt; attempt < last_attempt; attempt ++) {
+            field_value_t candidate = box_min;
+            std::array<long, 3> cell {};
+            for (long d = 0; d < 3; d ++) {
+                const real_t u = real_t(packing_uniform(seed, i, 3 * attempt + d));
+                candidate[d] = box_min[d] + (real_t(first_cell[d]) + u * real_t(last_cell[d] - first_cell[d])) * cell_size[d];
+                cell[d] = std::clamp(long((candidate[d] - box_min[d]) / cell_size[d]), first_cell[d], last_cell[d] - 1);
+            }
+
+            bool overlap = false;
+            std::array<long, 3> neighbor {};
+            for (neighbor[2] = std::max(cell[2] - 1, 0l); neighbor[2] <= std::min(cell[2] + 1, n_cells[2] - 1) && !overlap; neighbor[2] ++) {
+                for (neighbor[1] = std::max(cell[1] - 1, 0l); neighbor[1] <= std::min(cell[1] + 1, n_cells[1] - 1) && !overlap; neighbor[1] ++) {
+                    for (neighbor[0] = std::max(cell[0] - 1, 0l); neighbor[0] <= std::min(cell[0] + 1, n_cells[0] - 1) && !overlap; neighbor[0] ++) {
+                        for (long j : cells[cell_index(neighbor)]) {
+                            if ((x[j] - candidate).norm() <= radii[i] + radii[j]) {
+                                overlap = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (!overlap) {
+                x[i] = candidate;
+                cells[cell_index(cell)].emplace_back(i);
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // In every round, each block places up to batch_size spheres, so that large spheres are placed early in all blocks
+    // A sphere that does not fit into its block is left for a serial pass over the whole box, which evens out the
+    // random differences between the blocks
+    const long batch_size = 16;
+    const long n_rounds = (n + n_blocks_total * batch_size - 1) / (n_blocks_total * batch_size);
+    std::vector<std::vector<long>> left_over(n_blocks_total);
+
+#pragma omp parallel default(none) shared(n, n_rounds, batch_size, n_blocks, n_blocks_total, cells_per_block, blocks_of_color, order, left_over, max_attempts, place)
+    {
+        for (long round = 0; round < n_rounds; round ++) {
+            for (auto const & blocks : blocks_of_color) {
+#pragma omp for schedule(dynamic, 4)
+                for (long k = 0; k < (long) blocks.size(); k ++) {
+                    const long b = blocks[k];
+                    const std::array<long, 3> block {b % n_blocks[0], b / n_blocks[0] % n_blocks[1], b / (n_blocks[0] * n_blocks[1])};
+                    const std::array<long, 3> first_cell {block[0] * cells_per_block[0], block[1] * cells_per_block[1], block[2] * cells_per_block[2]};
+                    const std::array<long, 3> last_cell {first_cell[0] + cells_per_block[0], first_cell[1] + cells_per_block[1], first_cell[2] + cells_per_block[2]};
+
+                    for (long m = round * batch_size; m < (round + 1) * batch_size && m * n_blocks_total + b < n; m ++) {
+                        const long rank = m * n_blocks_total + b;
+                        if (!place(order[rank], first_cell, last_cell, 0, max_attempts))
+                            left_over[b].emplace_back(rank);
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<long> left_over_ranks;
+    for (auto const & ranks : left_over)
+        left_over_ranks.insert(left_over_ranks.end(), ranks.begin(), ranks.end());
+    std::sort(left_over_ranks.begin(), left_over_ranks.end());
+
+    for (long rank : left_over_ranks) {
+        if (!place(order[rank], {0, 0, 0}, n_cells, max_attempts, 2 * max_attempts))
+            throw PackingException("random_packing");
+    }
+
+    return x;
+}
+
+#endif //INTEGRATORS_RANDOM_PACKING_H
@@ -0,0 +1,114 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_NUMA_H
+#define INTEGRATORS_NUMA_H
+
+#include <vector>
+#include <algorithm>
+
+#include "partition.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+// Creates a container of n elements and writes value to every element from the thread that owns it
+// according to thread_partition(n), so on a NUMA machine each page is placed on the memory node of the thread
+// that will use it in the compute loops
+//
+// Notes:
+// The pages are only placed by this function if the default constructor of the value type
+// does not write to memory (for example fixed-size Eigen vectors), otherwise the constructing thread touches them first
+template <typename container_t>
+container_t first_touch_buffer(long n,                                                  // number of elements
+                               typename container_t::value_type const & value) {        // value that every element is set to
+    container_t buffer(n);
+
+    #pragma omp parallel default(none) shared(buffer, n, value)
+    {
+        auto [i_begin, i_end] = thread_partition(n);
+        std::fill(buffer.begin() + i_begin, buffer.begin() + i_end, value);
+    }
+
+    return buffer;
+}
+
+// Creates a copy of the source container, the elements of which are written by the threads that own them
+// according to thread_partition(n) (see first_touch_buffer)
+template <typename container_t>
+container_t first_touch_copy(container_t const & source /* container to copy */) {
+    const long n = (long) source.size();
+    container_t buffer(n);
+
+    #pragma omp parallel default(none) shared(buffer, source, n)
+    {
+        auto [i_begin, i_end] = thread_partition(n);
+        std::copy(source.begin() + i_begin, source.begin() + i_end, buffer.begin() + i_begin);
+    }
+
+    return buffer;
+}
+
+// Policy used to pin OpenMP threads to the cores available to the process
+enum class thread_affinity {
+    none,       // threads may run on any available core
+    compact,    // thread n is pinned to available core n, so threads fill one socket before using the next one
+    spread      // threads are spread evenly over the available cores, so they are split between the sockets
+};
+
+// Pins the threads of the OpenMP thread pool according to the affinity policy
+// The pool is reused by all subsequent parallel regions with the same number of threads,
+// so this only needs to be called once, before the systems are created
+// Returns false if pinning is not supported on this platform or if it failed
+inline bool pin_threads(thread_affinity affinity /* pinning policy */) {
+#if defined(__linux__) && defined(_OPENMP)
+    // Cores available to the process are only queried once, before any thread has been pinned
+    static const std::vector<int> available_cores = [] () {
+        std::vector<int> cores;
+        cpu_set_t available;
+        CPU_ZERO(&available);
+        if (sched_getaffinity(0, sizeof(available), &available) == 0) {
+            for (int core = 0; core < CPU_SETSIZE; core ++) {
+                if (CPU_ISSET(core, &available))
+                    cores.emplace_back(core);
+            }
+        }
+        return cores;
+    } ();
+
+    if (available_cores.empty())
+        return false;
+
+    bool success = true;
+
+    #pragma omp parallel default(none) shared(affinity, available_cores) reduction(&&:success)
+    {
+        const long n_cores = (long) available_cores.size();
+        const long thread_num = omp_get_thread_num();
+        const long num_threads = omp_get_num_threads();
+
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+
+        if (affinity == thread_affinity::none) {
+            for (int core : available_cores)
+                CPU_SET(core, &mask);
+        } else if (affinity == thread_affinity::compact) {
+            CPU_SET(available_cores[thread_num % n_cores], &mask);
+        } else {
+            CPU_SET(available_cores[(thread_num * n_cores / num_threads) % n_cores], &mask);
+        }
+
+        // On Linux, pid 0 refers to the calling thread
+        success = sched_setaffinity(0, sizeof(mask), &mask) == 0;
+    }
+
+    return success;
+#else
+    return affinity == thread_affinity::none;
+#endif
+}
+
+#endif //INTEGRATORS_NUMA_H
@@ -0,0 +1,149 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_PARALLEL_THRESHOLDS_H
+#define INTEGRATORS_PARALLEL_THRESHOLDS_H
+
+#include <cmath>
+#include <cerrno>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Amount of work above which the systems switch from serial to parallel execution
+// Below both thresholds the cost of starting the threads is higher than the work that they would share
+struct parallel_thresholds {
+    long min_particles;     // number of particles at which per-particle loops are worth running in parallel
+    long min_pairs;         // number of pair interactions at which force loops are worth running in parallel
+
+    // Returns true if a loop over n_particles particles with n_pairs pair interactions should run in parallel
+    [[nodiscard]] bool admit(long n_particles, long n_pairs) const {
+        return n_particles >= min_particles || n_pairs >= min_pairs;
+    }
+};
+
+// Measures the cost of a parallel region and of representative per-particle and per-pair work,
+// and returns the amount of work at which the time saved by sharing it between threads exceeds the cost of the region
+// Without OpenMP, or with a single thread available, the thresholds are never reached
+inline parallel_thresholds calibrate_parallel_thresholds() {
+    constexpr long never = std::numeric_limits<long>::max();
+
+#ifdef _OPENMP
+    const int num_threads = omp_get_max_threads();
+    if (num_threads < 2)
+        return {never, never};
+
+    // The first parallel region starts the threads, it should not be included in the measurement
+    #pragma omp parallel default(none)
+    {}
+
+    const int n_regions = 64;
+    double start_time = omp_get_wtime();
+    for (int n = 0; n < n_regions; n ++) {
+        #pragma omp parallel default(none)
+        {}
+    }
+    const double region_cost = (omp_get_wtime() - start_time) / n_regions;
+
+    // Representative work: 3D positions of a small cluster of particles
+    const long n_probe = 128;
+    std::vector<double> probe_x(3 * n_probe), probe_a(3 * n_probe, 0.0);
+    for (long i = 0; i < 3 * n_probe; i ++)
+        probe_x[i] = std::sin(double(i));
+
+    // Pair interaction - distance, normalization, and accumulation of the result
+    start_time = omp_get_wtime();
+    for (long i = 0; i < n_probe; i ++) {
+        for (long j = 0; j < n_probe; j ++) {
+            double dx = probe_x[3 * j] - probe_x[3 * i];
+            double dy = probe_x[3 * j + 1] - probe_x[3 * i + 1];
+            double dz = probe_x[3 * j + 2] - probe_x[3 * i + 2];
+            double r = std::sqrt(dx * dx + dy * dy + dz * dz) + 1.0;
+            probe_a[3 * i] += dx / r;
+            probe_a[3 * i + 1] += dy / r;
+            probe_a[3 * i + 2] += dz / r;
+        }
+    }
+    const double pair_cost = (omp_get_wtime() - start_time) / double(n_probe * n_probe);
+
+    // Particle update - position and velocity increments
+    const long n_sweeps = 64;
+    start_time = omp_get_wtime();
+    for (long n = 0; n < n_sweeps; n ++) {
+        for (long i = 0; i < 3 * n_probe; i ++) {
+            probe_a[i] += 1e-3 * probe_x[i];
+            probe_x[i] += 1e-3 * probe_a[i];
+        }
+    }
+    const double particle_cost = (omp_get_wtime() - start_time) / double(n_sweeps * n_probe);
+
+    // Keep the probe from being optimized away
+    double probe_sum = 0.0;
+    for (long i = 0; i < 3 * n_probe; i ++)
+        probe_sum += probe_x[i] + probe_a[i];
+    volatile double sink = probe_sum;
+    (void) sink;
+
+    // Sharing n units of work of cost c between p threads saves n * c * (1 - 1 / p)
+    const double efficiency = 1.0 - 1.0 / double(num_threads);
+    auto threshold = [region_cost, efficiency, never] (double unit_cost) -> long {
+        if (unit_cost <= 0.0)
+            return never;
+        double n = std::ceil(region_cost / (unit_cost * efficiency));
+        return n < double(never) ? long(n) : never;
+    };
+
+    return {threshold(particle_cost), threshold(pair_cost)};
+#else
+    return {never, never};
+#endif
+}
+
+// Reads a threshold from the value of an environment variable into threshold and returns true if it is valid,
+// i.e. a non-negative decimal number with nothing after it, otherwise threshold is left unchanged
+inline bool parse_parallel_threshold(char const * value,    // value of the environment variable, or nullptr if it is not set
+                                     long & threshold) {    // threshold that receives the value
+    if (value == nullptr || *value < '0' || *value > '9')
+        return false;
+
+    char * end = nullptr;
+    errno = 0;
+    const long parsed = std::strtol(value, &end, 10);
+    if (errno == ERANGE || *end != '\0')
+        return false;
+
+    threshold = parsed;
+    return true;
+}
+
+// Returns the process-wide thresholds that newly created systems start with
+// They are calibrated on the first call and cached, unless LIBTIMESTEP_PARALLEL_MIN_PARTICLES and
+// LIBTIMESTEP_PARALLEL_MIN_PAIRS environment variables are set
+// Values of the variables that are not non-negative numbers are ignored, and the calibrated thresholds are used instead
+// The returned reference can be assigned to in order to override the thresholds for all systems created afterwards
+inline parallel_thresholds & default_parallel_thresholds() {
+    static parallel_thresholds thresholds = [] () -> parallel_thresholds {
+        parallel_thresholds overrides {};
+        const bool have_min_particles = parse_parallel_threshold(std::getenv("LIBTIMESTEP_PARALLEL_MIN_PARTICLES"), overrides.min_particles);
+        const bool have_min_pairs = parse_parallel_threshold(std::getenv("LIBTIMESTEP_PARALLEL_MIN_PAIRS"), overrides.min_pairs);
+
+        if (have_min_particles && have_min_pairs)
+            return overrides;
+
+        parallel_thresholds calibrated = calibrate_parallel_thresholds();
+        if (have_min_particles)
+            calibrated.min_particles = overrides.min_particles;
+        if (have_min_pairs)
+            calibrated.min_pairs = overrides.min_pairs;
+        return calibrated;
+    } ();
+
+    return thresholds;
+}
+
+#endif //INTEGRATORS_PARALLEL_THRESHOLDS_H
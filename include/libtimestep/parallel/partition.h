@@ -0,0 +1,41 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_PARTITION_H
+#define INTEGRATORS_PARTITION_H
+
+#include <utility>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Splits n items into num_threads contiguous ranges and returns the range [begin, end) owned by thread thread_num
+// The split is the same as the one used by OpenMP static scheduling without a chunk size
+inline std::pair<long, long> static_partition(long n,               // total number of items
+                                              int thread_num,       // index of the thread
+                                              int num_threads) {    // number of threads in the team
+    long chunk = n / num_threads;
+    long remainder = n % num_threads;
+
+    long begin = thread_num * chunk + std::min<long>(thread_num, remainder);
+    long end = begin + chunk + (thread_num < remainder ? 1 : 0);
+
+    return std::make_pair(begin, end);
+}
+
+// Returns the range [begin, end) of items owned by the calling thread of the innermost parallel region
+// A thread always gets the same range for the same n, so all phases of a time step that use this
+// partition touch the same particles on the same thread
+// Outside of a parallel region (or when compiled without OpenMP) the calling thread owns all n items
+inline std::pair<long, long> thread_partition(long n /* total number of items */) {
+#ifdef _OPENMP
+    return static_partition(n, omp_get_thread_num(), omp_get_num_threads());
+#else
+    return std::make_pair(0l, n);
+#endif
+}
+
+#endif //INTEGRATORS_PARTITION_H
@@ -0,0 +1,121 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_REDUCTION_H
+#define INTEGRATORS_REDUCTION_H
+
+#include <vector>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Diagnostics of a particle system that an acceleration handler can reduce in the force loop (see fused_reduction)
+// Sums and maxima are combined separately, so every member can be accumulated by any thread in any order
+//
+// Notes:
+// field_value_t must implement Zero() (e.g. Eigen::Vector3d)
+template <typename field_value_t, typename real_t>
+struct particle_diagnostics {
+    real_t kinetic_energy = 0;                                  // sum of m v^2 / 2
+    real_t rotational_energy = 0;                               // sum of I omega^2 / 2
+    real_t potential_energy = 0;                                // sum of the potential energies of the interactions
+    field_value_t linear_momentum = field_value_t::Zero();      // sum of m v
+    field_value_t angular_momentum = field_value_t::Zero();     // sum of I omega + x cross m v
+    real_t max_speed = 0;                                       // largest |v|
+    real_t max_overlap = 0;                                     // largest overlap of two particles in contact
+
+    // Adds the partial result of another thread
+    void combine(particle_diagnostics const & other) {
+        kinetic_energy += other.kinetic_energy;
+        rotational_energy += other.rotational_energy;
+        potential_energy += other.potential_energy;
+        linear_momentum += other.linear_momentum;
+        angular_momentum += other.angular_momentum;
+        max_speed = std::max(max_speed, other.max_speed);
+        max_overlap = std::max(max_overlap, other.max_overlap);
+    }
+};
+
+// Placeholder for the partial result of a force loop without a reduction
+struct no_reduction {};
+
+// Reduction that the parallel systems compute in their force loop, so that diagnostics cost no extra pass over the fields
+// Every thread accumulates the fields and pairs of its own range into a partial result, and the partial results are
+// combined in the order of the threads after the force loop
+//
+// The acceleration handler owns the reduction and registers it with get_reduction(), and adds the contributions of the
+// fields and of the pairs to the partial result of the thread with
+// reduce(i, x, v, t, partial) and reduce(i, j, x, v, t, partial) (both optional), or in rotational systems with
+// reduce(i, x, v, theta, omega, t, partial) and reduce(i, j, x, v, theta, omega, t, partial)
+// Every pair is visited from both of its fields, so e.g. a pair potential energy is added as half from each side
+//
+// Notes:
+// reduction_t must be default constructible to the identity of the reduction and implement combine(reduction_t const &)
+// The partitions of the force loop are static, so the result is the same from run to run with the same number of threads
+template <typename _reduction_t>
+class fused_reduction {
+public:
+    typedef _reduction_t reduction_t;
+
+    // Computes the reduction in the next force computation only
+    void request() {
+        requested = true;
+    }
+
+    // Computes the reduction in every force computation, or stops doing so
+    void enable(bool enabled /* true to compute the reduction in every force computation */) {
+        this->enabled = enabled;
+    }
+
+    // Returns true if the next force computation computes the reduction
+    [[nodiscard]] bool is_active() const {
+        return requested || enabled;
+    }
+
+    // Combines the partial results of all threads of the force loop, called by every thread of the parallel region
+    // (or by the only thread outside of a parallel region) after its range of the force loop
+    void combine(reduction_t const & partial /* partial result of the calling thread */) {
+#ifdef _OPENMP
+        const int thread_num = omp_get_thread_num(), num_threads = omp_get_num_threads();
+#else
+        const int thread_num = 0, num_threads = 1;
+#endif
+
+#pragma omp single
+        partials.resize(num_threads);
+
+        partials[thread_num] = partial;
+
+#pragma omp barrier
+#pragma omp single
+        {
+            result = reduction_t();
+            for (auto const & thread_partial : partials)
+                result.combine(thread_partial);
+
+            requested = false;
+            n_computed ++;
+        }
+    }
+
+    // Getter for the result of the last force computation that computed the reduction
+    [[nodiscard]] reduction_t const & get_result() const {
+        return result;
+    }
+
+    // Getter for the number of force computations that computed the reduction so far
+    [[nodiscard]] long get_n_computed() const {
+        return n_computed;
+    }
+
+private:
+    bool requested = false, enabled = false;
+    long n_computed = 0;
+    std::vector<reduction_t> partials;
+    reduction_t result;
+};
+
+#endif //INTEGRATORS_REDUCTION_H
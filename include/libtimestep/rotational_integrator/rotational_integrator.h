@@ -50,6 +50,12 @@ public:
                       "field_container_t must be a container of values of type field_value_t");
     }
 
+    // Visits the time with an archive, derived integrators add their own state (see io/checkpoint.h)
+    template <typename archive_t>
+    void serialize(archive_t & archive) {
+        archive(this->t);
+    }
+
 protected:
     // This method should be called by any derived class when translational and angular accelerations need to be recomputed
     void update_acceleration() const {
@@ -65,6 +71,13 @@ protected:
                                    theta_begin_const_itr, omega_begin_const_itr, this->alpha_begin_itr, this->t);
     }
 
+    // This method should be called by partitioned integrators from inside of a parallel region
+    // when translational and angular accelerations of the fields in range [i_begin, i_end) need to be recomputed
+    void update_acceleration(long i_begin,      // index of the first field in the range
+                             long i_end) const {    // index past the last field in the range
+        this->acceleration_functor(i_begin, i_end, this->t);
+    }
+
     real_t t;
     typename field_container_t::iterator x_begin_itr, x_end_itr, v_begin_itr, a_begin_itr,
                             theta_begin_itr, omega_begin_itr, alpha_begin_itr;
@@ -74,5 +87,9 @@ protected:
 
 #include "rotational_forward_euler.h"
 #include "rotational_velocity_verlet_half.h"
+#include "rotational_velocity_verlet_half_omp.h"
+#include "rotational_gear_predictor_corrector.h"
+#include "rotational_respa_velocity_verlet.h"
+#include "rotational_symplectic_composition.h"
 
 #endif //INTEGRATORS_ROTATIONAL_INTEGRATOR_H
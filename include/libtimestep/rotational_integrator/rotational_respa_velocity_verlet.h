@@ -0,0 +1,150 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_ROTATIONAL_RESPA_VELOCITY_VERLET_H
+#define INTEGRATORS_ROTATIONAL_RESPA_VELOCITY_VERLET_H
+
+#include "../integrator/respa_functor_pair.h"
+#include "../exception/exception.h"
+
+// Integrator template that implements the same multiple time step scheme as respa_velocity_verlet (for rotating systems)
+// Angular velocities are kicked and angles are drifted together with velocities and positions
+//
+// Notes:
+// The acceleration functor must compute the slow translational and angular accelerations in operator() and must implement
+// compute_fast_accelerations() with the same arguments, which writes the fast accelerations to the buffers it is given
+// (respa_functor_pair combines two separate functors into one)
+// The a and alpha buffers hold the slow accelerations, the fast accelerations are kept in buffers of the integrator
+template <
+    typename field_container_t,
+    typename field_value_t,
+    typename real_t,
+    typename functor_t,
+    template <
+        typename _field_container_t,
+        typename _field_value_t>
+    typename step_handler_t>
+class rotational_respa_velocity_verlet : public rotational_integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t> {
+public:
+
+    // Class constructor
+    //
+    // Notes:
+    // Iterators passed to this constructor must remain valid for the duration of use of this integrator
+    // x, v, a, theta, omega, and alpha buffers must be of the same size
+    // The acceleration functor and the step handler must exist for the duration of use of this integrator
+    rotational_respa_velocity_verlet(functor_t & acceleration_functor,                                      // reference to a functor that computes slow and fast accelerations
+                                     real_t t0,                                                             // integration start time
+                                     typename field_container_t::iterator x_begin,                          // iterator pointing to the start of the x buffer
+                                     typename field_container_t::iterator x_end,                            // iterator pointing to the end of the x buffer
+                                     typename field_container_t::iterator v_begin,                          // iterator pointing to the start of the v buffer
+                                     typename field_container_t::iterator a_begin,                          // iterator pointing to the start of the a buffer
+                                     typename field_container_t::iterator theta_begin,                      // iterator pointing to the start of the theta buffer
+                                     typename field_container_t::iterator omega_begin,                      // iterator pointing to the start of the omega buffer
+                                     typename field_container_t::iterator alpha_begin,                      // iterator pointing to the start of the alpha buffer
+                                     step_handler_t<field_container_t, field_value_t> & step_handler) :     // reference to an object that handles incrementing positions and velocities
+
+        // Call the superclass constructor
+        rotational_integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t>(acceleration_functor, t0,
+           x_begin, x_end, v_begin, a_begin, theta_begin, omega_begin, alpha_begin, step_handler),
+           a_fast(x_end - x_begin), alpha_fast(x_end - x_begin) {}
+
+    // Sets the number of fast substeps in every slow step
+    // Throws InvalidArgumentException if the number of substeps is smaller than one
+    void set_substeps(long new_n_substeps /* number of substeps */) {
+        if (new_n_substeps < 1)
+            throw InvalidArgumentException("rotational_respa_velocity_verlet::set_substeps()");
+
+        this->n_substeps = new_n_substeps;
+    }
+
+    // Getter for the number of fast substeps in every slow step
+    [[nodiscard]] long get_substeps() const {
+        return this->n_substeps;
+    }
+
+    // Perform one time step
+    void do_step(real_t dt /*time step*/) {
+        const long n_part = this->x_end_itr - this->x_begin_itr;
+        const real_t t_start = this->t;
+        const real_t h = dt / real_t(n_substeps);
+
+        // If this is the first step, compute both parts of the accelerations from the initial condition
+        if (!accelerations_initialized) [[unlikely]] {
+            accelerations_initialized = true;
+
+            this->update_acceleration();
+            update_fast_acceleration();
+        }
+
+        // Half kick with the slow accelerations
+        slow_kick(dt / 2.0);
+
+        // Velocity Verlet substeps with the fast accelerations
+        for (long s = 0; s < n_substeps; s ++) {
+            for (long n = 0; n < n_part; n ++) {
+                field_value_t const & v = *(this->v_begin_itr + n);
+                field_value_t const & omega = *(this->omega_begin_itr + n);
+
+                this->step_handler.increment_v(n, a_fast[n] * h / 2.0, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr, this->theta_begin_itr, this->omega_begin_itr, this->alpha_begin_itr);
+                this->step_handler.increment_omega(n, alpha_fast[n] * h / 2.0, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr, this->theta_begin_itr, this->omega_begin_itr, this->alpha_begin_itr);
+                this->step_handler.increment_x(n, v * h, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr, this->theta_begin_itr, this->omega_begin_itr, this->alpha_begin_itr);
+                this->step_handler.increment_theta(n, omega * h, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr, this->theta_begin_itr, this->omega_begin_itr, this->alpha_begin_itr);
+            }
+
+            this->t = t_start + real_t(s + 1) * h;
+            update_fast_acceleration();
+
+            for (long n = 0; n < n_part; n ++) {
+                this->step_handler.increment_v(n, a_fast[n] * h / 2.0, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr, this->theta_begin_itr, this->omega_begin_itr, this->alpha_begin_itr);
+                this->step_handler.increment_omega(n, alpha_fast[n] * h / 2.0, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr, this->theta_begin_itr, this->omega_begin_itr, this->alpha_begin_itr);
+            }
+        }
+
+        // Half kick with the slow accelerations at the new positions
+        this->t = t_start + dt;
+        this->update_acceleration();
+
+        slow_kick(dt / 2.0);
+    }
+
+    // Visits the time and the fast translational and angular accelerations with an archive
+    template <typename archive_t>
+    void serialize(archive_t & archive) {
+        rotational_integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t>::serialize(archive);
+        archive(accelerations_initialized);
+        archive(a_fast);
+        archive(alpha_fast);
+    }
+
+private:
+    // Increments velocities and angular velocities with the slow accelerations over time interval tau
+    void slow_kick(real_t tau /* kick duration */) {
+        for (long n = 0; n < this->x_end_itr - this->x_begin_itr; n ++) {
+            field_value_t const & a = *(this->a_begin_itr + n);
+            field_value_t const & alpha = *(this->alpha_begin_itr + n);
+
+            this->step_handler.increment_v(n, a * tau, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr, this->theta_begin_itr, this->omega_begin_itr, this->alpha_begin_itr);
+            this->step_handler.increment_omega(n, alpha * tau, this->x_begin_itr, this->v_begin_itr, this->a_begin_itr, this->theta_begin_itr, this->omega_begin_itr, this->alpha_begin_itr);
+        }
+    }
+
+    // Recomputes the fast translational and angular accelerations
+    void update_fast_acceleration() {
+        typename field_container_t::const_iterator x_begin_const_itr = this->x_begin_itr;
+        typename field_container_t::const_iterator x_end_const_itr = this->x_end_itr;
+        typename field_container_t::const_iterator v_begin_const_itr = this->v_begin_itr;
+        typename field_container_t::const_iterator theta_begin_const_itr = this->theta_begin_itr;
+        typename field_container_t::const_iterator omega_begin_const_itr = this->omega_begin_itr;
+
+        this->acceleration_functor.compute_fast_accelerations(x_begin_const_itr, x_end_const_itr, v_begin_const_itr, a_fast.begin(),
+                                                              theta_begin_const_itr, omega_begin_const_itr, alpha_fast.begin(), this->t);
+    }
+
+    long n_substeps = 1;
+    bool accelerations_initialized = false;
+    field_container_t a_fast, alpha_fast;
+};
+
+#endif //INTEGRATORS_ROTATIONAL_RESPA_VELOCITY_VERLET_H
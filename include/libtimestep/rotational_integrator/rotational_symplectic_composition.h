@@ -0,0 +1,144 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_ROTATIONAL_SYMPLECTIC_COMPOSITION_H
+#define INTEGRATORS_ROTATIONAL_SYMPLECTIC_COMPOSITION_H
+
+#include <utility>
+
+#include "../integrator/symplectic_coefficients.h"
+
+// Integrator template that implements the same splitting schemes as symplectic_composition (for rotating systems)
+// Angles are drifted together with positions and angular velocities are kicked together with velocities
+//
+// Notes:
+// Use the aliases below (rotational_forest_ruth, rotational_yoshida_4, rotational_omelyan_pefrl, rotational_omelyan_2)
+// as the integrator of a system
+template <
+    typename coefficients_t,
+    typename field_container_t,
+    typename field_value_t,
+    typename real_t,
+    typename functor_t,
+    template <
+        typename _field_container_t,
+        typename _field_value_t>
+    typename step_handler_t>
+class rotational_symplectic_composition : public rotational_integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t> {
+public:
+
+    // Class constructor
+    //
+    // Notes:
+    // Iterators passed to this constructor must remain valid for the duration of use of this integrator
+    // x, v, a, theta, omega, and alpha buffers must be of the same size
+    // The acceleration functor and the step handler must exist for the duration of use of this integrator
+    rotational_symplectic_composition(functor_t & acceleration_functor,                                     // reference to a functor that computes translational and angular accelerations
+                                      real_t t0,                                                            // integration start time
+                                      typename field_container_t::iterator x_begin,                         // iterator pointing to the start of the x buffer
+                                      typename field_container_t::iterator x_end,                           // iterator pointing to the end of the x buffer
+                                      typename field_container_t::iterator v_begin,                         // iterator pointing to the start of the v buffer
+                                      typename field_container_t::iterator a_begin,                         // iterator pointing to the start of the a buffer
+                                      typename field_container_t::iterator theta_begin,                     // iterator pointing to the start of the theta buffer
+                                      typename field_container_t::iterator omega_begin,                     // iterator pointing to the start of the omega buffer
+                                      typename field_container_t::iterator alpha_begin,                     // iterator pointing to the start of the alpha buffer
+                                      step_handler_t<field_container_t, field_value_t> & step_handler) :    // reference to an object that handles incrementing positions and velocities
+
+        // Call the superclass constructor
+        rotational_integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t>(acceleration_functor, t0,
+           x_begin, x_end, v_begin, a_begin, theta_begin, omega_begin, alpha_begin, step_handler) {}
+
+    // Perform one time step
+    void do_step(real_t dt /*time step*/) {
+        const real_t t_start = this->t;
+        real_t elapsed = 0;
+
+        do_stages(dt, t_start, elapsed, std::make_index_sequence<coefficients_t::kick.size()>());
+
+        drift<coefficients_t::kick.size()>(dt);
+        this->t = t_start + dt;
+    }
+
+    // Discards the accelerations kept from the last kick of the previous step
+    // Must be called if the fields are modified between time steps
+    void restart() {
+        this->accelerations_current = false;
+    }
+
+    // Visits the time and whether the accelerations are current with an archive
+    template <typename archive_t>
+    void serialize(archive_t & archive) {
+        rotational_integrator<field_container_t, field_value_t, real_t, functor_t, step_handler_t>::serialize(archive);
+        archive(accelerations_current);
+    }
+
+private:
+    // Performs the drift and the kick of every stage
+    template <size_t... stages>
+    void do_stages(real_t dt, real_t t_start, real_t & elapsed, std::index_sequence<stages...>) {
+        ((drift<stages>(dt), elapsed += real_t(coefficients_t::drift[stages]) * dt, kick<stages>(dt, t_start + elapsed)), ...);
+    }
+
+    // Increments positions and angles with the velocities and angular velocities over the drift of stage i
+    template <size_t i>
+    void drift(real_t dt) {
+        constexpr long double coefficient = coefficients_t::drift[i];
+
+        if constexpr (coefficient != 0) {
+            for (long n = 0; n < this->x_end_itr - this->x_begin_itr; n ++) {
+                field_value_t const & v = *(this->v_begin_itr + n);
+                field_value_t const & omega = *(this->omega_begin_itr + n);
+
+                this->step_handler.increment_x(n, v * (real_t(coefficient) * dt), this->x_begin_itr, this->v_begin_itr, this->a_begin_itr, this->theta_begin_itr, this->omega_begin_itr, this->alpha_begin_itr);
+                this->step_handler.increment_theta(n, omega * (real_t(coefficient) * dt), this->x_begin_itr, this->v_begin_itr, this->a_begin_itr, this->theta_begin_itr, this->omega_begin_itr, this->alpha_begin_itr);
+            }
+
+            accelerations_current = false;
+        }
+    }
+
+    // Increments velocities and angular velocities with the accelerations over the kick of stage i
+    template <size_t i>
+    void kick(real_t dt, real_t t_kick) {
+        constexpr long double coefficient = coefficients_t::kick[i];
+
+        if (!accelerations_current) {
+            this->t = t_kick;
+            this->update_acceleration();
+            accelerations_current = true;
+        }
+
+        for (long n = 0; n < this->x_end_itr - this->x_begin_itr; n ++) {
+            field_value_t const & a = *(this->a_begin_itr + n);
+            field_value_t const & alpha = *(this->alpha_begin_itr + n);
+
+            this->step_handler.increment_v(n, a * (real_t(coefficient) * dt), this->x_begin_itr, this->v_begin_itr, this->a_begin_itr, this->theta_begin_itr, this->omega_begin_itr, this->alpha_begin_itr);
+            this->step_handler.increment_omega(n, alpha * (real_t(coefficient) * dt), this->x_begin_itr, this->v_begin_itr, this->a_begin_itr, this->theta_begin_itr, this->omega_begin_itr, this->alpha_begin_itr);
+        }
+    }
+
+    bool accelerations_current = false;
+};
+
+// Fourth order scheme of Forest and Ruth
+template <typename field_container_t, typename field_value_t, typename real_t, typename functor_t,
+          template <typename _field_container_t, typename _field_value_t> typename step_handler_t>
+using rotational_forest_ruth = rotational_symplectic_composition<forest_ruth_coefficients, field_container_t, field_value_t, real_t, functor_t, step_handler_t>;
+
+// Fourth order composition of velocity Verlet steps of Yoshida
+template <typename field_container_t, typename field_value_t, typename real_t, typename functor_t,
+          template <typename _field_container_t, typename _field_value_t> typename step_handler_t>
+using rotational_yoshida_4 = rotational_symplectic_composition<yoshida_4_coefficients, field_container_t, field_value_t, real_t, functor_t, step_handler_t>;
+
+// Fourth order position extended Forest-Ruth like scheme of Omelyan, Mryglod, and Folk
+template <typename field_container_t, typename field_value_t, typename real_t, typename functor_t,
+          template <typename _field_container_t, typename _field_value_t> typename step_handler_t>
+using rotational_omelyan_pefrl = rotational_symplectic_composition<omelyan_pefrl_coefficients, field_container_t, field_value_t, real_t, functor_t, step_handler_t>;
+
+// Second order minimal error scheme of Omelyan, Mryglod, and Folk
+template <typename field_container_t, typename field_value_t, typename real_t, typename functor_t,
+          template <typename _field_container_t, typename _field_value_t> typename step_handler_t>
+using rotational_omelyan_2 = rotational_symplectic_composition<omelyan_2_coefficients, field_container_t, field_value_t, real_t, functor_t, step_handler_t>;
+
+#endif //INTEGRATORS_ROTATIONAL_SYMPLECTIC_COMPOSITION_H
@@ -68,7 +68,7 @@ public:
 
         this->reset_acceleration_buffers();
 
-        std::for_each(std::execution::par_unseq, this->indices.begin(), this->indices.end(), [t, this] (long i) {
+        auto compute_accelerations_of = [t, this] (long i) {
             std::for_each(this->indices.begin(), this->indices.end(), [t, i, this] (long j) {
                 if (i == j) [[unlikely]]
                     return;
@@ -85,7 +85,19 @@ public:
                 this->a[i] += a_i_new;
                 this->alpha[i] += alpha_i_new;
             }
-        });
+        };
+
+        // Small systems are cheaper to compute on the calling thread
+        if (use_parallel_execution())
+            std::for_each(std::execution::par_unseq, this->indices.begin(), this->indices.end(), compute_accelerations_of);
+        else
+            std::for_each(std::execution::seq, this->indices.begin(), this->indices.end(), compute_accelerations_of);
+    }
+
+    // Returns true if the force loop of this system is large enough to run in parallel
+    [[nodiscard]] bool use_parallel_execution() const {
+        const long n_part = (long) this->indices.size();
+        return this->thresholds.admit(n_part, n_part * (n_part - 1));
     }
 
 private:
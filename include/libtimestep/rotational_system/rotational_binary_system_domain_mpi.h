@@ -0,0 +1,224 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_ROTATIONAL_BINARY_SYSTEM_DOMAIN_MPI_H
+#define INTEGRATORS_ROTATIONAL_BINARY_SYSTEM_DOMAIN_MPI_H
+
+#include <vector>
+
+#include "rotational_system.h"
+#include "../parallel/partition.h"
+#include "../distributed/domain_decomposition.h"
+
+#include <omp.h>
+
+// This is a base class for a second order system where accelerations depend on binary
+// interactions between fields (for rotating systems), distributed between the ranks of an MPI communicator
+// The domain is split into slabs (see domain_decomposition), each rank integrates the fields inside of its slab
+// and computes their accelerations from neighbor lists that include the ghosts of the adjacent ranks
+//
+// Notes:
+// Indices passed to the acceleration handler refer to the buffers of this rank, which hold owned fields followed by ghosts
+// The buffers of this rank have a fixed capacity that has to hold the owned fields and the ghosts at any time
+// The integrator must call operator() with the full buffers (rotational_velocity_verlet_half or rotational_forward_euler),
+// the halo is exchanged at the start of every acceleration computation
+template <
+        typename field_value_t,
+        typename real_t,
+        template <
+        typename _field_container_t,
+        typename _field_value_t,
+        typename _real_t,
+        typename _functor_t,
+        template <
+        typename __field_container_t,
+        typename __field_value_t>
+        typename _step_handler_t>
+        typename integrator_t,
+        template <
+        typename _field_container_t,
+        typename _field_value_t>
+        typename step_handler_t,
+        typename acceleration_handler_t,
+        bool have_unary_force>
+class rotational_binary_system_domain_mpi : public rotational_generic_system<field_value_t, real_t, integrator_t, step_handler_t,
+        rotational_binary_system_domain_mpi<field_value_t, real_t, integrator_t, step_handler_t, acceleration_handler_t, have_unary_force>> {
+public:
+    typedef std::vector<field_value_t> field_container_t;
+    typedef std::vector<long> index_container_t;
+
+    rotational_binary_system_domain_mpi(rotational_binary_system_domain_mpi const &) = delete;
+
+    // Class constructor
+    //
+    // Notes:
+    // The acceleration handler and the step handler must exist for the duration of use of this second order system
+    // This class itself acts as the acceleration functor for the integrator
+    // Each rank passes any subset of the initial fields, they are moved to their owners by the constructor
+    // This is a collective call
+    rotational_binary_system_domain_mpi(MPI_Comm comm,                                                     // communicator of the ranks that share the domain
+                             long capacity,                                                     // number of field slots on this rank
+                             int axis,                                                          // axis along which the domain is split into slabs
+                             real_t r_verlet,
+                             field_container_t x0,                                              // container with initial positions of the fields held by this rank
+                             field_container_t v0,                                              // container with initial velocities of the fields held by this rank
+                             field_container_t theta0,                                          // container with initial angles of the fields held by this rank
+                             field_container_t omega0,                                          // container with initial angular velocities of the fields held by this rank
+                             real_t t0,                                                         // integration start time
+                             field_value_t field_zero,                                          // zero value of the primary field type used
+                             real_t real_zero,                                                  // zero value of the real number type used
+                             acceleration_handler_t & acceleration_handler,                     // reference to the object that handles calculating accelerations FOR EACH BINARY INTERACTION
+                             step_handler_t<field_container_t, field_value_t> & step_handler) : // reference to an object that handles incrementing positions and velocities
+
+    // Call the superclass constructor
+            rotational_generic_system<field_value_t, real_t, integrator_t, step_handler_t, rotational_binary_system_domain_mpi>(padded(x0, capacity, field_zero),
+                                                                                                    padded(v0, capacity, field_zero), padded(theta0, capacity, field_zero),
+                                                                                                    padded(omega0, capacity, field_zero), t0, field_zero, real_zero, *this, step_handler),
+            r_verlet(r_verlet),
+            acceleration_handler(acceleration_handler),
+            decomposition(comm, capacity, axis, r_verlet, (long) x0.size(), field_zero),
+            neighbor_list(capacity) {
+
+        if (x0.size() != v0.size() || x0.size() != theta0.size() || x0.size() != omega0.size())
+            throw SizeMismatchException("rotational_binary_system_domain_mpi(MPI_Comm, long, int, real_t, field_container_t, field_container_t, field_container_t, field_container_t, ...)");
+
+        rebalance();
+    }
+
+    // This method is called by the integrator to compute accelerations
+    void operator() (typename field_container_t::const_iterator x_begin [[maybe_unused]],
+                     typename field_container_t::const_iterator x_end [[maybe_unused]],
+                     typename field_container_t::const_iterator v_begin [[maybe_unused]],
+                     typename field_container_t::iterator a_begin [[maybe_unused]],
+                     typename field_container_t::const_iterator theta_begin [[maybe_unused]],
+                     typename field_container_t::const_iterator omega_begin [[maybe_unused]],
+                     typename field_container_t::iterator alpha_begin [[maybe_unused]],
+                     real_t t) {
+
+        decomposition.exchange_halo({&this->x, &this->v, &this->theta, &this->omega});
+
+        const long n_owned = decomposition.get_n_owned();
+
+#pragma omp parallel default(none) shared(t, n_owned) if(use_parallel_execution())
+        {
+            auto [i_begin, i_end] = thread_partition(n_owned);
+            compute_accelerations(i_begin, i_end, t);
+        }
+    }
+
+    // Returns true if the force loop of this rank is large enough to run in parallel
+    [[nodiscard]] bool use_parallel_execution() const {
+        const long n_owned = decomposition.get_n_owned();
+        if (n_owned >= this->thresholds.min_particles)
+            return true;
+
+        long n_pairs = 0;
+        for (long i = 0; i < n_owned; i ++)
+            n_pairs += (long) neighbor_list[i].size();
+
+        return this->thresholds.admit(n_owned, n_pairs);
+    }
+
+    // This method is called by the driver periodically to update the neighbor lists
+    // The owned fields are moved to the ranks whose slabs contain them and the ghosts are selected again
+    // This is a collective call, which must be made between time steps
+    void update_neighbor_list() {
+        decomposition.migrate({&this->x, &this->v, &this->a, &this->theta, &this->omega, &this->alpha});
+        decomposition.select_ghosts({&this->x, &this->v, &this->theta, &this->omega});
+
+        const long n_owned = decomposition.get_n_owned();
+
+#pragma omp parallel default(none) shared(n_owned) if(this->thresholds.admit(n_owned, n_owned * (n_owned - 1)))
+        {
+            auto [i_begin, i_end] = thread_partition(n_owned);
+            build_neighbor_list(i_begin, i_end);
+        }
+    }
+
+    // This method can be called by the driver between time steps to move the slab boundaries,
+    // so that every rank owns about the same number of fields, e.g. when the fields form clusters
+    // This is a collective call, it also updates the neighbor lists
+    void rebalance() {
+        decomposition.rebalance(this->x);
+        update_neighbor_list();
+    }
+
+    // Collects the values of the fields owned by all ranks on the root rank, ordered by global id
+    // This is a collective call, which returns an empty container on the other ranks
+    [[nodiscard]] field_container_t gather(field_container_t const & field,  // buffer of this system to collect (e.g. get_x())
+                                           int root = 0) const {            // rank that receives the values
+        return decomposition.gather(field, root);
+    }
+
+    // Getter for the number of fields owned by this rank, they occupy the first slots of the buffers
+    [[nodiscard]] long get_n_owned() const {
+        return decomposition.get_n_owned();
+    }
+
+    // Getter for the domain decomposition of this system
+    [[nodiscard]] domain_decomposition<field_value_t, real_t> const & get_decomposition() const {
+        return decomposition;
+    }
+
+private:
+    // Computes translational and angular accelerations of the owned fields in range [i_begin, i_end)
+    void compute_accelerations(long i_begin,    // index of the first field in the range
+                               long i_end,      // index past the last field in the range
+                               real_t t) {
+        std::fill(this->a.begin() + i_begin, this->a.begin() + i_end, this->field_zero);
+        std::fill(this->alpha.begin() + i_begin, this->alpha.begin() + i_end, this->field_zero);
+
+        for (long i = i_begin; i < i_end; i ++) {
+            for (long j : neighbor_list[i]) {
+                auto [a_i_new, alpha_i_new] = acceleration_handler.compute_accelerations(i, j, this->get_x(), this->get_v(), this->get_theta(), this->get_omega(), t);
+
+                this->a[i] += a_i_new;
+                this->alpha[i] += alpha_i_new;
+            }
+
+            if constexpr (have_unary_force) {
+                auto [a_i_new, alpha_i_new] = acceleration_handler.compute_accelerations(i, this->get_x(), this->get_v(), this->get_theta(), this->get_omega(), t);
+
+                this->a[i] += a_i_new;
+                this->alpha[i] += alpha_i_new;
+            }
+        }
+    }
+
+    // Builds the neighbor lists of the owned fields in range [i_begin, i_end) from owned fields and ghosts
+    void build_neighbor_list(long i_begin,      // index of the first field in the range
+                             long i_end) {      // index past the last field in the range
+        const long n_local = decomposition.get_n_owned() + decomposition.get_n_ghost();
+
+        for (long i = i_begin; i < i_end; i ++) {
+            neighbor_list[i].clear();
+
+            for (long j = 0; j < n_local; j ++) {
+                if (i == j)
+                    continue;
+
+                real_t distance = (this->x[i] - this->x[j]).norm();
+                if (distance < r_verlet)
+                    neighbor_list[i].emplace_back(j);
+            }
+        }
+    }
+
+    // Returns a copy of the field buffer extended with zeros to the capacity
+    static field_container_t padded(field_container_t const & field, long capacity, field_value_t const & field_zero) {
+        if ((long) field.size() > capacity)
+            throw CapacityExceededException("rotational_binary_system_domain_mpi(MPI_Comm, long, int, real_t, field_container_t, field_container_t, field_container_t, field_container_t, ...)");
+
+        field_container_t result(capacity, field_zero);
+        std::copy(field.begin(), field.end(), result.begin());
+        return result;
+    }
+
+    const real_t r_verlet;
+    acceleration_handler_t & acceleration_handler;
+    domain_decomposition<field_value_t, real_t> decomposition;
+    std::vector<std::vector<long>> neighbor_list;
+};
+
+#endif //INTEGRATORS_ROTATIONAL_BINARY_SYSTEM_DOMAIN_MPI_H
@@ -6,8 +6,14 @@
 #define INTEGRATORS_ROTATIONAL_BINARY_SYSTEM_NEIGHBORS_OMP_H
 
 #include <vector>
+#include <future>
+#include <chrono>
+#include <atomic>
+#include <type_traits>
 
 #include "rotational_system.h"
+#include "../parallel/partition.h"
+#include "../parallel/reduction.h"
 
 #include <omp.h>
 
@@ -45,6 +51,7 @@ public:
     // Notes:
     // The acceleration handler and the step handler must exist for the duration of use of this second order system
     // This class itself acts as the acceleration functor for the integrator
+    // If first_touch is true, the buffers are initialized in parallel with the same partitioning as the force loop
     rotational_binary_system_neighbors_omp(long n_part,
                                 real_t r_verlet,
                                 field_container_t x0,                                                 // container with initial positions
@@ -55,15 +62,21 @@ public:
                                 field_value_t field_zero,                                             // zero value of the primary field type used
                                 real_t real_zero,                                                     // zero value of the real number type used
                                 acceleration_handler_t & acceleration_handler,                        // reference to the object that handles calculating accelerations FOR EACH BINARY INTERACTION
-                                step_handler_t<field_container_t, field_value_t> & step_handler) :    // reference to an object that handles incrementing positions and velocities
+                                step_handler_t<field_container_t, field_value_t> & step_handler,      // reference to an object that handles incrementing positions and velocities
+                                bool first_touch = false) :                                           // initialize the field buffers in parallel (see generic_system)
 
     // Call the superclass constructor
             rotational_generic_system<field_value_t, real_t, integrator_t, step_handler_t, rotational_binary_system_neighbors_omp>(std::move(x0),
-                                                                                                             std::move(v0), std::move(theta0), std::move(omega0), t0, field_zero, real_zero, *this, step_handler),
+                                                                                                             std::move(v0), std::move(theta0), std::move(omega0), t0, field_zero, real_zero, *this, step_handler, first_touch),
             n_part(n_part),
             r_verlet(r_verlet),
             acceleration_handler(acceleration_handler),
-            neighbor_list(n_part) {}
+            neighbor_list(n_part) {
+
+        // The lists are allocated by the threads that own them in the force loop
+        if (first_touch)
+            update_neighbor_list();
+    }
 
     // This method is called by the integrator to compute accelerations
     void operator() (typename field_container_t::const_iterator x_begin [[maybe_unused]],
@@ -75,10 +88,235 @@ public:
                      typename field_container_t::iterator alpha_begin [[maybe_unused]],
                      real_t t) {
 
-        this->reset_acceleration_buffers();
+#pragma omp parallel default(none) shared(t) if(use_parallel_execution())
+        {
+            auto [i_begin, i_end] = thread_partition(n_part);
+            (*this)(i_begin, i_end, t);
+        }
+    }
+
+    // Returns true if the force loop of this system is large enough to run in parallel
+    [[nodiscard]] bool use_parallel_execution() const {
+        if (n_part >= this->thresholds.min_particles)
+            return true;
+
+        // The system is small, so counting the pairs is cheap
+        long n_pairs = 0;
+        for (auto const & neighbors : neighbor_list)
+            n_pairs += (long) neighbors.size();
+
+        return this->thresholds.admit(n_part, n_pairs);
+    }
+
+    // This method is called by partitioned integrators from inside of a parallel region
+    // It only computes translational and angular accelerations of the fields in range [i_begin, i_end)
+    void operator() (long i_begin,  // index of the first field in the range
+                     long i_end,    // index past the last field in the range
+                     real_t t) {
+
+        process_pending_neighbor_list_updates(i_begin, i_end);
+
+        std::fill(this->a.begin() + i_begin, this->a.begin() + i_end, this->field_zero);
+        std::fill(this->alpha.begin() + i_begin, this->alpha.begin() + i_end, this->field_zero);
+
+        // The reduction of the acceleration handler, if it is requested, is computed in the same pass (see fused_reduction)
+        if constexpr (requires { acceleration_handler.get_reduction(); }) {
+            auto & reduction = acceleration_handler.get_reduction();
+            if (reduction.is_active()) {
+                typename std::decay_t<decltype(reduction)>::reduction_t partial {};
+                compute_accelerations(i_begin, i_end, t, partial);
+                reduction.combine(partial);
+                return;
+            }
+        }
+
+        no_reduction partial;
+        compute_accelerations(i_begin, i_end, t, partial);
+    }
+
+    // This method is called by multiple time step integrators to compute the rapidly varying accelerations
+    // with compute_fast_accelerations() of the acceleration handler, which must not be included in compute_accelerations()
+    // The accelerations are written to the buffers starting at a_begin and alpha_begin
+    void compute_fast_accelerations(typename field_container_t::const_iterator x_begin [[maybe_unused]],
+                                    typename field_container_t::const_iterator x_end [[maybe_unused]],
+                                    typename field_container_t::const_iterator v_begin [[maybe_unused]],
+                                    typename field_container_t::iterator a_begin,
+                                    typename field_container_t::const_iterator theta_begin [[maybe_unused]],
+                                    typename field_container_t::const_iterator omega_begin [[maybe_unused]],
+                                    typename field_container_t::iterator alpha_begin,
+                                    real_t t) {
+
+#pragma omp parallel default(none) shared(a_begin, alpha_begin, t) if(use_parallel_execution())
+        {
+            auto [i_begin, i_end] = thread_partition(n_part);
+            process_pending_neighbor_list_updates(i_begin, i_end);
+
+            for (long i = i_begin; i < i_end; i ++) {
+                field_value_t a_i = this->field_zero;
+                field_value_t alpha_i = this->field_zero;
+
+                for (long j : neighbor_list[i]) {
+                    if (i == j) [[unlikely]]
+                        continue;
+
+                    auto [a_i_new, alpha_i_new] = acceleration_handler.compute_fast_accelerations(i, j, this->get_x(), this->get_v(), this->get_theta(), this->get_omega(), t);
+
+                    a_i += a_i_new;
+                    alpha_i += alpha_i_new;
+                }
+
+                *(a_begin + i) = a_i;
+                *(alpha_begin + i) = alpha_i;
+            }
+        }
+    }
+
+    // This method is called by the driver periodically to update the neighbor lists
+    // A background update in flight is discarded, its lists would be older than the ones built here
+    void update_neighbor_list() {
+        discard_neighbor_list_update();
+
+        // Every field is checked against every other field
+#pragma omp parallel default(none) if(this->thresholds.admit(n_part, n_part * (n_part - 1)))
+        {
+            auto [i_begin, i_end] = thread_partition(n_part);
+            update_neighbor_list(i_begin, i_end);
+        }
+
+        n_neighbor_list_updates ++;
+    }
+
+    // Updates the neighbor lists of the fields in range [i_begin, i_end) only
+    void update_neighbor_list(long i_begin,     // index of the first field in the range
+                              long i_end) {     // index past the last field in the range
+        build_neighbor_list(this->get_x(), neighbor_list, i_begin, i_end);
+
+        // Positions at the update are the reference for the displacement tracking
+        if (automatic_neighbor_list_updates)
+            std::copy(this->x.begin() + i_begin, this->x.begin() + i_end, x_at_update.begin() + i_begin);
+    }
+
+    // This method can be called by the driver instead of update_neighbor_list()
+    // The neighbor lists are then updated at the start of the next acceleration computation,
+    // inside of the same parallel region as the force loop
+    // A background update in flight is discarded, its lists would be older than the ones built then
+    void schedule_neighbor_list_update() {
+        discard_neighbor_list_update();
+        neighbor_list_update_scheduled = true;
+    }
+
+    // Enables neighbor list updates driven by the displacements of the fields, so that the driver does not need to
+    // update the lists at all
+    // The displacements since the last update are checked at the start of every force loop, over the same range of fields
+    // as the force loop, and the lists are updated in the same parallel region as soon as any field has moved by more
+    // than half of the skin (r_verlet minus the interaction range)
+    // The interaction range must be smaller than r_verlet, otherwise the skin is empty
+    void enable_automatic_neighbor_list_updates(real_t interaction_range /* largest distance at which two fields interact */) {
+        if (!(interaction_range < r_verlet))
+            throw InvalidArgumentException("rotational_binary_system_neighbors_omp::enable_automatic_neighbor_list_updates()");
+
+        automatic_neighbor_list_updates = true;
+        half_skin = (r_verlet - interaction_range) / 2.0;
+        x_at_update = this->get_x();
+
+        // The current lists may have been built before the fields were last moved
+        neighbor_list_update_scheduled = true;
+    }
+
+    // Disables the neighbor list updates driven by the displacements of the fields
+    void disable_automatic_neighbor_list_updates() {
+        automatic_neighbor_list_updates = false;
+    }
+
+    // Getter for the number of neighbor list updates done so far
+    [[nodiscard]] long get_n_neighbor_list_updates() const {
+        return n_neighbor_list_updates;
+    }
+
+    // Starts building the next neighbor lists in the background from a snapshot of the current positions
+    // Time stepping continues on the current lists until the new ones are swapped in, which happens at the start
+    // of the first acceleration computation after the background update completes, or in finish_neighbor_list_update()
+    //
+    // Notes:
+    // The current lists must remain valid until the swap, i.e. the skin (r_verlet minus the interaction range)
+    // must be larger than twice the displacement of any field during the update
+    // Must be called between time steps
+    void begin_neighbor_list_update(int n_threads = 1 /* number of threads that build the lists */) {
+        // Only one background update can be in flight at a time
+        finish_neighbor_list_update();
+
+        neighbor_list_snapshot = this->get_x();
+        neighbor_list_update_in_flight = true;
+
+        neighbor_list_update = std::async(std::launch::async, [this, n_threads] () {
+            build_next_neighbor_list(n_threads);
+        });
+    }
+
+    // Swaps the lists built in the background in if they are ready, returns true if they were swapped in
+    // Must be called between time steps
+    bool try_finish_neighbor_list_update() {
+        if (!neighbor_list_update.valid())
+            return false;
+
+        if (neighbor_list_update.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return false;
+
+        finish_neighbor_list_update();
+        return true;
+    }
+
+    // Waits for the background update to complete and swaps the new lists in
+    // Must be called between time steps
+    void finish_neighbor_list_update() {
+        if (!neighbor_list_update.valid())
+            return;
+
+        neighbor_list_update.get();
+        neighbor_list.swap(next_neighbor_list);
+        neighbor_list_update_in_flight = false;
+        n_neighbor_list_updates ++;
 
-#pragma omp parallel for default(none) shared(t)
-        for (long i = 0; i < n_part; i ++) {
+        if (automatic_neighbor_list_updates)
+            x_at_update = neighbor_list_snapshot;
+    }
+
+    // Waits for the background update to complete and drops the lists it built
+    void discard_neighbor_list_update() {
+        if (!neighbor_list_update.valid())
+            return;
+
+        neighbor_list_update.get();
+        neighbor_list_update_in_flight = false;
+    }
+
+    // Visits the state of this system with an archive, including the neighbor lists and the state of their updates
+    // A background update in flight is finished first, its lists are then part of the saved state
+    template <typename archive_t>
+    void serialize(archive_t & archive) {
+        finish_neighbor_list_update();
+
+        rotational_generic_system<field_value_t, real_t, integrator_t, step_handler_t,
+                rotational_binary_system_neighbors_omp<field_value_t, real_t, integrator_t, step_handler_t, acceleration_handler_t, have_unary_force>>::serialize(archive);
+        archive(neighbor_list);
+        archive(neighbor_list_update_scheduled);
+        archive(n_neighbor_list_updates);
+        archive(automatic_neighbor_list_updates);
+        archive(half_skin);
+        archive(x_at_update);
+    }
+
+private:
+    // Adds the translational and angular accelerations of the fields in range [i_begin, i_end), and their contributions
+    // to the partial result of the reduction of the acceleration handler unless partial_t is no_reduction
+    template <typename partial_t>
+    void compute_accelerations(long i_begin,            // index of the first field in the range
+                               long i_end,              // index past the last field in the range
+                               real_t t,                // time
+                               partial_t & partial) {   // partial result of the reduction of the calling thread
+        constexpr bool reduce = !std::is_same_v<partial_t, no_reduction>;
+
+        for (long i = i_begin; i < i_end; i ++) {
             for (long j : neighbor_list[i]) {
                 if (i == j) [[unlikely]]
                     continue;
@@ -87,6 +325,9 @@ public:
 
                 this->a[i] += a_i_new;
                 this->alpha[i] += alpha_i_new;
+
+                if constexpr (reduce && requires { acceleration_handler.reduce(i, j, this->get_x(), this->get_v(), this->get_theta(), this->get_omega(), t, partial); })
+                    acceleration_handler.reduce(i, j, this->get_x(), this->get_v(), this->get_theta(), this->get_omega(), t, partial);
             }
 
             if constexpr (have_unary_force) {
@@ -95,31 +336,110 @@ public:
                 this->a[i] += a_i_new;
                 this->alpha[i] += alpha_i_new;
             }
+
+            if constexpr (reduce && requires { acceleration_handler.reduce(i, this->get_x(), this->get_v(), this->get_theta(), this->get_omega(), t, partial); })
+                acceleration_handler.reduce(i, this->get_x(), this->get_v(), this->get_theta(), this->get_omega(), t, partial);
         }
     }
 
-    // This method is called by the driver periodically to update the neighbor lists
-    void update_neighbor_list() {
-#pragma omp parallel for default(none)
-        for (long i = 0; i < n_part; i ++) {
-            neighbor_list[i].clear();
+    // Handles pending neighbor list work at the start of the force loop, called from inside of a parallel region
+    void process_pending_neighbor_list_updates(long i_begin,    // index of the first field in the range
+                                               long i_end) {    // index past the last field in the range
+        // The displacements are checked by every thread in its range of the force loop
+        if (automatic_neighbor_list_updates) {
+            if (!neighbor_list_update_scheduled && exceeds_half_skin(i_begin, i_end))
+                displacement_exceeded.store(true, std::memory_order_relaxed);
+
+#pragma omp barrier
+        }
+
+        const bool update_needed = neighbor_list_update_scheduled || displacement_exceeded.load(std::memory_order_relaxed);
+
+        if (update_needed || neighbor_list_update_in_flight) {
+            // A scheduled update is done by the same thread that will use the lists in the force loop
+            if (update_needed)
+                update_neighbor_list(i_begin, i_end);
+
+            // Every thread has to see the flags before they are cleared
+#pragma omp barrier
+#pragma omp single
+            {
+                if (update_needed)
+                    n_neighbor_list_updates ++;
+
+                neighbor_list_update_scheduled = false;
+                displacement_exceeded.store(false, std::memory_order_relaxed);
+
+                // Lists built in the background are swapped in as soon as they are ready, unless the lists were
+                // just built from newer positions
+                if (neighbor_list_update_in_flight) {
+                    if (update_needed)
+                        discard_neighbor_list_update();
+                    else
+                        try_finish_neighbor_list_update();
+                }
+            }
+        }
+    }
+
+    // Returns true if any field in range [i_begin, i_end) has moved by more than half of the skin since the last update
+    [[nodiscard]] bool exceeds_half_skin(long i_begin,          // index of the first field in the range
+                                         long i_end) const {    // index past the last field in the range
+        for (long i = i_begin; i < i_end; i ++) {
+            if ((this->x[i] - x_at_update[i]).norm() > half_skin)
+                return true;
+        }
+
+        return false;
+    }
+
+    // Builds the neighbor lists of the fields in range [i_begin, i_end) from the given positions
+    void build_neighbor_list(field_container_t const & positions,           // positions of all fields
+                             std::vector<std::vector<long>> & lists,        // lists that are built
+                             long i_begin,                                  // index of the first field in the range
+                             long i_end) const {                            // index past the last field in the range
+        for (long i = i_begin; i < i_end; i ++) {
+            lists[i].clear();
 
             for (long j = 0; j < n_part; j ++) {
                 if (i == j)
                     continue;
 
-                real_t distance = (this->get_x()[i] - this->get_x()[j]).norm();
+                real_t distance = (positions[i] - positions[j]).norm();
                 if (distance < r_verlet)
-                    neighbor_list[i].emplace_back(j);
+                    lists[i].emplace_back(j);
             }
         }
     }
 
-private:
+    // Builds the next neighbor lists from the position snapshot, runs in the background
+    void build_next_neighbor_list(int n_threads /* number of threads that build the lists */) {
+#pragma omp parallel default(none) num_threads(n_threads)
+        {
+            auto [i_begin, i_end] = thread_partition(n_part);
+            build_neighbor_list(neighbor_list_snapshot, next_neighbor_list, i_begin, i_end);
+        }
+    }
+
     const long n_part;
     const double r_verlet;
     acceleration_handler_t & acceleration_handler;
     std::vector<std::vector<long>> neighbor_list;
+    bool neighbor_list_update_scheduled = false;
+    long n_neighbor_list_updates = 0;
+
+    // State of the neighbor list updates driven by the displacements
+    bool automatic_neighbor_list_updates = false;
+    real_t half_skin = 0.0;
+    field_container_t x_at_update;
+    std::atomic<bool> displacement_exceeded = false;
+
+    // State of the background neighbor list update
+    // The future is declared last, so it is destroyed (and waited for) before the buffers it writes to
+    std::vector<std::vector<long>> next_neighbor_list = std::vector<std::vector<long>>(n_part);
+    field_container_t neighbor_list_snapshot;
+    bool neighbor_list_update_in_flight = false;
+    std::future<void> neighbor_list_update;
 };
 
 #endif //INTEGRATORS_ROTATIONAL_BINARY_SYSTEM_NEIGHBORS_OMP_H
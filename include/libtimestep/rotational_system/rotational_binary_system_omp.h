@@ -5,7 +5,11 @@
 #ifndef INTEGRATORS_ROTATIONAL_BINARY_SYSTEM_OMP_H
 #define INTEGRATORS_ROTATIONAL_BINARY_SYSTEM_OMP_H
 
+#include <type_traits>
+
 #include "rotational_system.h"
+#include "../parallel/partition.h"
+#include "../parallel/reduction.h"
 
 #include <omp.h>
 
@@ -41,6 +45,7 @@ public:
     // Notes:
     // The acceleration handler and the step handler must exist for the duration of use of this second order system
     // This class itself acts as the acceleration functor for the integrator
+    // If first_touch is true, the buffers are initialized in parallel with the same partitioning as the force loop
     rotational_binary_system_omp(field_container_t x0,                                              // container with initial positions
                              field_container_t v0,                                              // container with initial velocities
                              field_container_t theta0,                                          // container with initial angles
@@ -49,11 +54,12 @@ public:
                              field_value_t field_zero,                                          // zero value of the primary field type used
                              real_t real_zero,                                                  // zero value of the real number type used
                              acceleration_handler_t & acceleration_handler,                     // reference to the object that handles calculating accelerations FOR EACH BINARY INTERACTION
-                             step_handler_t<field_container_t, field_value_t> & step_handler) : // reference to an object that handles incrementing positions and velocities
+                             step_handler_t<field_container_t, field_value_t> & step_handler,   // reference to an object that handles incrementing positions and velocities
+                             bool first_touch = false) :                                        // initialize the field buffers in parallel (see generic_system)
 
          // Call the superclass constructor
          rotational_generic_system<field_value_t, real_t, integrator_t, step_handler_t, rotational_binary_system_omp>(
-            std::move(x0), std::move(v0), std::move(theta0), std::move(omega0), t0, field_zero, real_zero, *this, step_handler),
+            std::move(x0), std::move(v0), std::move(theta0), std::move(omega0), t0, field_zero, real_zero, *this, step_handler, first_touch),
             acceleration_handler(acceleration_handler) {}
 
     // This method is called by the integrator to compute accelerations
@@ -66,10 +72,92 @@ public:
                      typename field_container_t::iterator alpha_begin [[maybe_unused]],
                      real_t t) {
 
-        this->reset_acceleration_buffers();
+        #pragma omp parallel default(none) shared(t) if(use_parallel_execution())
+        {
+            auto [i_begin, i_end] = thread_partition((long) this->indices.size());
+            (*this)(i_begin, i_end, t);
+        }
+    }
+
+    // Returns true if the force loop of this system is large enough to run in parallel
+    [[nodiscard]] bool use_parallel_execution() const {
+        const long n_part = (long) this->indices.size();
+        return this->thresholds.admit(n_part, n_part * (n_part - 1));
+    }
+
+    // This method is called by partitioned integrators from inside of a parallel region
+    // It only computes translational and angular accelerations of the fields in range [i_begin, i_end)
+    void operator() (long i_begin,  // index of the first field in the range
+                     long i_end,    // index past the last field in the range
+                     real_t t) {
+
+        std::fill(this->a.begin() + i_begin, this->a.begin() + i_end, this->field_zero);
+        std::fill(this->alpha.begin() + i_begin, this->alpha.begin() + i_end, this->field_zero);
+
+        // The reduction of the acceleration handler, if it is requested, is computed in the same pass (see fused_reduction)
+        if constexpr (requires { acceleration_handler.get_reduction(); }) {
+            auto & reduction = acceleration_handler.get_reduction();
+            if (reduction.is_active()) {
+                typename std::decay_t<decltype(reduction)>::reduction_t partial {};
+                compute_accelerations(i_begin, i_end, t, partial);
+                reduction.combine(partial);
+                return;
+            }
+        }
+
+        no_reduction partial;
+        compute_accelerations(i_begin, i_end, t, partial);
+    }
+
+    // This method is called by multiple time step integrators to compute the rapidly varying accelerations
+    // with compute_fast_accelerations() of the acceleration handler, which must not be included in compute_accelerations()
+    // The accelerations are written to the buffers starting at a_begin and alpha_begin
+    void compute_fast_accelerations(typename field_container_t::const_iterator x_begin [[maybe_unused]],
+                                    typename field_container_t::const_iterator x_end [[maybe_unused]],
+                                    typename field_container_t::const_iterator v_begin [[maybe_unused]],
+                                    typename field_container_t::iterator a_begin,
+                                    typename field_container_t::const_iterator theta_begin [[maybe_unused]],
+                                    typename field_container_t::const_iterator omega_begin [[maybe_unused]],
+                                    typename field_container_t::iterator alpha_begin,
+                                    real_t t) {
+
+        const long n_part = (long) this->indices.size();
 
-        #pragma omp parallel for default(none) shared(t)
-        for (long i = 0; i < (long) this->indices.size(); i ++) {
+        #pragma omp parallel default(none) shared(a_begin, alpha_begin, t, n_part) if(use_parallel_execution())
+        {
+            auto [i_begin, i_end] = thread_partition(n_part);
+
+            for (long i = i_begin; i < i_end; i ++) {
+                field_value_t a_i = this->field_zero;
+                field_value_t alpha_i = this->field_zero;
+
+                for (long j = 0; j < n_part; j ++) {
+                    if (i == j) [[unlikely]]
+                        continue;
+
+                    auto [a_i_new, alpha_i_new] = acceleration_handler.compute_fast_accelerations(i, j, this->get_x(), this->get_v(), this->get_theta(), this->get_omega(), t);
+
+                    a_i += a_i_new;
+                    alpha_i += alpha_i_new;
+                }
+
+                *(a_begin + i) = a_i;
+                *(alpha_begin + i) = alpha_i;
+            }
+        }
+    }
+
+private:
+    // Adds the translational and angular accelerations of the fields in range [i_begin, i_end), and their contributions
+    // to the partial result of the reduction of the acceleration handler unless partial_t is no_reduction
+    template <typename partial_t>
+    void compute_accelerations(long i_begin,            // index of the first field in the range
+                               long i_end,              // index past the last field in the range
+                               real_t t,                // time
+                               partial_t & partial) {   // partial result of the reduction of the calling thread
+        constexpr bool reduce = !std::is_same_v<partial_t, no_reduction>;
+
+        for (long i = i_begin; i < i_end; i ++) {
             for (long j = 0; j < (long) this->indices.size(); j ++) {
                 if (i == j) [[unlikely]]
                     continue;
@@ -78,6 +166,9 @@ public:
 
                 this->a[i] += a_i_new;
                 this->alpha[i] += alpha_i_new;
+
+                if constexpr (reduce && requires { acceleration_handler.reduce(i, j, this->get_x(), this->get_v(), this->get_theta(), this->get_omega(), t, partial); })
+                    acceleration_handler.reduce(i, j, this->get_x(), this->get_v(), this->get_theta(), this->get_omega(), t, partial);
             }
 
             // This is a compile-time conditional
@@ -87,10 +178,12 @@ public:
                 this->a[i] += a_i_new;
                 this->alpha[i] += alpha_i_new;
             }
+
+            if constexpr (reduce && requires { acceleration_handler.reduce(i, this->get_x(), this->get_v(), this->get_theta(), this->get_omega(), t, partial); })
+                acceleration_handler.reduce(i, this->get_x(), this->get_v(), this->get_theta(), this->get_omega(), t, partial);
         }
     }
 
-private:
     acceleration_handler_t & acceleration_handler;
 };
 
@@ -8,8 +8,12 @@
 #include <vector>
 #include <algorithm>
 #include <numeric>
+#include <cstdint>
 
 #include "../exception/exception.h"
+#include "../parallel/parallel_thresholds.h"
+#include "../parallel/numa.h"
+#include "../system/observer.h"
 
 // This is a base class for a second order rotational system
 //
@@ -47,6 +51,8 @@ public:
     //
     // Notes:
     // The acceleration functor and the step handler must exist for the duration of use of this second order system
+    // If first_touch is true, the field buffers are initialized in parallel by the threads that own them in the compute loops
+    // (see first_touch_buffer), so on a NUMA machine they are spread over the memory nodes of these threads
     rotational_generic_system(field_container_t x0,                                                 // container with initial positions
                               field_container_t v0,                                                 // container with initial velocities
                               field_container_t theta0,                                             // container with initial angles
@@ -55,11 +61,17 @@ public:
                               field_value_t field_zero,                                             // zero value of the primary field type used
                               real_t real_zero,                                                     // zero value of the real number type used
                               functor_t & functor_ref,                                              // reference to the object that handles calculating accelerations
-                              step_handler_t<field_container_t, field_value_t> & step_handler) :    // reference to an object that handles incrementing positions and velocities
+                              step_handler_t<field_container_t, field_value_t> & step_handler,      // reference to an object that handles incrementing positions and velocities
+                              bool first_touch = false) :                                           // initialize the field buffers in parallel
 
         // Initialize the member variables
-        field_zero(std::move(field_zero)), real_zero(real_zero), x(std::move(x0)), v(std::move(v0)), a(x.size()),
-        theta(std::move(theta0)), omega(std::move(omega0)), alpha(x.size()),
+        field_zero(std::move(field_zero)), real_zero(real_zero),
+        x(first_touch ? first_touch_copy(x0) : std::move(x0)),
+        v(first_touch ? first_touch_copy(v0) : std::move(v0)),
+        a(first_touch ? first_touch_buffer<field_container_t>((long) x.size(), this->field_zero) : field_container_t(x.size())),
+        theta(first_touch ? first_touch_copy(theta0) : std::move(theta0)),
+        omega(first_touch ? first_touch_copy(omega0) : std::move(omega0)),
+        alpha(first_touch ? first_touch_buffer<field_container_t>((long) x.size(), this->field_zero) : field_container_t(x.size())),
         integrator(functor_ref, t0, std::begin(this->x), std::end(this->x),
                    std::begin(this->v), std::begin(this->a),
                    std::begin(this->theta), std::begin(this->omega), std::begin(this->alpha),
@@ -76,7 +88,9 @@ public:
         std::iota(indices.begin(), indices.end(), 0);
 
         // Initialize the acceleration buffers to zero
-        reset_acceleration_buffers();
+        // (first-touched buffers are already zero)
+        if (!first_touch)
+            reset_acceleration_buffers();
     }
 
     // This method should set all entries in the acceleration buffer to zero
@@ -90,6 +104,34 @@ public:
         this->integrator.do_step(dt);
     }
 
+    // This method is called from the driver program to perform n_steps time steps of size dt
+    // Each observer is called as observer(n) after step n, counting from 1, see every() for observers that fire periodically
+    // Per-step bookkeeping that the systems can do themselves (e.g. automatic neighbor list updates) needs no observers
+    template <typename... observer_t>
+    void do_steps(long n_steps,                     // number of time steps
+                  real_t dt,                        // time step
+                  observer_t &&... observers) {     // callables that take the number of the step that was just completed
+        for (long n = 1; n <= n_steps; n ++) {
+            this->integrator.do_step(dt);
+            (observers(n), ...);
+        }
+    }
+
+    // Overrides the amount of work above which this system switches from serial to parallel execution
+    void set_parallel_thresholds(parallel_thresholds const & new_thresholds) {
+        this->thresholds = new_thresholds;
+    }
+
+    // Getter for the amount of work above which this system switches from serial to parallel execution
+    [[nodiscard]] parallel_thresholds const & get_parallel_thresholds() const {
+        return this->thresholds;
+    }
+
+    // Getter for the integrator, e.g. to set the parameters of integrators that have them
+    [[nodiscard]] integrator_t<field_container_t, field_value_t, real_t, functor_t, step_handler_t> & get_integrator() {
+        return this->integrator;
+    }
+
     // Getter for x buffer
     [[nodiscard]] field_container_t const & get_x() const {
         return this->x;
@@ -120,10 +162,31 @@ public:
         return this->alpha;
     }
 
+    // Visits the state of this system with an archive, to save or restore a checkpoint (see io/checkpoint.h)
+    // Systems with more state (e.g. neighbor lists) extend this method, and so can systems derived by the user
+    template <typename archive_t>
+    void serialize(archive_t & archive) {
+        // The number of fields cannot change, the integrator holds iterators to the buffers
+        std::uint64_t n_fields = this->x.size();
+        archive(n_fields);
+        if (n_fields != this->x.size())
+            throw SizeMismatchException("rotational_generic_system::serialize");
+
+        archive(this->x);
+        archive(this->v);
+        archive(this->a);
+        archive(this->theta);
+        archive(this->omega);
+        archive(this->alpha);
+        this->integrator.serialize(archive);
+    }
+
 protected:
     const field_value_t field_zero;
     const real_t real_zero;
 
+    parallel_thresholds thresholds = default_parallel_thresholds();
+
     index_container_t indices;
     field_container_t x, v, a, theta, omega, alpha;
     integrator_t<field_container_t, field_value_t, real_t, functor_t, step_handler_t> integrator;
@@ -62,7 +62,7 @@ public:
 
         this->reset_acceleration_buffer();
 
-        std::for_each(std::execution::par_unseq, this->indices.begin(), this->indices.end(), [t, this] (long i) {
+        auto compute_accelerations_of = [t, this] (long i) {
             std::for_each(this->indices.begin(), this->indices.end(), [t, i, this] (long j) {
                 if (i == j) [[unlikely]]
                     return;
@@ -72,7 +72,19 @@ public:
             if constexpr (have_unary_force) {
                 this->a[i] += acceleration_handler.compute_acceleration(i, this->get_x(), this->get_v(), t);
             }
-        });
+        };
+
+        // Small systems are cheaper to compute on the calling thread
+        if (use_parallel_execution())
+            std::for_each(std::execution::par_unseq, this->indices.begin(), this->indices.end(), compute_accelerations_of);
+        else
+            std::for_each(std::execution::seq, this->indices.begin(), this->indices.end(), compute_accelerations_of);
+    }
+
+    // Returns true if the force loop of this system is large enough to run in parallel
+    [[nodiscard]] bool use_parallel_execution() const {
+        const long n_part = (long) this->indices.size();
+        return this->thresholds.admit(n_part, n_part * (n_part - 1));
     }
 
 private:
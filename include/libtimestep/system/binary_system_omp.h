@@ -5,7 +5,11 @@
 #ifndef INTEGRATORS_BINARY_SYSTEM_OMP_H
 #define INTEGRATORS_BINARY_SYSTEM_OMP_H
 
+#include <type_traits>
+
 #include "system.h"
+#include "../parallel/partition.h"
+#include "../parallel/reduction.h"
 
 #include <omp.h>
 
@@ -41,17 +45,19 @@ public:
     // Notes:
     // The acceleration handler and the step handler must exist for the duration of use of this second order system
     // This class itself acts as the acceleration functor for the integrator
+    // If first_touch is true, the buffers are initialized in parallel with the same partitioning as the force loop
     binary_system_omp(field_container_t x0,                                                 // container with initial positions
                   field_container_t v0,                                                 // container with initial velocities
                   real_t t0,                                                            // integration start time
                   field_value_t field_zero,                                             // zero value of the primary field type used
                   real_t real_zero,                                                     // zero value of the real number type used
                   acceleration_handler_t & acceleration_handler,                        // reference to the object that handles calculating accelerations FOR EACH BINARY INTERACTION
-                  step_handler_t<field_container_t, field_value_t> & step_handler) :    // reference to an object that handles incrementing positions and velocities
+                  step_handler_t<field_container_t, field_value_t> & step_handler,      // reference to an object that handles incrementing positions and velocities
+                  bool first_touch = false) :                                           // initialize the field buffers in parallel (see generic_system)
 
     // Call the superclass constructor
             generic_system<field_value_t, real_t, integrator_t, step_handler_t, binary_system_omp>(std::move(x0),
-                                                                                               std::move(v0), t0, field_zero, real_zero, *this, step_handler), acceleration_handler(acceleration_handler) {}
+                                                                                               std::move(v0), t0, field_zero, real_zero, *this, step_handler, first_touch), acceleration_handler(acceleration_handler) {}
 
     // This method is called by the integrator to compute accelerations
     void operator() (typename field_container_t::const_iterator x_begin [[maybe_unused]],
@@ -60,24 +66,171 @@ public:
                      typename field_container_t::iterator a_begin [[maybe_unused]],
                      real_t t) {
 
-        this->reset_acceleration_buffer();
+        #pragma omp parallel default(none) shared(t) if(use_parallel_execution())
+        {
+            auto [i_begin, i_end] = thread_partition((long) this->indices.size());
+            (*this)(i_begin, i_end, t);
+        }
+    }
+
+    // Returns true if the force loop of this system is large enough to run in parallel
+    [[nodiscard]] bool use_parallel_execution() const {
+        const long n_part = (long) this->indices.size();
+        return this->thresholds.admit(n_part, n_part * (n_part - 1));
+    }
+
+    // This method is called by partitioned integrators from inside of a parallel region
+    // It only computes accelerations of the fields in range [i_begin, i_end)
+    void operator() (long i_begin,  // index of the first field in the range
+                     long i_end,    // index past the last field in the range
+                     real_t t) {
+
+        std::fill(this->a.begin() + i_begin, this->a.begin() + i_end, this->field_zero);
+
+        // The reduction of the acceleration handler, if it is requested, is computed in the same pass (see fused_reduction)
+        if constexpr (requires { acceleration_handler.get_reduction(); }) {
+            auto & reduction = acceleration_handler.get_reduction();
+            if (reduction.is_active()) {
+                typename std::decay_t<decltype(reduction)>::reduction_t partial {};
+                compute_accelerations(i_begin, i_end, t, partial);
+                reduction.combine(partial);
+                return;
+            }
+        }
+
+        no_reduction partial;
+        compute_accelerations(i_begin, i_end, t, partial);
+    }
+
+    // This method is called by block time step integrators to compute the accelerations of the active fields only
+    // Other accelerations are left unchanged
+    void operator() (index_container_t const & active,     // indices of the fields whose accelerations are computed
+                     real_t t) {
+
+        const long n_part = (long) this->indices.size();
+        const long n_active = (long) active.size();
+
+        #pragma omp parallel default(none) shared(active, t, n_part, n_active) if(this->thresholds.admit(n_active, n_active * (n_part - 1)))
+        {
+            auto [k_begin, k_end] = thread_partition(n_active);
+
+            for (long k = k_begin; k < k_end; k ++) {
+                const long i = active[k];
+                field_value_t a_i = this->field_zero;
+
+                for (long j = 0; j < n_part; j ++) {
+                    if (i == j) [[unlikely]]
+                        continue;
+
+                    a_i += acceleration_handler.compute_acceleration(i, j, this->get_x(), this->get_v(), t);
+                }
+
+                if constexpr (have_unary_force) {
+                    a_i += acceleration_handler.compute_acceleration(i, this->get_x(), this->get_v(), t);
+                }
+
+                this->a[i] = a_i;
+            }
+        }
+    }
+
+    // This method is called by block time step integrators to choose the time step of field i
+    // if the acceleration handler implements compute_time_step() (e.g. from the stiffness of the contacts of the field)
+    real_t compute_time_step(long i) requires requires (acceleration_handler_t & handler, field_container_t const & x) {
+        handler.compute_time_step(0l, x, x);
+    } {
+        return acceleration_handler.compute_time_step(i, this->get_x(), this->get_v());
+    }
+
+    // This method is called by linearly implicit integrators to compute the local Jacobians {da_i/dx_i, da_i/dv_i}
+    // of field i, summed over its binary interactions, if the acceleration handler implements compute_jacobian()
+    auto compute_jacobian(long i, real_t t) requires requires (acceleration_handler_t & handler, field_container_t const & fields, real_t time) {
+        handler.compute_jacobian(0l, 0l, fields, fields, time);
+    } && (!have_unary_force || requires (acceleration_handler_t & handler, field_container_t const & fields, real_t time) {
+        handler.compute_jacobian(0l, fields, fields, time);
+    }) {
+        typedef decltype(acceleration_handler.compute_jacobian(i, i, this->get_x(), this->get_v(), t)) jacobian_pair_t;
+        jacobian_pair_t jacobian = {this->template jacobian_zero<typename jacobian_pair_t::first_type>(),
+                                    this->template jacobian_zero<typename jacobian_pair_t::second_type>()};
+
+        for (long j = 0; j < (long) this->indices.size(); j ++) {
+            if (i == j) [[unlikely]]
+                continue;
+
+            auto [da_dx, da_dv] = acceleration_handler.compute_jacobian(i, j, this->get_x(), this->get_v(), t);
+            jacobian.first += da_dx;
+            jacobian.second += da_dv;
+        }
+
+        if constexpr (have_unary_force) {
+            auto [da_dx, da_dv] = acceleration_handler.compute_jacobian(i, this->get_x(), this->get_v(), t);
+            jacobian.first += da_dx;
+            jacobian.second += da_dv;
+        }
+
+        return jacobian;
+    }
+
+    // This method is called by multiple time step integrators to compute the rapidly varying accelerations
+    // with compute_fast_acceleration() of the acceleration handler, which must not be included in compute_acceleration()
+    // The accelerations are written to the buffer starting at a_begin
+    void compute_fast_accelerations(typename field_container_t::const_iterator x_begin [[maybe_unused]],
+                                    typename field_container_t::const_iterator x_end [[maybe_unused]],
+                                    typename field_container_t::const_iterator v_begin [[maybe_unused]],
+                                    typename field_container_t::iterator a_begin,
+                                    real_t t) {
+
+        const long n_part = (long) this->indices.size();
+
+        #pragma omp parallel default(none) shared(a_begin, t, n_part) if(use_parallel_execution())
+        {
+            auto [i_begin, i_end] = thread_partition(n_part);
 
-        #pragma omp parallel for default(none) shared(t)
-        for (long i = 0; i < (long) this->indices.size(); i ++) {
+            for (long i = i_begin; i < i_end; i ++) {
+                field_value_t a_i = this->field_zero;
+
+                for (long j = 0; j < n_part; j ++) {
+                    if (i == j) [[unlikely]]
+                        continue;
+
+                    a_i += acceleration_handler.compute_fast_acceleration(i, j, this->get_x(), this->get_v(), t);
+                }
+
+                *(a_begin + i) = a_i;
+            }
+        }
+    }
+
+private:
+    // Adds the accelerations of the fields in range [i_begin, i_end), and their contributions to the partial result of
+    // the reduction of the acceleration handler unless partial_t is no_reduction
+    template <typename partial_t>
+    void compute_accelerations(long i_begin,            // index of the first field in the range
+                               long i_end,              // index past the last field in the range
+                               real_t t,                // time
+                               partial_t & partial) {   // partial result of the reduction of the calling thread
+        constexpr bool reduce = !std::is_same_v<partial_t, no_reduction>;
+
+        for (long i = i_begin; i < i_end; i ++) {
             for (long j = 0; j < (long) this->indices.size(); j ++) {
                 if (i == j) [[unlikely]]
                     continue;
 
                 this->a[i] += acceleration_handler.compute_acceleration(i, j, this->get_x(), this->get_v(), t);
+
+                if constexpr (reduce && requires { acceleration_handler.reduce(i, j, this->get_x(), this->get_v(), t, partial); })
+                    acceleration_handler.reduce(i, j, this->get_x(), this->get_v(), t, partial);
             }
 
             if constexpr (have_unary_force) {
                 this->a[i] += acceleration_handler.compute_acceleration(i, this->get_x(), this->get_v(), t);
             }
+
+            if constexpr (reduce && requires { acceleration_handler.reduce(i, this->get_x(), this->get_v(), t, partial); })
+                acceleration_handler.reduce(i, this->get_x(), this->get_v(), t, partial);
         }
     }
 
-private:
     acceleration_handler_t & acceleration_handler;
 };
 
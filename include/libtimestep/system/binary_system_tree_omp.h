@@ -0,0 +1,157 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_BINARY_SYSTEM_TREE_OMP_H
+#define INTEGRATORS_BINARY_SYSTEM_TREE_OMP_H
+
+#include "system.h"
+#include "../parallel/partition.h"
+#include "../tree/octree.h"
+
+#include <omp.h>
+
+// This is a base class for a second order system where accelerations depend on binary interactions between fields
+// that have a long range (e.g. gravity or electrostatics in aggregation)
+// The interactions are computed with the Barnes-Hut algorithm: an octree of the positions is rebuilt in parallel before
+// every evaluation, groups of fields that are far away and look small from field i interact with i through their center
+// of mass, and all other fields interact with i directly
+//
+// Notes:
+// The acceleration handler must implement compute_acceleration(i, j, x, v, t) for the direct interactions and
+// compute_far_field_acceleration(i, center_of_mass, weight, x, t) for the interactions with a group of weight fields
+// Fields closer than r_near to a group always interact directly, so short range (e.g. contact) forces are exact
+// A field never interacts with a group that contains it, so r_near may be zero
+// The cost of an evaluation is O(N log N) for a fixed opening angle theta, theta = 0 gives the exact O(N^2) sum
+template <
+        typename field_value_t,
+        typename real_t,
+        template <
+        typename _field_container_t,
+        typename _field_value_t,
+        typename _real_t,
+        typename _functor_t,
+        template <
+        typename __field_container_t,
+        typename __field_value_t>
+        typename _step_handler_t>
+        typename integrator_t,
+        template <
+        typename _field_container_t,
+        typename _field_value_t>
+        typename step_handler_t,
+        typename acceleration_handler_t,
+        bool have_unary_force>
+class binary_system_tree_omp : public generic_system<field_value_t, real_t, integrator_t, step_handler_t,
+        binary_system_tree_omp<field_value_t, real_t, integrator_t, step_handler_t, acceleration_handler_t, have_unary_force>> {
+public:
+    typedef std::vector<field_value_t> field_container_t;
+
+    // Class constructor
+    //
+    // Notes:
+    // The acceleration handler and the step handler must exist for the duration of use of this second order system
+    // This class itself acts as the acceleration functor for the integrator
+    // If first_touch is true, the buffers are initialized in parallel with the same partitioning as the force loop
+    binary_system_tree_omp(real_t theta,                                                        // opening angle of the tree
+                           real_t r_near,                                                       // distance within which the fields always interact directly
+                           field_container_t x0,                                                // container with initial positions
+                           field_container_t v0,                                                // container with initial velocities
+                           real_t t0,                                                           // integration start time
+                           field_value_t field_zero,                                            // zero value of the primary field type used
+                           real_t real_zero,                                                    // zero value of the real number type used
+                           acceleration_handler_t & acceleration_handler,                       // reference to the object that handles calculating accelerations FOR EACH BINARY INTERACTION
+                           step_handler_t<field_container_t, field_value_t> & step_handler,     // reference to an object that handles incrementing positions and velocities
+                           bool first_touch = false,                                            // initialize the field buffers in parallel (see generic_system)
+                           long leaf_size = 8) :                                                // largest number of fields in a leaf of the tree
+
+    // Call the superclass constructor
+            generic_system<field_value_t, real_t, integrator_t, step_handler_t, binary_system_tree_omp>(std::move(x0),
+                    std::move(v0), t0, field_zero, real_zero, *this, step_handler, first_touch),
+                    theta(theta), r_near(r_near), tree(leaf_size), acceleration_handler(acceleration_handler) {}
+
+    // This method is called by the integrator to compute accelerations
+    void operator() (typename field_container_t::const_iterator x_begin [[maybe_unused]],
+                     typename field_container_t::const_iterator x_end [[maybe_unused]],
+                     typename field_container_t::const_iterator v_begin [[maybe_unused]],
+                     typename field_container_t::iterator a_begin [[maybe_unused]],
+                     real_t t) {
+
+        #pragma omp parallel default(none) shared(t) if(use_parallel_execution())
+        {
+            auto [i_begin, i_end] = thread_partition((long) this->indices.size());
+            (*this)(i_begin, i_end, t);
+        }
+    }
+
+    // Returns true if the force loop of this system is large enough to run in parallel
+    // The number of interactions is taken from the previous evaluation
+    [[nodiscard]] bool use_parallel_execution() const {
+        const long n_part = (long) this->indices.size();
+        return this->thresholds.admit(n_part, n_interactions > 0 ? n_interactions : n_part * (n_part - 1));
+    }
+
+    // This method is called by partitioned integrators from inside of a parallel region
+    // It rebuilds the tree, which is a collective call, and computes accelerations of the fields in range [i_begin, i_end)
+    void operator() (long i_begin,  // index of the first field in the range
+                     long i_end,    // index past the last field in the range
+                     real_t t) {
+
+        #pragma omp single
+        {
+            n_interactions = 0;
+        }
+
+        tree.build(this->get_x());
+
+        long n_thread_interactions = 0;
+
+        for (long i = i_begin; i < i_end; i ++) {
+            field_value_t a_i = this->field_zero;
+
+            tree.traverse(this->get_x()[i], theta, r_near, [this, i, t, &a_i, &n_thread_interactions] (long j) {
+                if (i == j) [[unlikely]]
+                    return;
+
+                a_i += acceleration_handler.compute_acceleration(i, j, this->get_x(), this->get_v(), t);
+                n_thread_interactions ++;
+            }, [this, i, t, &a_i, &n_thread_interactions] (field_value_t const & center_of_mass, real_t weight) {
+                a_i += acceleration_handler.compute_far_field_acceleration(i, center_of_mass, weight, this->get_x(), t);
+                n_thread_interactions ++;
+            }, i);
+
+            if constexpr (have_unary_force) {
+                a_i += acceleration_handler.compute_acceleration(i, this->get_x(), this->get_v(), t);
+            }
+
+            this->a[i] = a_i;
+        }
+
+        #pragma omp atomic
+        n_interactions += n_thread_interactions;
+    }
+
+    // Setter for the opening angle of the tree
+    void set_opening_angle(real_t new_theta /* opening angle, 0 gives the exact sum */) {
+        theta = new_theta;
+    }
+
+    // Getter for the number of direct and far field interactions in the last evaluation of accelerations
+    [[nodiscard]] long get_n_interactions() const {
+        return n_interactions;
+    }
+
+    // Getter for the tree built in the last evaluation of accelerations
+    [[nodiscard]] octree<field_value_t, real_t> const & get_tree() const {
+        return tree;
+    }
+
+private:
+    real_t theta;
+    const real_t r_near;
+    octree<field_value_t, real_t> tree;
+    long n_interactions = 0;
+    acceleration_handler_t & acceleration_handler;
+};
+
+#endif //INTEGRATORS_BINARY_SYSTEM_TREE_OMP_H
@@ -0,0 +1,44 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_OBSERVER_H
+#define INTEGRATORS_OBSERVER_H
+
+#include <type_traits>
+#include <utility>
+
+#include "../exception/exception.h"
+
+// Observer for do_steps() that calls the callback after every period-th step
+template <typename callback_t>
+class periodic_observer {
+public:
+    // Class constructor
+    periodic_observer(long period,              // number of steps between the calls, at least 1
+                      callback_t callback) :    // callable that takes the number of the step that was just completed
+        period(period), callback(std::move(callback)) {
+        if (period < 1)
+            throw InvalidArgumentException("periodic_observer constructor");
+    }
+
+    // This method is called by do_steps() after every step
+    void operator() (long step /* number of the step that was just completed, counting from 1 */) {
+        if (step % period == 0)
+            callback(step);
+    }
+
+private:
+    const long period;
+    callback_t callback;
+};
+
+// Creates an observer for do_steps() that calls the callback after every period-th step,
+// e.g. every(100, [&system] (long) { write_particles(system); })
+template <typename callback_t>
+periodic_observer<std::decay_t<callback_t>> every(long period,                  // number of steps between the calls, at least 1
+                                                   callback_t && callback) {    // callable that takes the number of the step that was just completed
+    return periodic_observer<std::decay_t<callback_t>>(period, std::forward<callback_t>(callback));
+}
+
+#endif //INTEGRATORS_OBSERVER_H
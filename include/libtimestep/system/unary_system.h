@@ -63,6 +63,14 @@ public:
         });
     }
 
+    // This method is called by linearly implicit integrators to compute the local Jacobians {da_i/dx_i, da_i/dv_i}
+    // of field i if the acceleration handler implements compute_jacobian()
+    auto compute_jacobian(long i, real_t t) requires requires (acceleration_handler_t & handler, field_container_t const & fields, real_t time) {
+        handler.compute_jacobian(0l, fields, fields, time);
+    } {
+        return acceleration_handler.compute_jacobian(i, this->get_x(), this->get_v(), t);
+    }
+
 private:
     acceleration_handler_t & acceleration_handler;
 };
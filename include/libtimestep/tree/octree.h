@@ -0,0 +1,368 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#ifndef INTEGRATORS_OCTREE_H
+#define INTEGRATORS_OCTREE_H
+
+#include <vector>
+#include <array>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+#include "../parallel/partition.h"
+
+// Octree of field positions for Barnes-Hut approximations of long range interactions
+// The fields are sorted along a Morton (Z-order) curve, and the tree is built one level at a time,
+// every level being split into octants in parallel, then the centers of mass are accumulated from the leaves up
+//
+// Notes:
+// field_value_t must be a three-dimensional vector that implements operator[] and norm() (e.g. Eigen::Vector3d)
+// build() must be called by all threads of a parallel region, or outside of a parallel region
+// The weight of a node is the number of fields in it
+template <typename field_value_t, typename real_t>
+class octree {
+public:
+    typedef std::vector<field_value_t> field_container_t;
+
+    // Node of the tree, the children of a node are stored next to each other
+    struct node {
+        field_value_t center;           // center of the cube of this node
+        real_t half_size;               // half of the side of the cube of this node
+        field_value_t center_of_mass;   // mean position of the fields in this node
+        real_t weight;                  // number of fields in this node
+        long begin, end;                // range of the fields of this node in the sorted order
+        long first_child;               // index of the first child node
+        int n_children;                 // number of child nodes, zero for leaves
+        int depth;                      // depth of this node, zero for the root
+    };
+
+    // Class constructor
+    explicit octree(long leaf_size = 8 /* largest number of fields in a leaf */) : leaf_size(leaf_size) {}
+
+    // Builds the tree from the positions of the fields
+    // This is a collective call if it is made from inside of a parallel region
+    void build(field_container_t const & x /* positions of the fields */) {
+        const long n = (long) x.size();
+
+        compute_bounds(x);
+
+        // Sort the fields along the Morton curve
+#pragma omp single
+        {
+            keys.resize(n);
+        }
+
+#pragma omp for schedule(static)
+        for (long i = 0; i < n; i ++)
+            keys[i] = std::make_pair(morton_code(x[i]), i);
+
+        sort_keys();
+
+        // Rank of every field in the sorted order, which tells the nodes that contain it
+#pragma omp single
+        {
+            ranks.resize(n);
+        }
+
+#pragma omp for schedule(static)
+        for (long k = 0; k < n; k ++)
+            ranks[keys[k].second] = k;
+
+        // Split the nodes one level at a time
+#pragma omp single
+        {
+            nodes.clear();
+            levels.clear();
+
+            node root;
+            root.center = x.empty() ? field_value_t() : x.front();
+            for (int d = 0; d < 3; d ++)
+                root.center[d] = lowest[d] + side / 2.0;
+            root.center_of_mass = root.center;
+            root.weight = 0.0;
+            root.half_size = side / 2.0;
+            root.begin = 0;
+            root.end = n;
+            root.first_child = 0;
+            root.n_children = 0;
+            root.depth = 0;
+            nodes.emplace_back(root);
+
+            levels.emplace_back(0, 1);
+        }
+
+        while (levels.back().first < levels.back().second) {
+            const auto [level_begin, level_end] = levels.back();
+
+#pragma omp single
+            {
+                splits.resize(level_end - level_begin);
+            }
+
+#pragma omp for schedule(static)
+            for (long k = level_begin; k < level_end; k ++)
+                split(k, splits[k - level_begin]);
+
+            // Children of the nodes of this level are appended to the nodes in the order of their parents
+#pragma omp single
+            {
+                long next = level_end;
+                for (long k = level_begin; k < level_end; k ++) {
+                    auto const & bounds = splits[k - level_begin];
+
+                    nodes[k].first_child = next;
+                    nodes[k].n_children = 0;
+                    for (int octant = 0; octant < 8; octant ++) {
+                        if (bounds[octant + 1] > bounds[octant])
+                            nodes[k].n_children ++;
+                    }
+                    next += nodes[k].n_children;
+                }
+
+                nodes.resize(next);
+                levels.emplace_back(level_end, next);
+            }
+
+#pragma omp for schedule(static)
+            for (long k = level_begin; k < level_end; k ++)
+                create_children(k, splits[k - level_begin]);
+        }
+
+        // Accumulate the centers of mass from the leaves up
+        for (long level = (long) levels.size() - 2; level >= 0; level --) {
+            const auto [level_begin, level_end] = levels[level];
+
+#pragma omp for schedule(static)
+            for (long k = level_begin; k < level_end; k ++)
+                compute_center_of_mass(x, k);
+        }
+    }
+
+    // Visits the tree from the position of a field
+    // A node is accepted as a whole if its side is smaller than theta times the distance from the position to its
+    // center of mass, and the position is farther than r_near from its cube, then far(center_of_mass, weight) is called
+    // Otherwise, the node is opened, and near(j) is called for every field j in the opened leaves
+    // Nodes that contain the given field are always opened, so the field never interacts with a group that contains it
+    template <typename near_t, typename far_t>
+    void traverse(field_value_t const & position,   // position from which the tree is visited
+                  real_t theta,                     // opening angle
+                  real_t r_near,                    // distance within which the fields always interact directly
+                  near_t && near,                   // callable that takes the index of a field
+                  far_t && far,                     // callable that takes the center of mass and the weight of a node
+                  long field = -1) const {          // index of the field at the position, or -1 for any other position
+        if (nodes.empty() || nodes.front().end == 0)
+            return;
+
+        // Every opened node replaces itself with at most 8 children, and the tree is at most max_depth deep
+        std::array<long, 8 * (max_depth + 1)> stack;
+        int top = 0;
+        stack[top ++] = 0;
+
+        const long field_rank = field >= 0 ? ranks[field] : -1;
+
+        while (top > 0) {
+            node const & current = nodes[stack[-- top]];
+
+            const bool contains_field = field_rank >= current.begin && field_rank < current.end;
+            const real_t distance = (current.center_of_mass - position).norm();
+            if (!contains_field && 2.0 * current.half_size < theta * distance && distance_to_cube(current, position) >= r_near) {
+                far(current.center_of_mass, current.weight);
+                continue;
+            }
+
+            if (current.n_children == 0) {
+                for (long k = current.begin; k < current.end; k ++)
+                    near(keys[k].second);
+                continue;
+            }
+
+            for (int c = 0; c < current.n_children; c ++)
+                stack[top ++] = current.first_child + c;
+        }
+    }
+
+    // Getter for the nodes of the tree, the root is the first node
+    [[nodiscard]] std::vector<node> const & get_nodes() const {
+        return nodes;
+    }
+
+private:
+    // Morton codes use 21 bits per dimension
+    static constexpr int max_depth = 21;
+
+    // Computes the cube that bounds all the fields
+    void compute_bounds(field_container_t const & x) {
+        auto [i_begin, i_end] = thread_partition((long) x.size());
+
+        std::array<real_t, 6> bounds = {INFINITY, INFINITY, INFINITY, -INFINITY, -INFINITY, -INFINITY};
+        for (long i = i_begin; i < i_end; i ++) {
+            for (int d = 0; d < 3; d ++) {
+                bounds[d] = std::min(bounds[d], real_t(x[i][d]));
+                bounds[d + 3] = std::max(bounds[d + 3], real_t(x[i][d]));
+            }
+        }
+
+#pragma omp single
+        {
+            thread_bounds.clear();
+        }
+
+#pragma omp critical (libtimestep_octree_bounds)
+        thread_bounds.emplace_back(bounds);
+
+#pragma omp barrier
+#pragma omp single
+        {
+            side = 0.0;
+            for (int d = 0; d < 3; d ++) {
+                lowest[d] = INFINITY;
+                real_t highest = -INFINITY;
+                for (auto const & partial : thread_bounds) {
+                    lowest[d] = std::min(lowest[d], partial[d]);
+                    highest = std::max(highest, partial[d + 3]);
+                }
+                side = std::max(side, highest - lowest[d]);
+            }
+
+            // The cube is slightly larger, so that the fields on its upper faces are inside
+            side = side > 0.0 ? side * (1.0 + 1e-9) : 1.0;
+        }
+    }
+
+    // Interleaves the bits of the quantized coordinates of a position
+    [[nodiscard]] std::uint64_t morton_code(field_value_t const & position) const {
+        std::uint64_t code = 0;
+
+        for (int d = 0; d < 3; d ++) {
+            const real_t scaled = (real_t(position[d]) - lowest[d]) / side * real_t(1l << max_depth);
+            const auto quantized = (std::uint64_t) std::clamp<real_t>(scaled, 0.0, real_t((1l << max_depth) - 1));
+
+            for (int bit = 0; bit < max_depth; bit ++)
+                code |= ((quantized >> bit) & 1ul) << (3 * bit + 2 - d);
+        }
+
+        return code;
+    }
+
+    // Sorts the Morton codes, every thread sorts its range, then the ranges are merged pairwise
+    void sort_keys() {
+#ifdef _OPENMP
+        const int n_threads = omp_get_num_threads();
+        const int thread_num = omp_get_thread_num();
+#else
+        const int n_threads = 1;
+        const int thread_num = 0;
+#endif
+        const long n = (long) keys.size();
+
+        auto [i_begin, i_end] = static_partition(n, thread_num, n_threads);
+        std::sort(keys.begin() + i_begin, keys.begin() + i_end);
+
+#pragma omp barrier
+
+        for (int width = 1; width < n_threads; width *= 2) {
+#pragma omp for schedule(static)
+            for (int chunk = 0; chunk < n_threads; chunk += 2 * width) {
+                if (chunk + width >= n_threads)
+                    continue;
+
+                const long begin = static_partition(n, chunk, n_threads).first;
+                const long middle = static_partition(n, chunk + width, n_threads).first;
+                const long end = static_partition(n, std::min(chunk + 2 * width, n_threads) - 1, n_threads).second;
+
+                std::inplace_merge(keys.begin() + begin, keys.begin() + middle, keys.begin() + end);
+            }
+        }
+    }
+
+    // Finds the ranges of the fields of node k in each octant, bounds[octant] to bounds[octant + 1]
+    void split(long k, std::array<long, 9> & bounds) const {
+        node const & current = nodes[k];
+
+        bounds.fill(current.begin);
+        if (current.end - current.begin <= leaf_size || current.depth == max_depth) {
+            return;
+        }
+
+        const int shift = 3 * (max_depth - 1 - current.depth);
+        for (int octant = 0; octant < 8; octant ++) {
+            bounds[octant + 1] = std::partition_point(keys.begin() + bounds[octant], keys.begin() + current.end,
+                                                      [shift, octant] (auto const & key) {
+                return int((key.first >> shift) & 7ul) <= octant;
+            }) - keys.begin();
+        }
+    }
+
+    // Creates the children of node k in the slots reserved for them
+    void create_children(long k, std::array<long, 9> const & bounds) {
+        node const & parent = nodes[k];
+        long child_index = parent.first_child;
+
+        for (int octant = 0; octant < 8; octant ++) {
+            if (bounds[octant + 1] == bounds[octant])
+                continue;
+
+            node & child = nodes[child_index ++];
+            child.half_size = parent.half_size / 2.0;
+            for (int d = 0; d < 3; d ++)
+                child.center[d] = parent.center[d] + (((octant >> (2 - d)) & 1) ? child.half_size : -child.half_size);
+            child.begin = bounds[octant];
+            child.end = bounds[octant + 1];
+            child.first_child = 0;
+            child.n_children = 0;
+            child.depth = parent.depth + 1;
+        }
+    }
+
+    // Computes the center of mass of node k from its fields or from its children
+    void compute_center_of_mass(field_container_t const & x, long k) {
+        node & current = nodes[k];
+
+        if (current.n_children == 0) {
+            current.center_of_mass = x[keys[current.begin].second];
+            for (long j = current.begin + 1; j < current.end; j ++)
+                current.center_of_mass += x[keys[j].second];
+            current.weight = real_t(current.end - current.begin);
+        } else {
+            node const & first = nodes[current.first_child];
+            current.center_of_mass = first.center_of_mass * first.weight;
+            current.weight = first.weight;
+            for (int c = 1; c < current.n_children; c ++) {
+                node const & child = nodes[current.first_child + c];
+                current.center_of_mass += child.center_of_mass * child.weight;
+                current.weight += child.weight;
+            }
+        }
+
+        current.center_of_mass /= current.weight;
+    }
+
+    // Distance from a position to the cube of a node, zero inside of the cube
+    [[nodiscard]] static real_t distance_to_cube(node const & current, field_value_t const & position) {
+        real_t squared_distance = 0.0;
+
+        for (int d = 0; d < 3; d ++) {
+            const real_t outside = std::max(real_t(std::abs(position[d] - current.center[d])) - current.half_size, real_t(0.0));
+            squared_distance += outside * outside;
+        }
+
+        return std::sqrt(squared_distance);
+    }
+
+    const long leaf_size;
+
+    std::vector<std::pair<std::uint64_t, long>> keys;
+    std::vector<long> ranks;
+    std::vector<node> nodes;
+    std::vector<std::pair<long, long>> levels;
+    std::vector<std::array<long, 9>> splits;
+
+    std::vector<std::array<real_t, 6>> thread_bounds;
+    std::array<real_t, 3> lowest = {0.0, 0.0, 0.0};
+    real_t side = 1.0;
+};
+
+#endif //INTEGRATORS_OCTREE_H
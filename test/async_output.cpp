@@ -0,0 +1,200 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <random>
+#include <iostream>
+#include <thread>
+#include <semaphore>
+#include <utility>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/rotational_integrator/rotational_integrator.h>
+#include <libtimestep/rotational_step_handler/rotational_step_handler.h>
+#include <libtimestep/rotational_system/rotational_unary_system.h>
+#include <libtimestep/io/async_output.h>
+
+// Independent translational and torsional oscillators
+class OscillatorSystem : public rotational_unary_system<Eigen::Vector3d, double, rotational_velocity_verlet_half, rotational_step_handler, OscillatorSystem> {
+public:
+    OscillatorSystem(std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0,
+                     std::vector<Eigen::Vector3d> theta0, std::vector<Eigen::Vector3d> omega0) :
+            rotational_unary_system<Eigen::Vector3d, double, rotational_velocity_verlet_half, rotational_step_handler, OscillatorSystem>(
+                    std::move(x0), std::move(v0), std::move(theta0), std::move(omega0), 0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance) {}
+
+    std::pair<Eigen::Vector3d, Eigen::Vector3d> compute_acceleration(size_t i,
+                                                                     std::vector<Eigen::Vector3d> const & x,
+                                                                     std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                                                     std::vector<Eigen::Vector3d> const & theta,
+                                                                     std::vector<Eigen::Vector3d> const & omega [[maybe_unused]],
+                                                                     double t [[maybe_unused]]) {
+        return {-x[i], -4.0 * theta[i]};
+    }
+
+private:
+    rotational_step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+typedef output_snapshot<Eigen::Vector3d, double> snapshot_t;
+
+// Writer that is held inside every dump until the test lets it finish, so that the test decides when the output
+// catches up instead of relying on the time a write takes
+struct HeldWriter {
+    std::counting_semaphore<> started {0};  // released when a dump is entered
+    std::counting_semaphore<> permits {0};  // acquired before a dump is finished
+
+    void operator () (snapshot_t const &) {
+        started.release();
+        permits.acquire();
+    }
+};
+
+int main() {
+    const double dt = 0.01;         // Integration time step
+    const long n_part = 10000;      // Number of particles
+    const long n_dumps = 20;        // Number of dumps
+    const long dump_period = 50;    // Number of steps between dumps
+
+    std::mt19937_64 mt(0);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    auto random_fields = [&mt, &dist] () {
+        std::vector<Eigen::Vector3d> fields(n_part);
+        for (auto & field : fields)
+            field = {dist(mt), dist(mt), dist(mt)};
+        return fields;
+    };
+
+    const auto x0 = random_fields(), v0 = random_fields(), theta0 = random_fields(), omega0 = random_fields();
+
+    // The dumps are written in order, with the fields as they were at the time of submission
+    std::vector<snapshot_t> expected, written;
+    {
+        OscillatorSystem system(x0, v0, theta0, omega0);
+        async_output<Eigen::Vector3d, double> output([&written] (snapshot_t const & snapshot) {
+            written.emplace_back(snapshot);
+        });
+
+        for (long n = 0; n < n_dumps * dump_period; n ++) {
+            if (n % dump_period == 0) {
+                output.submit(system, n, double(n) * dt);
+                expected.push_back({n, double(n) * dt, system.get_x(), system.get_v(), system.get_theta(), system.get_omega()});
+            }
+            system.do_step(dt);
+        }
+    }
+
+    if ((long) written.size() != n_dumps)
+        return EXIT_FAILURE;
+
+    for (long n = 0; n < n_dumps; n ++) {
+        if (written[n].step != expected[n].step || written[n].t != expected[n].t || written[n].x != expected[n].x
+                || written[n].v != expected[n].v || written[n].theta != expected[n].theta || written[n].omega != expected[n].omega)
+            return EXIT_FAILURE;
+    }
+
+    // submit() returns while the writer is still busy with an earlier dump, and stepping continues
+    {
+        OscillatorSystem system(x0, v0, theta0, omega0);
+        HeldWriter writer;
+        async_output<Eigen::Vector3d, double> output([&writer] (snapshot_t const & snapshot) { writer(snapshot); }, 2);
+
+        output.submit(system, 0, 0.0);
+        writer.started.acquire();
+
+        for (long n = 0; n < dump_period; n ++)
+            system.do_step(dt);
+        output.submit(system, dump_period, double(dump_period) * dt);
+
+        if (output.get_n_written() != 0 || output.get_n_stalls() != 0)
+            return EXIT_FAILURE;
+
+        writer.permits.release(2);
+        output.flush();
+        if (output.get_n_written() != 2 || output.get_n_stalls() != 0)
+            return EXIT_FAILURE;
+    }
+
+    // If the output falls behind, submit() waits once all staging buffers are queued, and continues as soon as the
+    // oldest dump is written
+    {
+        OscillatorSystem system(x0, v0, theta0, omega0);
+        HeldWriter writer;
+        async_output<Eigen::Vector3d, double> output([&writer] (snapshot_t const & snapshot) { writer(snapshot); }, 2);
+
+        // The first dump is being written and the second one is queued, so both buffers are taken
+        output.submit(system, 0, 0.0);
+        writer.started.acquire();
+        output.submit(system, 1, dt);
+
+        std::thread stepping_thread([&output, &system, dt] () { output.submit(system, 2, 2.0 * dt); });
+        while (output.get_n_stalls() == 0)
+            std::this_thread::yield();
+
+        if (output.get_n_stalls() != 1 || output.get_n_written() != 0)
+            return EXIT_FAILURE;
+
+        // Writing the first dump frees its buffer for the stalled submit(), the writer moves on to the second dump
+        writer.permits.release();
+        stepping_thread.join();
+        writer.started.acquire();
+
+        if (output.get_n_stalls() != 1 || output.get_n_written() != 1)
+            return EXIT_FAILURE;
+
+        writer.permits.release(2);
+        output.flush();
+        if (output.get_n_stalls() != 1 || output.get_n_written() != 3)
+            return EXIT_FAILURE;
+    }
+
+    // A dump that fails to be copied does not keep its staging buffer, so the output can still be flushed and used
+    {
+        struct FailingSystem {
+            std::vector<Eigen::Vector3d> x;
+            bool failing = true;
+
+            [[nodiscard]] std::vector<Eigen::Vector3d> const & get_x() const {
+                return x;
+            }
+
+            [[nodiscard]] std::vector<Eigen::Vector3d> const & get_v() const {
+                if (failing)
+                    throw OutputException("FailingSystem::get_v()");
+                return x;
+            }
+        } system {x0};
+
+        async_output<Eigen::Vector3d, double> output([] (snapshot_t const &) {}, 1);
+        try {
+            output.submit(system, 0, 0.0);
+            return EXIT_FAILURE;
+        } catch (OutputException const &) {}
+
+        output.flush();
+        system.failing = false;
+        output.submit(system, 1, dt);
+        output.flush();
+        if (output.get_n_written() != 1 || output.get_n_stalls() != 0)
+            return EXIT_FAILURE;
+    }
+
+    // Exceptions of the writer are rethrown on the stepping thread
+    {
+        OscillatorSystem system(x0, v0, theta0, omega0);
+        async_output<Eigen::Vector3d, double> output([] (snapshot_t const & snapshot) {
+            if (snapshot.step == 3)
+                throw OutputException("writer");
+        });
+
+        try {
+            for (long n = 0; n < 5; n ++)
+                output.submit(system, n, double(n) * dt);
+            output.flush();
+            return EXIT_FAILURE;
+        } catch (OutputException const &) {}
+    }
+
+    return 0;
+}
@@ -0,0 +1,235 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <utility>
+
+#include <Eigen/Eigen>
+
+#include <omp.h>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/binary_system_neighbors_omp.h>
+#include <libtimestep/rotational_integrator/rotational_integrator.h>
+#include <libtimestep/rotational_step_handler/rotational_step_handler.h>
+#include <libtimestep/rotational_system/rotational_unary_system.h>
+#include <libtimestep/io/checkpoint.h>
+
+// Binary granular system where both the contact and the attraction have a finite range
+class GranularSystem : public binary_system_neighbors_omp<Eigen::Vector3d, double, velocity_verlet_half_omp, step_handler, GranularSystem, false> {
+public:
+    GranularSystem(double k, double m, double g, double gamma_c, double r_part, double r_cutoff,
+                   std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0, double t0, size_t n_part) :
+            binary_system_neighbors_omp<Eigen::Vector3d, double, velocity_verlet_half_omp, step_handler, GranularSystem, false>(n_part, 5.0 * r_part, std::move(x0), std::move(v0),
+                                                                                       t0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance),
+                    k(k), m(m), g(g), gamma_c(gamma_c), r_part(r_part), r_cutoff(r_cutoff) {}
+
+    // Compute the acceleration of particle i due to its interaction with particle j
+    Eigen::Vector3d compute_acceleration(long i, long j,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v,
+                                         double t [[maybe_unused]]) {
+        Eigen::Vector3d distance = x[j] - x[i];
+        double distance_norm = distance.norm();
+
+        if (distance_norm >= r_cutoff)
+            return Eigen::Vector3d::Zero();
+
+        Eigen::Vector3d n = distance / distance_norm;
+        Eigen::Vector3d force = g * n;
+
+        double overlap = distance_norm - 2.0 * r_part;
+        if (overlap < 0.0)
+            force += (k * overlap + gamma_c * (v[j] - v[i]).dot(n)) * n;
+
+        return force / m;
+    }
+
+    Eigen::Vector3d compute_acceleration(long i [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & x [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) {
+
+        return Eigen::Vector3d::Zero();
+    }
+
+private:
+    const double k, m, g, gamma_c, r_part, r_cutoff;
+
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+// Damped translational and torsional oscillators that count their steps, as an example of user state in a checkpoint
+class OscillatorSystem : public rotational_unary_system<Eigen::Vector3d, double, rotational_gear_predictor_corrector, rotational_step_handler, OscillatorSystem> {
+public:
+    OscillatorSystem(std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0,
+                     std::vector<Eigen::Vector3d> theta0, std::vector<Eigen::Vector3d> omega0) :
+            rotational_unary_system<Eigen::Vector3d, double, rotational_gear_predictor_corrector, rotational_step_handler, OscillatorSystem>(
+                    std::move(x0), std::move(v0), std::move(theta0), std::move(omega0), 0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance) {}
+
+    std::pair<Eigen::Vector3d, Eigen::Vector3d> compute_acceleration(size_t i,
+                                                                     std::vector<Eigen::Vector3d> const & x,
+                                                                     std::vector<Eigen::Vector3d> const & v,
+                                                                     std::vector<Eigen::Vector3d> const & theta,
+                                                                     std::vector<Eigen::Vector3d> const & omega,
+                                                                     double t [[maybe_unused]]) {
+        return {-x[i] - 0.1 * v[i], -4.0 * theta[i] - 0.1 * omega[i]};
+    }
+
+    void step(double dt) {
+        do_step(dt);
+        n_steps ++;
+    }
+
+    // The user state is visited after the state of the base
+    template <typename archive_t>
+    void serialize(archive_t & archive) {
+        rotational_unary_system<Eigen::Vector3d, double, rotational_gear_predictor_corrector, rotational_step_handler, OscillatorSystem>::serialize(archive);
+        archive(n_steps);
+    }
+
+    [[nodiscard]] long get_n_steps() const {
+        return n_steps;
+    }
+
+private:
+    long n_steps = 0;
+    rotational_step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+bool do_overlap(std::vector<Eigen::Vector3d> const & particles, Eigen::Vector3d const & x, double r_part) {
+    return std::any_of(particles.begin(), particles.end(), [&x, r_part] (auto const & particle) -> bool {
+        return (particle - x).norm() <= 2.0 * r_part;
+    });
+}
+
+// Returns true if restoring the checkpoint at path into a system throws an InputException
+template <typename system_t>
+bool is_rejected(system_t & system, std::filesystem::path const & path) {
+    try {
+        restore_checkpoint(system, path.string());
+        return false;
+    } catch (InputException const &) {
+        return true;
+    }
+}
+
+int main() {
+    const double dt = 0.001;                        // Integration time step
+    const long n_steps = 2000;                      // Number of time steps before and after the checkpoint
+    const double r_part = 0.1;                      // Radius of a particle
+    const double r_cutoff = 4.0 * r_part;           // Range of the attraction
+    const double k = 1000.0;                        // Elastic stiffness of a particle
+    const double m = 1.0;                           // Mass of a particle
+    const double g = 0.2;                           // Attraction acceleration between particles
+    const double gamma_c = 0.2;                     // Elastic (collision) damping coefficient
+
+    const auto directory = std::filesystem::temp_directory_path() / "libtimestep_checkpoint_test";
+    std::filesystem::create_directories(directory);
+    const auto path = directory / "granular.ckpt";
+
+    std::vector<Eigen::Vector3d> x0, v0;
+
+    std::mt19937_64 mt(0);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (long i = 0; i < 100; i ++) {
+        Eigen::Vector3d x_part;
+        do {
+            x_part = {dist(mt), dist(mt), dist(mt)};
+        } while (do_overlap(x0, x_part, r_part));
+        x0.emplace_back(x_part);
+    }
+
+    v0.resize(x0.size(), Eigen::Vector3d::Zero());
+
+    // Reference: an uninterrupted run on 4 threads with a checkpoint halfway
+    omp_set_num_threads(4);
+    GranularSystem reference_system(k, m, g, gamma_c, r_part, r_cutoff, x0, v0, 0.0, x0.size());
+    reference_system.enable_automatic_neighbor_list_updates(r_cutoff);
+    reference_system.do_steps(n_steps, dt);
+
+    auto start = std::chrono::steady_clock::now();
+    save_checkpoint(reference_system, path.string());
+    const double save_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    reference_system.do_steps(n_steps, dt);
+
+    // A system restored on 1 thread continues bit for bit, including the neighbor lists and their update schedule
+    omp_set_num_threads(1);
+    GranularSystem system(k, m, g, gamma_c, r_part, r_cutoff, x0, v0, 0.0, x0.size());
+    restore_checkpoint(system, path.string());
+    system.do_steps(n_steps, dt);
+
+    std::cout << "Checkpoint of " << x0.size() << " particles: " << std::filesystem::file_size(path) << " bytes, saved in "
+              << save_time << " ms" << std::endl;
+
+    if (system.get_x() != reference_system.get_x() || system.get_v() != reference_system.get_v()
+            || system.get_n_neighbor_list_updates() != reference_system.get_n_neighbor_list_updates())
+        return EXIT_FAILURE;
+
+    // Rotational systems store the angular fields, the derivatives of the Gear integrator, and the state of the user
+    std::vector<Eigen::Vector3d> x0_rot(50), v0_rot(50), theta0(50), omega0(50);
+    for (long i = 0; i < 50; i ++) {
+        x0_rot[i] = {dist(mt), dist(mt), dist(mt)};
+        v0_rot[i] = {dist(mt), dist(mt), dist(mt)};
+        theta0[i] = {dist(mt), dist(mt), dist(mt)};
+        omega0[i] = {dist(mt), dist(mt), dist(mt)};
+    }
+
+    const auto rotational_path = directory / "rotational.ckpt";
+    OscillatorSystem reference_rotational_system(x0_rot, v0_rot, theta0, omega0);
+    for (long n = 0; n < n_steps; n ++)
+        reference_rotational_system.step(dt);
+    save_checkpoint(reference_rotational_system, rotational_path.string());
+    for (long n = 0; n < n_steps; n ++)
+        reference_rotational_system.step(dt);
+
+    OscillatorSystem rotational_system(x0_rot, v0_rot, theta0, omega0);
+    restore_checkpoint(rotational_system, rotational_path.string());
+    for (long n = 0; n < n_steps; n ++)
+        rotational_system.step(dt);
+
+    if (rotational_system.get_x() != reference_rotational_system.get_x() || rotational_system.get_omega() != reference_rotational_system.get_omega()
+            || rotational_system.get_n_steps() != 2 * n_steps)
+        return EXIT_FAILURE;
+
+    // Corrupted and truncated checkpoints, and checkpoints of systems with another number of fields, are rejected
+    std::filesystem::copy_file(path, directory / "corrupted.ckpt", std::filesystem::copy_options::overwrite_existing);
+    {
+        std::fstream fs(directory / "corrupted.ckpt", std::ios::binary | std::ios::in | std::ios::out);
+        fs.seekp(long(sizeof(checkpoint_header)) + 100);
+        fs.put('\x7f');
+    }
+
+    std::filesystem::copy_file(path, directory / "truncated.ckpt", std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::resize_file(directory / "truncated.ckpt", std::filesystem::file_size(path) - 8);
+
+    if (!is_rejected(system, directory / "corrupted.ckpt") || !is_rejected(system, directory / "truncated.ckpt"))
+        return EXIT_FAILURE;
+
+    try {
+        restore_checkpoint(system, rotational_path.string());
+        return EXIT_FAILURE;
+    } catch (SizeMismatchException const &) {}
+
+    // The temporary file is renamed over the checkpoint, and a checkpoint that cannot be written is reported
+    if (std::filesystem::exists(path.string() + ".tmp"))
+        return EXIT_FAILURE;
+
+    try {
+        save_checkpoint(system, (directory / "missing" / "granular.ckpt").string());
+        return EXIT_FAILURE;
+    } catch (OutputException const &) {}
+
+    std::filesystem::remove_all(directory);
+
+    return 0;
+}
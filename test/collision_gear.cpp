@@ -0,0 +1,147 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <iostream>
+#include <cmath>
+#include <utility>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/unary_system.h>
+#include <libtimestep/rotational_integrator/rotational_integrator.h>
+#include <libtimestep/rotational_step_handler/rotational_step_handler.h>
+#include <libtimestep/rotational_system/rotational_unary_system.h>
+
+// Particle that hits a wall with a linear spring-dashpot contact
+template <
+    template <
+        typename _field_container_t,
+        typename _field_value_t,
+        typename _real_t,
+        typename _functor_t,
+        template <
+            typename __field_container_t,
+            typename __field_value_t>
+        typename _step_handler_t>
+    typename integrator_t>
+class WallSystem : public unary_system<double, double, integrator_t, step_handler, WallSystem<integrator_t>> {
+public:
+    WallSystem(double k, double m, double gamma_c, std::vector<double> x0, std::vector<double> v0, double t0) :
+            unary_system<double, double, integrator_t, step_handler, WallSystem<integrator_t>>(std::move(x0), std::move(v0), t0, 0.0, 0.0, *this, step_handler_instance),
+            k(k), m(m), gamma_c(gamma_c) {}
+
+    double compute_acceleration(size_t i,
+                                std::vector<double> const & x [[maybe_unused]],
+                                std::vector<double> const & v [[maybe_unused]],
+                                double t [[maybe_unused]]) {
+        auto const & x_i = this->get_x()[i];
+        auto const & v_i = this->get_v()[i];
+
+        if (x_i >= 0.0)
+            return 0.0;
+
+        return -(this->k * x_i + this->gamma_c * v_i) / this->m;
+    }
+
+private:
+    step_handler<std::vector<double>, double> step_handler_instance;
+    const double k, m, gamma_c;
+};
+
+// Body with a translational and a torsional spring-dashpot
+class TorsionSystem : public rotational_unary_system<double, double, rotational_gear_predictor_corrector, rotational_step_handler, TorsionSystem> {
+public:
+    TorsionSystem(double k, double gamma, double k_theta, double gamma_theta,
+                  std::vector<double> x0, std::vector<double> v0, std::vector<double> theta0, std::vector<double> omega0, double t0) :
+            rotational_unary_system<double, double, rotational_gear_predictor_corrector, rotational_step_handler, TorsionSystem>(std::move(x0), std::move(v0),
+                    std::move(theta0), std::move(omega0), t0, 0.0, 0.0, *this, step_handler_instance),
+            k(k), gamma(gamma), k_theta(k_theta), gamma_theta(gamma_theta) {}
+
+    std::pair<double, double> compute_acceleration(size_t i,
+                                                   std::vector<double> const & x,
+                                                   std::vector<double> const & v,
+                                                   std::vector<double> const & theta,
+                                                   std::vector<double> const & omega,
+                                                   double t [[maybe_unused]]) {
+        return {-k * x[i] - gamma * v[i], -k_theta * theta[i] - gamma_theta * omega[i]};
+    }
+
+private:
+    rotational_step_handler<std::vector<double>, double> step_handler_instance;
+    const double k, gamma, k_theta, gamma_theta;
+};
+
+// Returns the coefficient of restitution of a collision with the wall integrated with the given time step
+template <
+    template <
+        typename _field_container_t,
+        typename _field_value_t,
+        typename _real_t,
+        typename _functor_t,
+        template <
+            typename __field_container_t,
+            typename __field_value_t>
+        typename _step_handler_t>
+    typename integrator_t>
+double compute_restitution(double k, double m, double gamma_c, double dt) {
+    const double v_impact = 1.0;
+    WallSystem<integrator_t> system(k, m, gamma_c, {0.01}, {-v_impact}, 0.0);
+
+    for (long n = 0; n < long(0.2 / dt); n ++)
+        system.do_step(dt);
+
+    return system.get_v()[0] / v_impact;
+}
+
+// Exact solution of a damped oscillator released from x0 at rest
+double damped_oscillator(double omega_0, double zeta, double x0, double t) {
+    const double omega_d = omega_0 * std::sqrt(1.0 - zeta * zeta);
+    return x0 * std::exp(-zeta * omega_0 * t) * (std::cos(omega_d * t) + zeta * omega_0 / omega_d * std::sin(omega_d * t));
+}
+
+int main() {
+    // Contact with damping ratio 0.5, resolved with 20 steps
+    const double k = 1.0e4, m = 1.0, zeta = 0.5;
+    const double gamma_c = 2.0 * zeta * std::sqrt(k * m);
+    const double contact_duration = M_PI / (std::sqrt(k / m) * std::sqrt(1.0 - zeta * zeta));
+    const double dt = contact_duration / 20.0;
+    const double exact_restitution = std::exp(-zeta * M_PI / std::sqrt(1.0 - zeta * zeta));
+
+    const double gear_restitution = compute_restitution<gear_predictor_corrector>(k, m, gamma_c, dt);
+    const double verlet_restitution = compute_restitution<velocity_verlet_half>(k, m, gamma_c, dt);
+
+    std::cout << "Coefficient of restitution: exact " << exact_restitution << ", Gear " << gear_restitution
+              << ", Velocity Verlet " << verlet_restitution << std::endl;
+
+    if (std::abs(gear_restitution - exact_restitution) > 0.01 * exact_restitution)
+        return EXIT_FAILURE;
+
+    // Dashpot forces evaluated with lagged velocities dissipate a different amount of energy
+    if (std::abs(gear_restitution - exact_restitution) > std::abs(verlet_restitution - exact_restitution))
+        return EXIT_FAILURE;
+
+    // Translational and torsional damped oscillators with different frequencies
+    const double omega_x = 10.0, omega_theta = 25.0, zeta_x = 0.3, zeta_theta = 0.7;
+    TorsionSystem torsion(omega_x * omega_x, 2.0 * zeta_x * omega_x, omega_theta * omega_theta, 2.0 * zeta_theta * omega_theta,
+                          {1.0}, {0.0}, {0.5}, {0.0}, 0.0);
+
+    const double dt_torsion = 1.0e-3;
+    double max_error = 0.0;
+    for (long n = 1; n <= 1000; n ++) {
+        torsion.do_step(dt_torsion);
+
+        const double t = double(n) * dt_torsion;
+        max_error = std::max(max_error, std::abs(torsion.get_x()[0] - damped_oscillator(omega_x, zeta_x, 1.0, t)));
+        max_error = std::max(max_error, std::abs(torsion.get_theta()[0] - damped_oscillator(omega_theta, zeta_theta, 0.5, t)));
+    }
+
+    std::cout << "Largest error of the rotational integrator: " << max_error << std::endl;
+
+    // The error is dominated by the first steps, where the higher derivatives are not known yet
+    if (max_error > 1e-4)
+        return EXIT_FAILURE;
+
+    return 0;
+}
@@ -0,0 +1,189 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <random>
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <utility>
+#include <cstddef>
+
+#include <omp.h>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/unary_system.h>
+#include <libtimestep/io/trajectory.h>
+#include <libtimestep/io/compressed_trajectory.h>
+
+// Particles bound to the sites of a lattice by harmonic springs, like the particles of a solid
+class LatticeSystem : public unary_system<Eigen::Vector3d, double, velocity_verlet_half, step_handler, LatticeSystem> {
+public:
+    LatticeSystem(std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0, double k) :
+            unary_system<Eigen::Vector3d, double, velocity_verlet_half, step_handler, LatticeSystem>(x0, std::move(v0),
+                    0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance), sites(std::move(x0)), k(k) {}
+
+    Eigen::Vector3d compute_acceleration(size_t i,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) {
+        return -k * (x[i] - sites[i]);
+    }
+
+private:
+    const std::vector<Eigen::Vector3d> sites;
+    const double k;
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+int main() {
+    const long n_side = 30;                 // Number of lattice sites along each side
+    const long n_part = n_side * n_side * n_side;
+    const double r_part = 0.01;             // Radius of a particle
+    const double precision = 1e-4 * r_part; // Precision of the compressed positions
+    const double dt = 1e-3;                 // Integration time step
+    const long dump_period = 10;            // Number of steps between frames
+    const long n_frames = 150;              // Number of frames, key frames are 0 and 100
+
+    const auto directory = std::filesystem::temp_directory_path() / "libtimestep_compressed_trajectory_test";
+    std::filesystem::create_directories(directory);
+
+    std::mt19937_64 mt(0);
+    std::normal_distribution<double> dist(0.0, 0.01);
+    std::vector<Eigen::Vector3d> x0(n_part), v0(n_part);
+    for (long i = 0; i < n_part; i ++) {
+        x0[i] = 2.0 * r_part * Eigen::Vector3d(double(i % n_side), double((i / n_side) % n_side), double(i / n_side / n_side));
+        v0[i] = {dist(mt), dist(mt), dist(mt)};
+    }
+
+    LatticeSystem system(x0, v0, 100.0);
+
+    // Positions of the frames, to check the decoded positions
+    std::vector<std::vector<Eigen::Vector3d>> frames;
+    double raw_time = 0, compressed_time = 0;
+
+    {
+        trajectory_writer<Eigen::Vector3d, double> raw_writer((directory / "raw.traj").string(), system);
+        compressed_trajectory_writer<Eigen::Vector3d, double> compressed_writer((directory / "compressed.xtc").string(), n_part, precision);
+
+        for (long n = 0; n < n_frames * dump_period; n ++) {
+            if (n % dump_period == 0) {
+                frames.emplace_back(system.get_x());
+
+                auto start = std::chrono::steady_clock::now();
+                raw_writer.write(system, n, double(n) * dt);
+                auto middle = std::chrono::steady_clock::now();
+                compressed_writer.write(system, n, double(n) * dt);
+                auto end = std::chrono::steady_clock::now();
+
+                raw_time += std::chrono::duration<double, std::milli>(middle - start).count();
+                compressed_time += std::chrono::duration<double, std::milli>(end - middle).count();
+            }
+
+            system.do_step(dt);
+        }
+    }
+
+    // The decoded positions are within precision / 2 of the written ones in every frame, the error does not accumulate
+    compressed_trajectory_reader<Eigen::Vector3d, double> reader((directory / "compressed.xtc").string());
+    std::vector<Eigen::Vector3d> x;
+    double max_error = 0;
+    while (reader.read_frame(x)) {
+        const long frame = reader.get_n_frames_read() - 1;
+        if (reader.get_step() != frame * dump_period || reader.get_time() != double(frame * dump_period) * dt)
+            return EXIT_FAILURE;
+
+        for (long i = 0; i < n_part; i ++)
+            max_error = std::max(max_error, (x[i] - frames[frame][i]).lpNorm<Eigen::Infinity>());
+    }
+
+    if (reader.get_n_frames_read() != n_frames || max_error > 0.5 * precision * (1.0 + 1e-6))
+        return EXIT_FAILURE;
+
+    const auto raw_size = std::filesystem::file_size(directory / "raw.traj");
+    const auto compressed_size = std::filesystem::file_size(directory / "compressed.xtc");
+    const auto positions_size = n_frames * n_part * sizeof(Eigen::Vector3d);
+
+    std::cout << "Maximum error: " << max_error / r_part << " particle radii" << std::endl;
+    std::cout << "File sizes: raw " << raw_size << " bytes, positions only " << positions_size << " bytes, compressed "
+              << compressed_size << " bytes" << std::endl;
+    std::cout << "Time per frame: raw " << raw_time / n_frames << " ms, compressed " << compressed_time / n_frames << " ms" << std::endl;
+
+    if (raw_size < 10 * compressed_size || positions_size < 5 * compressed_size)
+        return EXIT_FAILURE;
+
+    // A reader stops at an incomplete frame and reads it once it is complete
+    {
+        compressed_trajectory_writer<Eigen::Vector3d, double> writer((directory / "partial.xtc").string(), n_part, precision);
+        writer.write(frames[0], 0, 0.0);
+        writer.write(frames[1], 1, 1.0);
+
+        std::filesystem::copy_file(directory / "partial.xtc", directory / "complete.xtc", std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::resize_file(directory / "partial.xtc", std::filesystem::file_size(directory / "partial.xtc") - 100);
+
+        compressed_trajectory_reader<Eigen::Vector3d, double> partial_reader((directory / "partial.xtc").string());
+        if (!partial_reader.read_frame(x) || partial_reader.read_frame(x))
+            return EXIT_FAILURE;
+
+        std::filesystem::copy_file(directory / "complete.xtc", directory / "partial.xtc", std::filesystem::copy_options::overwrite_existing);
+        if (!partial_reader.read_frame(x) || partial_reader.get_step() != 1 || (x[0] - frames[1][0]).norm() > precision)
+            return EXIT_FAILURE;
+    }
+
+    // A corrupted block is reported by the reader, the last bytes of the frame no longer end a varint
+    {
+        compressed_trajectory_writer<Eigen::Vector3d, double> writer((directory / "corrupted.xtc").string(), n_part, precision);
+        writer.write(frames[0], 0, 0.0);
+    }
+    {
+        std::fstream file(directory / "corrupted.xtc", std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-5, std::ios::end);
+        const char corrupted[5] = {'\xff', '\xff', '\xff', '\xff', '\xff'};
+        file.write(corrupted, sizeof(corrupted));
+    }
+
+    const int n_threads = omp_get_max_threads();
+    omp_set_num_threads(4);
+    try {
+        compressed_trajectory_reader<Eigen::Vector3d, double> corrupted_reader((directory / "corrupted.xtc").string());
+        corrupted_reader.read_frame(x);
+        return EXIT_FAILURE;
+    } catch (InputException const &) {}
+    omp_set_num_threads(n_threads);
+
+    // A header with an empty block or without a positive precision is rejected when the reader is created
+    for (long field_offset : {long(offsetof(compressed_trajectory_header, block_size)), long(offsetof(compressed_trajectory_header, precision))}) {
+        {
+            compressed_trajectory_writer<Eigen::Vector3d, double> writer((directory / "corrupted_header.xtc").string(), n_part, precision);
+            writer.write(frames[0], 0, 0.0);
+        }
+        {
+            std::fstream file(directory / "corrupted_header.xtc", std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(field_offset);
+            const char zeros[8] = {};
+            file.write(zeros, sizeof(zeros));
+        }
+
+        try {
+            compressed_trajectory_reader<Eigen::Vector3d, double> corrupted_reader((directory / "corrupted_header.xtc").string());
+            return EXIT_FAILURE;
+        } catch (InputException const &) {}
+    }
+
+    // Writers without a positive precision or with less than one frame between key frames are rejected
+    for (auto [invalid_precision, key_frame_interval] : {std::pair(0.0, 100L), std::pair(-precision, 100L), std::pair(precision, 0L)}) {
+        try {
+            compressed_trajectory_writer<Eigen::Vector3d, double> writer((directory / "invalid.xtc").string(), n_part, invalid_precision, key_frame_interval);
+            return EXIT_FAILURE;
+        } catch (InvalidArgumentException const &) {}
+    }
+
+    std::filesystem::remove_all(directory);
+
+    return 0;
+}
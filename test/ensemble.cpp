@@ -0,0 +1,81 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <iostream>
+#include <cmath>
+#include <memory>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/unary_system.h>
+#include <libtimestep/ensemble/ensemble.h>
+
+// Implement a unary second-order system
+class OscillatorSystem : public unary_system<double, double, velocity_verlet_half, step_handler, OscillatorSystem> {
+public:
+    OscillatorSystem(double k, double m, double gamma_d,
+                     std::vector<double> x0, std::vector<double> v0, double t0) :
+            unary_system<double, double, velocity_verlet_half, step_handler, OscillatorSystem>(std::move(x0), std::move(v0), t0, 0.0, 0.0, *this, step_handler_instance),
+            k(k), m(m), gamma_d(gamma_d) {}
+
+    double compute_acceleration(size_t i,
+                                std::vector<double> const & x [[maybe_unused]],
+                                std::vector<double> const & v [[maybe_unused]],
+                                double t [[maybe_unused]]) {
+        auto const & x_i = this->get_x()[i];
+        auto const & v_i = this->get_v()[i];
+
+        return 1.0 / this->m * (1.0 - this->gamma_d * v_i - this->k * x_i);
+    }
+
+private:
+    step_handler<std::vector<double>, double> step_handler_instance;
+    const double k, m, gamma_d;
+};
+
+int main() {
+    const double dt = 0.01;             // Integration time step
+    const long n_steps = 500;           // Number of integration time steps
+    const double m = 1.0;               // Mass
+    const long n_members = 64;          // Number of oscillators in the sweep
+
+    // Stiffness and damping are swept between the members
+    auto stiffness = [] (long member) { return 1.0 + double(member); };
+    auto damping = [m, &stiffness] (long member) { return 0.5 * sqrt(m * stiffness(member)); };
+
+    ensemble<OscillatorSystem> oscillators(n_members);
+    for (long member = 0; member < n_members; member ++)
+        oscillators.emplace(stiffness(member), m, damping(member), std::vector<double>{0.0}, std::vector<double>{0.0}, 0.0);
+
+    // Odd members are retired after the first step
+    oscillators.do_steps(10, dt, [] (OscillatorSystem const & system [[maybe_unused]], long member) {
+        return member % 2 == 1;
+    });
+
+    if (oscillators.get_n_active() != n_members / 2) {
+        std::cout << "Wrong number of active members" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    for (long n = 10; n < n_steps; n ++)
+        oscillators.do_step(dt);
+
+    // Every member must follow the same trajectory as a system that is stepped alone
+    for (long member = 0; member < n_members; member ++) {
+        auto reference = std::make_unique<OscillatorSystem>(stiffness(member), m, damping(member),
+                                                            std::vector<double>{0.0}, std::vector<double>{0.0}, 0.0);
+
+        const long n_member_steps = oscillators.is_active(member) ? n_steps : 1;
+        for (long n = 0; n < n_member_steps; n ++)
+            reference->do_step(dt);
+
+        if (reference->get_x() != oscillators[member].get_x() || reference->get_v() != oscillators[member].get_v()) {
+            std::cout << "Trajectory of member " << member << " differs from the trajectory of a single system" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return 0;
+}
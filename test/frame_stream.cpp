@@ -0,0 +1,163 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <random>
+#include <iostream>
+#include <ranges>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/unary_system.h>
+#include <libtimestep/rotational_integrator/rotational_integrator.h>
+#include <libtimestep/rotational_step_handler/rotational_step_handler.h>
+#include <libtimestep/rotational_system/rotational_unary_system.h>
+#include <libtimestep/io/frame_stream.h>
+
+// Independent harmonic oscillators, the acceleration throws after n_fail evaluations
+class OscillatorSystem : public unary_system<Eigen::Vector3d, double, velocity_verlet_half, step_handler, OscillatorSystem> {
+public:
+    OscillatorSystem(std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0, long n_fail) :
+            unary_system<Eigen::Vector3d, double, velocity_verlet_half, step_handler, OscillatorSystem>(std::move(x0), std::move(v0),
+                    0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance), n_fail(n_fail) {}
+
+    Eigen::Vector3d compute_acceleration(size_t i,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) {
+        if (++ n_evaluations > n_fail)
+            throw std::runtime_error("acceleration");
+        return -x[i];
+    }
+
+private:
+    const long n_fail;
+    long n_evaluations = 0;
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+// Independent translational and torsional oscillators
+class RotationalOscillatorSystem : public rotational_unary_system<Eigen::Vector3d, double, rotational_velocity_verlet_half, rotational_step_handler, RotationalOscillatorSystem> {
+public:
+    RotationalOscillatorSystem(std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0,
+                               std::vector<Eigen::Vector3d> theta0, std::vector<Eigen::Vector3d> omega0) :
+            rotational_unary_system<Eigen::Vector3d, double, rotational_velocity_verlet_half, rotational_step_handler, RotationalOscillatorSystem>(
+                    std::move(x0), std::move(v0), std::move(theta0), std::move(omega0), 0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance) {}
+
+    std::pair<Eigen::Vector3d, Eigen::Vector3d> compute_acceleration(size_t i,
+                                                                     std::vector<Eigen::Vector3d> const & x,
+                                                                     std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                                                     std::vector<Eigen::Vector3d> const & theta,
+                                                                     std::vector<Eigen::Vector3d> const & omega [[maybe_unused]],
+                                                                     double t [[maybe_unused]]) {
+        return {-x[i], -4.0 * theta[i]};
+    }
+
+private:
+    rotational_step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+typedef frame_stream<Eigen::Vector3d, double> stream_t;
+
+static_assert(std::ranges::input_range<stream_t> && std::ranges::view<stream_t>, "frame streams are input views");
+
+int main() {
+    const double dt = 0.01;         // Integration time step
+    const long n_part = 1000;       // Number of particles
+    const long period = 10;         // Number of steps between the frames
+
+    std::mt19937_64 mt(0);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    auto random_fields = [&mt, &dist] () {
+        std::vector<Eigen::Vector3d> fields(n_part);
+        for (auto & field : fields)
+            field = {dist(mt), dist(mt), dist(mt)};
+        return fields;
+    };
+
+    const auto x0 = random_fields(), v0 = random_fields(), theta0 = random_fields(), omega0 = random_fields();
+
+    // The frames are views into the system with the same values as stepping the system in a loop
+    {
+        RotationalOscillatorSystem system(x0, v0, theta0, omega0), reference(x0, v0, theta0, omega0);
+
+        long n_frames = 0;
+        for (auto const & frame : stream_frames<Eigen::Vector3d, double>(system, dt, period, 20, 100, 1.0)) {
+            if (frame.step != 100 + n_frames * period || frame.t != 1.0 + double(n_frames * period) * dt)
+                return EXIT_FAILURE;
+
+            if (frame.x.data() != system.get_x().data() || frame.omega.data() != system.get_omega().data())
+                return EXIT_FAILURE;
+
+            if (!std::ranges::equal(frame.x, reference.get_x()) || !std::ranges::equal(frame.v, reference.get_v())
+                    || !std::ranges::equal(frame.theta, reference.get_theta()) || !std::ranges::equal(frame.omega, reference.get_omega()))
+                return EXIT_FAILURE;
+
+            for (long n = 0; n < period; n ++)
+                reference.do_step(dt);
+            n_frames ++;
+        }
+
+        if (n_frames != 20)
+            return EXIT_FAILURE;
+    }
+
+    // Pipeline stages pull the frames lazily, so an endless stream is stepped only as far as the consumer reads
+    {
+        OscillatorSystem system(x0, v0, std::numeric_limits<long>::max()), reference(x0, v0, std::numeric_limits<long>::max());
+
+        auto kinetic_energy = [] (auto const & frame) {
+            double energy = 0.0;
+            for (auto const & v : frame.v)
+                energy += 0.5 * v.squaredNorm();
+            return energy;
+        };
+
+        auto pipeline = stream_frames<Eigen::Vector3d, double>(system, dt, period)
+                        | std::views::take(18)
+                        | std::views::filter([] (auto const & frame) { return frame.step % (4 * period) == 0; });
+
+        std::vector<long> steps;
+        double total_energy = 0.0;
+        for (auto const & frame : pipeline) {
+            steps.emplace_back(frame.step);
+            total_energy += kinetic_energy(frame);
+        }
+
+        if (steps != std::vector<long> {0, 40, 80, 120, 160} || total_energy <= 0.0)
+            return EXIT_FAILURE;
+
+        // The last frame that was pulled is at step 170, so the system was not stepped past it
+        for (long n = 0; n < 170; n ++)
+            reference.do_step(dt);
+        if (system.get_x() != reference.get_x())
+            return EXIT_FAILURE;
+
+        std::cout << "Kinetic energy summed over " << steps.size() << " frames: " << total_energy << std::endl;
+    }
+
+    // An exception thrown while stepping is rethrown by the pull that caused the step
+    {
+        // The first step evaluates the accelerations twice, so the 25th step fails
+        OscillatorSystem system(x0, v0, 25 * n_part);
+        auto stream = stream_frames<Eigen::Vector3d, double>(system, dt, period);
+
+        long last_step = -1;
+        try {
+            for (auto const & frame : stream)
+                last_step = frame.step;
+            return EXIT_FAILURE;
+        } catch (std::runtime_error const &) {}
+
+        if (last_step != 20)
+            return EXIT_FAILURE;
+    }
+
+    return 0;
+}
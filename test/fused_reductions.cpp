@@ -0,0 +1,274 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+#include <utility>
+
+#include <omp.h>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/binary_system_neighbors_omp.h>
+#include <libtimestep/rotational_integrator/rotational_integrator.h>
+#include <libtimestep/rotational_step_handler/rotational_step_handler.h>
+#include <libtimestep/rotational_system/rotational_binary_system_omp.h>
+#include <libtimestep/packing/random_packing.h>
+#include <libtimestep/parallel/reduction.h>
+
+#include "compute_energy.h"
+
+typedef particle_diagnostics<Eigen::Vector3d, double> diagnostics_t;
+
+// Granular system with spring-dashpot contacts and a constant attraction within 3 radii, whose diagnostics are reduced
+// in the force loop
+class GranularSystem : public binary_system_neighbors_omp<Eigen::Vector3d, double, velocity_verlet_half_omp, step_handler, GranularSystem, false> {
+public:
+    GranularSystem(double k, double m, double g, double gamma_c, double r_part,
+                   std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0) :
+            binary_system_neighbors_omp<Eigen::Vector3d, double, velocity_verlet_half_omp, step_handler, GranularSystem, false>((long) x0.size(), 5.0 * r_part,
+                    x0, std::move(v0), 0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance, true),
+            k(k), m(m), g(g), gamma_c(gamma_c), r_part(r_part) {}
+
+    Eigen::Vector3d compute_acceleration(long i, long j,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v,
+                                         double t [[maybe_unused]]) {
+        Eigen::Vector3d distance = x[j] - x[i];
+        const double distance_norm = distance.norm();
+        const double overlap = distance_norm - 2.0 * r_part;
+        Eigen::Vector3d n = distance / distance_norm;
+
+        Eigen::Vector3d force = Eigen::Vector3d::Zero();
+        if (distance_norm < 3.0 * r_part)
+            force += m * g * n;
+        if (overlap < 0.0)
+            force += (k * overlap + gamma_c * (v[j] - v[i]).dot(n)) * n;
+
+        return force / m;
+    }
+
+    Eigen::Vector3d compute_acceleration(long i [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & x [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) {
+        return Eigen::Vector3d::Zero();
+    }
+
+    // Contributions of field i to the diagnostics
+    void reduce(long i,
+                std::vector<Eigen::Vector3d> const & x [[maybe_unused]],
+                std::vector<Eigen::Vector3d> const & v,
+                double t [[maybe_unused]],
+                diagnostics_t & partial) const {
+        partial.kinetic_energy += 0.5 * m * v[i].squaredNorm();
+        partial.linear_momentum += m * v[i];
+        partial.max_speed = std::max(partial.max_speed, v[i].norm());
+    }
+
+    // Contributions of the pair i, j to the diagnostics, every pair is visited from both sides
+    void reduce(long i, long j,
+                std::vector<Eigen::Vector3d> const & x,
+                std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                double t [[maybe_unused]],
+                diagnostics_t & partial) const {
+        partial.potential_energy += 0.5 * pair_potential_energy(x[i], x[j]);
+        partial.max_overlap = std::max(partial.max_overlap, 2.0 * r_part - (x[j] - x[i]).norm());
+    }
+
+    [[nodiscard]] double pair_potential_energy(Eigen::Vector3d const & x_i, Eigen::Vector3d const & x_j) const {
+        const double distance_norm = (x_j - x_i).norm();
+        const double overlap = std::min(distance_norm - 2.0 * r_part, 0.0);
+        return m * g * std::min(distance_norm - 3.0 * r_part, 0.0) + 0.5 * k * overlap * overlap;
+    }
+
+    fused_reduction<diagnostics_t> & get_reduction() {
+        return diagnostics;
+    }
+
+    fused_reduction<diagnostics_t> diagnostics;
+
+private:
+    const double k, m, g, gamma_c, r_part;
+
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+// Translational and torsional oscillators coupled by a spring to the origin, with the rotational diagnostics
+class RotationalSystem : public rotational_binary_system_omp<Eigen::Vector3d, double, rotational_velocity_verlet_half_omp, rotational_step_handler, RotationalSystem, true> {
+public:
+    RotationalSystem(double m, double inertia, std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0,
+                     std::vector<Eigen::Vector3d> theta0, std::vector<Eigen::Vector3d> omega0) :
+            rotational_binary_system_omp<Eigen::Vector3d, double, rotational_velocity_verlet_half_omp, rotational_step_handler, RotationalSystem, true>(
+                    std::move(x0), std::move(v0), std::move(theta0), std::move(omega0), 0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance),
+            m(m), inertia(inertia) {}
+
+    std::pair<Eigen::Vector3d, Eigen::Vector3d> compute_accelerations(long i [[maybe_unused]], long j [[maybe_unused]],
+                                                                      std::vector<Eigen::Vector3d> const & x [[maybe_unused]],
+                                                                      std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                                                      std::vector<Eigen::Vector3d> const & theta [[maybe_unused]],
+                                                                      std::vector<Eigen::Vector3d> const & omega [[maybe_unused]],
+                                                                      double t [[maybe_unused]]) {
+        return {Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero()};
+    }
+
+    std::pair<Eigen::Vector3d, Eigen::Vector3d> compute_accelerations(long i,
+                                                                      std::vector<Eigen::Vector3d> const & x,
+                                                                      std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                                                      std::vector<Eigen::Vector3d> const & theta,
+                                                                      std::vector<Eigen::Vector3d> const & omega [[maybe_unused]],
+                                                                      double t [[maybe_unused]]) {
+        return {-x[i] / m, -theta[i] / inertia};
+    }
+
+    void reduce(long i,
+                std::vector<Eigen::Vector3d> const & x,
+                std::vector<Eigen::Vector3d> const & v,
+                std::vector<Eigen::Vector3d> const & theta [[maybe_unused]],
+                std::vector<Eigen::Vector3d> const & omega,
+                double t [[maybe_unused]],
+                diagnostics_t & partial) const {
+        partial.kinetic_energy += 0.5 * m * v[i].squaredNorm();
+        partial.rotational_energy += 0.5 * inertia * omega[i].squaredNorm();
+        partial.linear_momentum += m * v[i];
+        partial.angular_momentum += inertia * omega[i] + x[i].cross(m * v[i]);
+    }
+
+    fused_reduction<diagnostics_t> & get_reduction() {
+        return diagnostics;
+    }
+
+    fused_reduction<diagnostics_t> diagnostics;
+
+private:
+    const double m, inertia;
+
+    rotational_step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+// Returns true if a and b agree to a relative tolerance
+bool close(double a, double b, double tolerance = 1.0e-12) {
+    return std::abs(a - b) <= tolerance * std::max(std::abs(a), std::abs(b));
+}
+
+int main() {
+    const double dt = 0.001;                        // Integration time step
+    const long n_steps = 200;                       // Number of time steps
+    const long n_part = 2000;                       // Number of particles
+    const double r_part = 0.1;                      // Radius of a particle
+    const double k = 1000.0;                        // Elastic stiffness of a particle
+    const double m = 1.0;                           // Mass of a particle
+    const double g = 0.2;                           // Attraction acceleration between particles
+    const double gamma_c = 0.2;                     // Elastic (collision) damping coefficient
+
+    const std::vector<double> radii(n_part, r_part);
+    const double length = packing_box_length(radii, 0.2);
+    const auto x0 = random_packing(radii, Eigen::Vector3d::Zero().eval(), Eigen::Vector3d::Constant(length).eval(), 0);
+    const std::vector<Eigen::Vector3d> v0(n_part, Eigen::Vector3d::Zero());
+
+    // The diagnostics reduced in the force loop after every step agree with separate passes over the fields
+    GranularSystem system(k, m, g, gamma_c, r_part, x0, v0);
+    system.diagnostics.enable(true);
+
+    for (long n = 0; n < n_steps; n ++) {
+        system.do_step(dt);
+
+        auto const & diagnostics = system.diagnostics.get_result();
+        Eigen::Vector3d linear_momentum = Eigen::Vector3d::Zero();
+        double max_speed = 0.0;
+        for (auto const & v : system.get_v()) {
+            linear_momentum += m * v;
+            max_speed = std::max(max_speed, v.norm());
+        }
+
+        if (!close(diagnostics.kinetic_energy, compute_kinetic_energy(system.get_v(), m))
+                || (diagnostics.linear_momentum - linear_momentum).norm() > 1.0e-12 || diagnostics.max_speed != max_speed)
+            return EXIT_FAILURE;
+    }
+
+    // The pair contributions agree with a pass over all pairs, the particles move much less than the skin of the
+    // neighbor lists, so every interacting pair is in them
+    {
+        auto const & diagnostics = system.diagnostics.get_result();
+        double potential_energy = 0.0, max_overlap = 0.0;
+        for (long i = 0; i < n_part; i ++) {
+            for (long j = i + 1; j < n_part; j ++) {
+                potential_energy += system.pair_potential_energy(system.get_x()[i], system.get_x()[j]);
+                max_overlap = std::max(max_overlap, 2.0 * r_part - (system.get_x()[j] - system.get_x()[i]).norm());
+            }
+        }
+
+        std::cout << "Kinetic energy " << diagnostics.kinetic_energy << ", potential energy " << diagnostics.potential_energy
+                  << ", largest overlap " << diagnostics.max_overlap << std::endl;
+
+        if (!close(diagnostics.potential_energy, potential_energy, 1.0e-9) || diagnostics.max_overlap != max_overlap)
+            return EXIT_FAILURE;
+    }
+
+    // A request is served by the next force computation only
+    system.diagnostics.enable(false);
+    const long n_computed = system.diagnostics.get_n_computed();
+    system.diagnostics.request();
+    for (long n = 0; n < 5; n ++)
+        system.do_step(dt);
+
+    if (system.diagnostics.get_n_computed() != n_computed + 1)
+        return EXIT_FAILURE;
+
+    // The reductions give the same result from run to run with the same number of threads
+    {
+        const int n_threads = omp_get_max_threads();
+        omp_set_num_threads(4);
+
+        std::vector<diagnostics_t> results[2];
+        for (auto & result : results) {
+            GranularSystem run(k, m, g, gamma_c, r_part, x0, v0);
+            run.diagnostics.enable(true);
+            for (long n = 0; n < 50; n ++) {
+                run.do_step(dt);
+                result.emplace_back(run.diagnostics.get_result());
+            }
+        }
+
+        omp_set_num_threads(n_threads);
+
+        for (long n = 0; n < 50; n ++) {
+            if (results[0][n].kinetic_energy != results[1][n].kinetic_energy || results[0][n].potential_energy != results[1][n].potential_energy
+                    || results[0][n].linear_momentum != results[1][n].linear_momentum)
+                return EXIT_FAILURE;
+        }
+    }
+
+    // Rotational systems reduce the angular fields too
+    {
+        const double inertia = 0.4 * m * r_part * r_part;
+        const std::vector<Eigen::Vector3d> theta0(n_part, Eigen::Vector3d::Zero());
+        std::vector<Eigen::Vector3d> omega0(n_part);
+        for (long i = 0; i < n_part; i ++)
+            omega0[i] = Eigen::Vector3d(1.0, -2.0, 0.5) * double(i % 7);
+
+        RotationalSystem rotational_system(m, inertia, x0, x0, theta0, omega0);
+        rotational_system.diagnostics.enable(true);
+
+        for (long n = 0; n < 20; n ++)
+            rotational_system.do_step(dt);
+
+        double rotational_energy = 0.0;
+        Eigen::Vector3d angular_momentum = Eigen::Vector3d::Zero();
+        for (long i = 0; i < n_part; i ++) {
+            rotational_energy += 0.5 * inertia * rotational_system.get_omega()[i].squaredNorm();
+            angular_momentum += inertia * rotational_system.get_omega()[i] + rotational_system.get_x()[i].cross(m * rotational_system.get_v()[i]);
+        }
+
+        auto const & diagnostics = rotational_system.diagnostics.get_result();
+        if (!close(diagnostics.rotational_energy, rotational_energy) || (diagnostics.angular_momentum - angular_momentum).norm() > 1.0e-9)
+            return EXIT_FAILURE;
+    }
+
+    return 0;
+}
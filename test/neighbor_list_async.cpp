@@ -0,0 +1,179 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <random>
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <utility>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/binary_system_neighbors_omp.h>
+#include <libtimestep/packing/random_packing.h>
+
+// Granular system with spring-dashpot contacts and a constant attraction within 3 radii
+// The neighbor lists are built with a distance function that can be held, so that a background update
+// stays in flight for as long as the test needs
+class GranularSystem : public binary_system_neighbors_omp<Eigen::Vector3d, double, velocity_verlet_half_omp, step_handler, GranularSystem, false> {
+public:
+    GranularSystem(double k, double m, double g, double gamma_c, double r_part,
+                   std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0) :
+            binary_system_neighbors_omp<Eigen::Vector3d, double, velocity_verlet_half_omp, step_handler, GranularSystem, false>((long) x0.size(), 5.0 * r_part,
+                    x0, std::move(v0), 0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance),
+            k(k), m(m), g(g), gamma_c(gamma_c), r_part(r_part) {
+        // The lists are built here rather than by the base class, which cannot call compute_distance() yet
+        update_neighbor_list();
+    }
+
+    Eigen::Vector3d compute_acceleration(long i, long j,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v,
+                                         double t [[maybe_unused]]) {
+        Eigen::Vector3d distance = x[j] - x[i];
+        const double distance_norm = distance.norm();
+        const double overlap = distance_norm - 2.0 * r_part;
+        Eigen::Vector3d n = distance / distance_norm;
+
+        Eigen::Vector3d force = Eigen::Vector3d::Zero();
+        if (distance_norm < 3.0 * r_part)
+            force += m * g * n;
+        if (overlap < 0.0)
+            force += (k * overlap + gamma_c * (v[j] - v[i]).dot(n)) * n;
+
+        return force / m;
+    }
+
+    Eigen::Vector3d compute_acceleration(long i [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & x [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) {
+        return Eigen::Vector3d::Zero();
+    }
+
+    double compute_distance(Eigen::Vector3d const & x_i, Eigen::Vector3d const & x_j) {
+        while (held.load())
+            std::this_thread::yield();
+        return (x_i - x_j).norm();
+    }
+
+    std::atomic<bool> held = false;
+
+private:
+    const double k, m, g, gamma_c, r_part;
+
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+int main() {
+    const double dt = 0.001;                        // Integration time step
+    const long n_steps = 400;                       // Number of time steps
+    const long period = 20;                         // Number of steps between the neighbor list updates
+    const long n_part = 500;                        // Number of particles
+    const double r_part = 0.1;                      // Radius of a particle
+    const double k = 1000.0;                        // Elastic stiffness of a particle
+    const double m = 1.0;                           // Mass of a particle
+    const double g = 0.2;                           // Attraction acceleration between particles
+    const double gamma_c = 0.2;                     // Elastic (collision) damping coefficient
+
+    const std::vector<double> radii(n_part, r_part);
+    const double length = packing_box_length(radii, 0.2);
+    const auto x0 = random_packing(radii, Eigen::Vector3d::Zero().eval(), Eigen::Vector3d::Constant(length).eval(), 0);
+
+    std::mt19937_64 mt(0);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<Eigen::Vector3d> v0(n_part);
+    for (auto & v : v0)
+        v = {dist(mt), dist(mt), dist(mt)};
+
+    // Lists built in the background give the same trajectory as lists built synchronously from the same positions
+    // Lists swapped in late still contain every interacting pair, and the pairs outside of the interaction range
+    // add exact zeros, so the trajectories are identical
+    {
+        GranularSystem reference(k, m, g, gamma_c, r_part, x0, v0), system(k, m, g, gamma_c, r_part, x0, v0);
+
+        for (long n = 0; n < n_steps; n ++) {
+            if (n % period == 0) {
+                reference.update_neighbor_list();
+                system.begin_neighbor_list_update(2);
+            }
+
+            // The lists of every other update are swapped in as soon as they are ready, the others before the next step
+            if (n % (2 * period) == 0)
+                system.finish_neighbor_list_update();
+
+            reference.do_step(dt);
+            system.do_step(dt);
+        }
+        system.finish_neighbor_list_update();
+
+        if (system.get_x() != reference.get_x() || system.get_v() != reference.get_v())
+            return EXIT_FAILURE;
+
+        if (system.get_n_neighbor_list_updates() != reference.get_n_neighbor_list_updates())
+            return EXIT_FAILURE;
+    }
+
+    // The lists are not swapped in while they are being built
+    {
+        GranularSystem system(k, m, g, gamma_c, r_part, x0, v0);
+        const long n_updates = system.get_n_neighbor_list_updates();
+
+        system.held = true;
+        system.begin_neighbor_list_update();
+        if (system.try_finish_neighbor_list_update())
+            return EXIT_FAILURE;
+
+        // The force loop keeps using the current lists
+        for (long n = 0; n < 10; n ++)
+            system.do_step(dt);
+        if (system.try_finish_neighbor_list_update() || system.get_n_neighbor_list_updates() != n_updates)
+            return EXIT_FAILURE;
+
+        system.held = false;
+        system.finish_neighbor_list_update();
+        if (system.try_finish_neighbor_list_update() || system.get_n_neighbor_list_updates() != n_updates + 1)
+            return EXIT_FAILURE;
+    }
+
+    // A synchronous update made while a background update is in flight is not overwritten by the older lists
+    for (bool scheduled : {false, true}) {
+        GranularSystem reference(k, m, g, gamma_c, r_part, x0, v0), system(k, m, g, gamma_c, r_part, x0, v0);
+
+        system.held = true;
+        system.begin_neighbor_list_update();
+
+        // The particles move by about a third of the skin before the synchronous update
+        for (long n = 0; n < 100; n ++) {
+            reference.do_step(dt);
+            system.do_step(dt);
+        }
+
+        system.held = false;
+        if (scheduled) {
+            reference.schedule_neighbor_list_update();
+            system.schedule_neighbor_list_update();
+        } else {
+            reference.update_neighbor_list();
+            system.update_neighbor_list();
+        }
+
+        for (long n = 0; n < 100; n ++) {
+            reference.do_step(dt);
+            system.do_step(dt);
+        }
+        system.finish_neighbor_list_update();
+
+        if (system.get_x() != reference.get_x() || system.get_v() != reference.get_v())
+            return EXIT_FAILURE;
+
+        if (system.get_n_neighbor_list_updates() != reference.get_n_neighbor_list_updates())
+            return EXIT_FAILURE;
+    }
+
+    return 0;
+}
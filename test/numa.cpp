@@ -0,0 +1,158 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+#include <omp.h>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/binary_system_omp.h>
+#include <libtimestep/system/binary_system_neighbors_omp.h>
+#include <libtimestep/parallel/numa.h>
+#include <libtimestep/packing/random_packing.h>
+
+// Spring-dashpot contacts and a constant attraction within 3 radii
+struct GranularInteraction {
+    double k, m, g, gamma_c, r_part;
+
+    [[nodiscard]] Eigen::Vector3d acceleration(long i, long j,
+                                               std::vector<Eigen::Vector3d> const & x,
+                                               std::vector<Eigen::Vector3d> const & v) const {
+        Eigen::Vector3d distance = x[j] - x[i];
+        const double distance_norm = distance.norm();
+        const double overlap = distance_norm - 2.0 * r_part;
+        Eigen::Vector3d n = distance / distance_norm;
+
+        Eigen::Vector3d force = Eigen::Vector3d::Zero();
+        if (distance_norm < 3.0 * r_part)
+            force += m * g * n;
+        if (overlap < 0.0)
+            force += (k * overlap + gamma_c * (v[j] - v[i]).dot(n)) * n;
+
+        return force / m;
+    }
+};
+
+// Granular system that visits all pairs
+class GranularSystem : public binary_system_omp<Eigen::Vector3d, double, velocity_verlet_half_omp, step_handler, GranularSystem, false> {
+public:
+    GranularSystem(GranularInteraction interaction, std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0, bool first_touch) :
+            binary_system_omp<Eigen::Vector3d, double, velocity_verlet_half_omp, step_handler, GranularSystem, false>(std::move(x0), std::move(v0),
+                    0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance, first_touch), interaction(interaction) {}
+
+    Eigen::Vector3d compute_acceleration(long i, long j,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v,
+                                         double t [[maybe_unused]]) {
+        return interaction.acceleration(i, j, x, v);
+    }
+
+    Eigen::Vector3d compute_acceleration(long i [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & x [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) {
+        return Eigen::Vector3d::Zero();
+    }
+
+private:
+    const GranularInteraction interaction;
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+// Granular system that visits the pairs in the neighbor lists
+class GranularNeighborsSystem : public binary_system_neighbors_omp<Eigen::Vector3d, double, velocity_verlet_half_omp, step_handler, GranularNeighborsSystem, false> {
+public:
+    GranularNeighborsSystem(GranularInteraction interaction, std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0, bool first_touch) :
+            binary_system_neighbors_omp<Eigen::Vector3d, double, velocity_verlet_half_omp, step_handler, GranularNeighborsSystem, false>((long) x0.size(),
+                    5.0 * interaction.r_part, x0, std::move(v0), 0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance, first_touch),
+            interaction(interaction) {}
+
+    Eigen::Vector3d compute_acceleration(long i, long j,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v,
+                                         double t [[maybe_unused]]) {
+        return interaction.acceleration(i, j, x, v);
+    }
+
+    Eigen::Vector3d compute_acceleration(long i [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & x [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) {
+        return Eigen::Vector3d::Zero();
+    }
+
+private:
+    const GranularInteraction interaction;
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+int main() {
+    const double dt = 0.001;                        // Integration time step
+    const long n_steps = 100;                       // Number of time steps
+    const long n_part = 1000;                       // Number of particles
+    const GranularInteraction interaction {1000.0, 1.0, 0.2, 0.2, 0.1};
+
+    const int n_threads = omp_get_max_threads();
+    omp_set_num_threads(4);
+
+    // Threads are pinned, or the failure is reported without affecting the rest of the program
+    const bool pinned = pin_threads(thread_affinity::spread);
+    std::cout << "Pinning threads " << (pinned ? "succeeded" : "failed") << std::endl;
+
+    // Buffers initialized by the owning threads have the same values as buffers initialized by one thread
+    const std::vector<double> radii(n_part, interaction.r_part);
+    const double length = packing_box_length(radii, 0.2);
+    const auto x0 = random_packing(radii, Eigen::Vector3d::Zero().eval(), Eigen::Vector3d::Constant(length).eval(), 0);
+
+    if (first_touch_copy(x0) != x0)
+        return EXIT_FAILURE;
+
+    const auto v0 = first_touch_buffer<std::vector<Eigen::Vector3d>>(n_part, Eigen::Vector3d(0.1, -0.2, 0.3));
+    if (std::any_of(v0.begin(), v0.end(), [] (auto const & v) { return v != Eigen::Vector3d(0.1, -0.2, 0.3); }))
+        return EXIT_FAILURE;
+
+    if (!first_touch_copy(std::vector<Eigen::Vector3d>()).empty())
+        return EXIT_FAILURE;
+
+    // The placement of the buffers does not change the trajectories
+    {
+        GranularSystem system(interaction, x0, v0, false), first_touch_system(interaction, x0, v0, true);
+        for (long n = 0; n < n_steps; n ++) {
+            system.do_step(dt);
+            first_touch_system.do_step(dt);
+        }
+
+        if (system.get_x() != first_touch_system.get_x() || system.get_v() != first_touch_system.get_v())
+            return EXIT_FAILURE;
+    }
+
+    {
+        GranularNeighborsSystem system(interaction, x0, v0, false), first_touch_system(interaction, x0, v0, true);
+        system.update_neighbor_list();
+        for (long n = 0; n < n_steps; n ++) {
+            if (n % 20 == 0) {
+                system.update_neighbor_list();
+                first_touch_system.update_neighbor_list();
+            }
+            system.do_step(dt);
+            first_touch_system.do_step(dt);
+        }
+
+        if (system.get_x() != first_touch_system.get_x() || system.get_v() != first_touch_system.get_v())
+            return EXIT_FAILURE;
+    }
+
+    if (!pin_threads(thread_affinity::none) && pinned)
+        return EXIT_FAILURE;
+
+    omp_set_num_threads(n_threads);
+
+    return 0;
+}
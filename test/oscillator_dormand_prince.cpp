@@ -0,0 +1,125 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <iostream>
+#include <cmath>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/unary_system.h>
+
+// Implement a unary second-order system
+class OscillatorSystem : public unary_system<double, double, dormand_prince, step_handler, OscillatorSystem> {
+public:
+    OscillatorSystem(double k, double m, double gamma_d,
+                     std::vector<double> x0, std::vector<double> v0, double t0) :
+            unary_system<double, double, dormand_prince, step_handler, OscillatorSystem>(std::move(x0), std::move(v0), t0, 0.0, 0.0, *this, step_handler_instance),
+            k(k), m(m), gamma_d(gamma_d) {}
+
+    double compute_acceleration(size_t i,
+                                std::vector<double> const & x [[maybe_unused]],
+                                std::vector<double> const & v [[maybe_unused]],
+                                double t [[maybe_unused]]) {
+        auto const & x_i = this->get_x()[i];
+        auto const & v_i = this->get_v()[i];
+
+        return 1.0 / this->m * (1.0 - this->gamma_d * v_i - this->k * x_i);
+    }
+
+private:
+    step_handler<std::vector<double>, double> step_handler_instance;
+    const double k, m, gamma_d;
+};
+
+int main() {
+    const double dt = 0.1; // Output interval
+    const double t_tot = 5.0; // Integration span
+    const double k = 10.0; // Stiffness
+    const double m = 1.0; // Mass
+    const double gamma_d = 2.0 * sqrt(m * k); // Critically damped system
+    const double omega_0 = sqrt(k / m); // Natural angular frequency
+    const auto n_steps = size_t(t_tot / dt); // Number of output intervals
+
+    auto x_exact = [omega_0, k] (double t) {
+        return 1.0 / k * (1.0 - exp(-omega_0 * t) * (omega_0 * t + 1.0));
+    };
+
+    // Integrate with the given tolerances, returns the largest error at the output times and the number of evaluations
+    auto solve = [&] (double tolerance) {
+        OscillatorSystem oscillator(k, m, gamma_d, {0.0}, {0.0}, 0.0);
+        oscillator.get_integrator().set_tolerances(tolerance, tolerance);
+
+        double error = 0.0;
+        for (size_t n = 1; n < n_steps + 1; n ++) {
+            oscillator.do_step(dt);
+            error = std::max(error, std::abs(oscillator.get_x()[0] - x_exact(dt * double(n))));
+        }
+
+        if (std::abs(oscillator.get_integrator().get_t() - t_tot) > 1e-12)
+            error = INFINITY;
+
+        return std::make_pair(error, oscillator.get_integrator().get_n_evaluations());
+    };
+
+    auto [loose_error, loose_evaluations] = solve(1e-4);
+    auto [tight_error, tight_evaluations] = solve(1e-9);
+
+    std::cout << "Tolerance 1e-4: error " << loose_error << ", " << loose_evaluations << " evaluations" << std::endl;
+    std::cout << "Tolerance 1e-9: error " << tight_error << ", " << tight_evaluations << " evaluations" << std::endl;
+
+    if (loose_error > 1e-4 || tight_error > 1e-8 || loose_evaluations >= tight_evaluations)
+        return EXIT_FAILURE;
+
+    // Output at fixed times from the dense output of free adaptive steps
+    OscillatorSystem oscillator(k, m, gamma_d, {0.0}, {0.0}, 0.0);
+    auto & integrator = oscillator.get_integrator();
+    integrator.set_tolerances(1e-9, 1e-9);
+
+    std::vector<double> x_out(1), v_out(1);
+    double dense_error = 0.0;
+    size_t n = 1;
+    while (n < n_steps + 1) {
+        integrator.do_adaptive_step();
+
+        for (; n < n_steps + 1 && dt * double(n) <= integrator.get_t(); n ++) {
+            integrator.interpolate(dt * double(n), x_out, v_out);
+            dense_error = std::max(dense_error, std::abs(x_out[0] - x_exact(dt * double(n))));
+        }
+    }
+
+    std::cout << "Dense output: error " << dense_error << ", " << integrator.get_n_evaluations() << " evaluations" << std::endl;
+
+    if (dense_error > 1e-7 || integrator.get_n_evaluations() >= tight_evaluations)
+        return EXIT_FAILURE;
+
+    // Output intervals only add the steps shortened to end at the output times, an interval much shorter than the
+    // steps does not shrink the steps that follow it
+    {
+        const double output_interval = 0.5;
+        const double short_interval = 1e-6;
+        const long n_outputs = long(std::lround(t_tot / output_interval));
+
+        OscillatorSystem single_oscillator(k, m, gamma_d, {0.0}, {0.0}, 0.0), output_oscillator(k, m, gamma_d, {0.0}, {0.0}, 0.0);
+        single_oscillator.get_integrator().set_tolerances(1e-9, 1e-9);
+        output_oscillator.get_integrator().set_tolerances(1e-9, 1e-9);
+
+        single_oscillator.do_step(t_tot);
+        for (long n = 0; n < n_outputs; n ++) {
+            output_oscillator.do_step(output_interval - short_interval);
+            output_oscillator.do_step(short_interval);
+        }
+
+        const long single_evaluations = single_oscillator.get_integrator().get_n_evaluations();
+        const long output_evaluations = output_oscillator.get_integrator().get_n_evaluations();
+        std::cout << "Output every " << output_interval << ": " << output_evaluations << " evaluations, "
+                  << single_evaluations << " without output" << std::endl;
+
+        // Every call to do_step() may end with one shortened step of 6 evaluations
+        if (output_evaluations > single_evaluations + 6 * 2 * n_outputs)
+            return EXIT_FAILURE;
+    }
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <iostream>
+#include <cmath>
+#include <utility>
+#include <limits>
+
+#include <omp.h>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/unary_system.h>
+#include <libtimestep/system/binary_system_omp.h>
+
+// Critically damped oscillator under a unit step force that can be integrated with any integrator
+template <
+    template <
+        typename _field_container_t,
+        typename _field_value_t,
+        typename _real_t,
+        typename _functor_t,
+        template <
+            typename __field_container_t,
+            typename __field_value_t>
+        typename _step_handler_t>
+    typename integrator_t>
+class OscillatorSystem : public unary_system<double, double, integrator_t, step_handler, OscillatorSystem<integrator_t>> {
+public:
+    OscillatorSystem(double k, double m, double gamma_d,
+                     std::vector<double> x0, std::vector<double> v0, double t0) :
+            unary_system<double, double, integrator_t, step_handler, OscillatorSystem<integrator_t>>(std::move(x0), std::move(v0), t0, 0.0, 0.0, *this, step_handler_instance),
+            k(k), m(m), gamma_d(gamma_d) {}
+
+    double compute_acceleration(size_t i,
+                                std::vector<double> const & x [[maybe_unused]],
+                                std::vector<double> const & v [[maybe_unused]],
+                                double t [[maybe_unused]]) {
+        auto const & x_i = this->get_x()[i];
+        auto const & v_i = this->get_v()[i];
+
+        return 1.0 / this->m * (1.0 - this->gamma_d * v_i - this->k * x_i);
+    }
+
+    // Local Jacobians of the acceleration with respect to position and velocity
+    std::pair<double, double> compute_jacobian(long i [[maybe_unused]],
+                                               std::vector<double> const & x [[maybe_unused]],
+                                               std::vector<double> const & v [[maybe_unused]],
+                                               double t [[maybe_unused]]) const {
+        return {-this->k / this->m, -this->gamma_d / this->m};
+    }
+
+private:
+    step_handler<std::vector<double>, double> step_handler_instance;
+    const double k, m, gamma_d;
+};
+
+// Chain of particles, each joined to the next one by a stiff, strongly damped spring
+class ChainSystem : public binary_system_omp<Eigen::Vector3d, double, linearly_implicit_euler, step_handler, ChainSystem, false> {
+public:
+    ChainSystem(double k, double m, double gamma_c, double l0,
+                std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0, double t0) :
+            binary_system_omp<Eigen::Vector3d, double, linearly_implicit_euler, step_handler, ChainSystem, false>(std::move(x0),
+                    std::move(v0), t0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance),
+            k(k), m(m), gamma_c(gamma_c), l0(l0) {}
+
+    Eigen::Vector3d compute_acceleration(long i, long j,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v,
+                                         double t [[maybe_unused]]) const {
+        if (std::abs(i - j) != 1)
+            return Eigen::Vector3d::Zero();
+
+        Eigen::Vector3d distance = x[j] - x[i];
+        Eigen::Vector3d n = distance.normalized();
+
+        return (k * (distance.norm() - l0) + gamma_c * (v[j] - v[i]).dot(n)) * n / m;
+    }
+
+    // Local Jacobians of the acceleration of particle i with respect to its own position and velocity
+    std::pair<Eigen::Matrix3d, Eigen::Matrix3d> compute_jacobian(long i, long j,
+                                                                 std::vector<Eigen::Vector3d> const & x,
+                                                                 std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                                                 double t [[maybe_unused]]) const {
+        if (std::abs(i - j) != 1)
+            return {Eigen::Matrix3d::Zero(), Eigen::Matrix3d::Zero()};
+
+        Eigen::Vector3d distance = x[j] - x[i];
+        double distance_norm = distance.norm();
+        Eigen::Vector3d n = distance / distance_norm;
+        Eigen::Matrix3d nn = n * n.transpose();
+
+        // Stiffness along the bond and the geometric stiffness of the stretched spring across it
+        Eigen::Matrix3d da_dx = -(k * nn + k * (1.0 - l0 / distance_norm) * (Eigen::Matrix3d::Identity() - nn)) / m;
+        Eigen::Matrix3d da_dv = -gamma_c * nn / m;
+
+        return {da_dx, da_dv};
+    }
+
+private:
+    const double k, m, gamma_c, l0;
+
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+// Integrates the oscillator over t_tot, returns the largest deviation from the exact solution
+template <
+    template <
+        typename _field_container_t,
+        typename _field_value_t,
+        typename _real_t,
+        typename _functor_t,
+        template <
+            typename __field_container_t,
+            typename __field_value_t>
+        typename _step_handler_t>
+    typename integrator_t>
+double solve_oscillator(double k, double dt) {
+    const double t_tot = 5.0; // Integration span
+    const double m = 1.0; // Mass
+    const double gamma_d = 2.0 * sqrt(m * k); // Critically damped system
+    const double omega_0 = sqrt(k / m); // Natural angular frequency
+    const auto n_steps = size_t(t_tot / dt); // Number of integration time steps
+
+    OscillatorSystem<integrator_t> oscillator(k, m, gamma_d, {0.0}, {0.0}, 0.0);
+
+    double max_error = 0.0;
+    for (size_t n = 1; n < n_steps+1; n ++) {
+        double t = dt * double(n);
+        oscillator.do_step(dt);
+
+        double x_exact = 1.0 / k * (1.0 - exp(-omega_0 * t) * (omega_0 * t + 1.0));
+        max_error = std::max(max_error, std::abs(oscillator.get_x()[0] - x_exact));
+    }
+
+    return max_error;
+}
+
+int main() {
+    // Soft oscillator with the time step of test/oscillator.cpp, where both schemes are stable
+    const double soft_error = solve_oscillator<linearly_implicit_euler>(10.0, 0.1);
+    std::cout << "Soft oscillator, largest error: " << soft_error << std::endl;
+
+    if (soft_error > 0.005)
+        return EXIT_FAILURE;
+
+    // Stiff oscillator with a time step five times larger than 1 / omega_0, the transient is not resolved
+    // but the solution stays bounded and relaxes to the exact one
+    const double k_stiff = 1.0e4;
+    const double stiff_error = solve_oscillator<linearly_implicit_euler>(k_stiff, 0.05);
+    const double stiff_error_explicit = solve_oscillator<forward_euler>(k_stiff, 0.05);
+    std::cout << "Stiff oscillator, largest error: " << stiff_error << " (forward Euler: " << stiff_error_explicit << ")" << std::endl;
+
+    if (stiff_error > 0.3 / k_stiff)
+        return EXIT_FAILURE;
+
+    // Forward Euler is unstable with this time step
+    if (!(stiff_error_explicit > 1.0 / k_stiff))
+        return EXIT_FAILURE;
+
+    // Stretched and rotating dimer, the time step is four times larger than 1 / omega_0 of the bond
+    const double k = 1.0e5, m = 1.0, gamma_c = 2.0 * sqrt(m * k), l0 = 1.0;
+    ChainSystem dimer(k, m, gamma_c, l0, {{0.0, 0.0, 0.0}, {1.5, 0.2, 0.0}}, {{0.0, 0.0, 1.0}, {0.0, 0.0, -1.0}}, 0.0);
+
+    for (long n = 0; n < 2000; n ++)
+        dimer.do_step(0.01);
+
+    const double bond_length = (dimer.get_x()[1] - dimer.get_x()[0]).norm();
+    const Eigen::Vector3d momentum = dimer.get_v()[0] + dimer.get_v()[1];
+    std::cout << "Dimer bond length: " << bond_length << ", momentum: " << momentum.norm() << std::endl;
+
+    if (std::abs(bond_length - l0) > 1e-3 * l0)
+        return EXIT_FAILURE;
+
+    if (momentum.norm() > 1e-9)
+        return EXIT_FAILURE;
+
+    // Long chain, the Jacobians are computed on all threads with the same result as on one thread
+    {
+        std::vector<Eigen::Vector3d> x0, v0;
+        for (long i = 0; i < 400; i ++) {
+            x0.emplace_back(1.2 * double(i), 0.1 * double(i % 3), 0.0);
+            v0.emplace_back(0.0, 0.0, i % 2 == 0 ? 1.0 : -1.0);
+        }
+
+        ChainSystem chain(k, m, gamma_c, l0, x0, v0, 0.0), serial_chain(k, m, gamma_c, l0, x0, v0, 0.0);
+        chain.set_parallel_thresholds({1, 1});
+        serial_chain.set_parallel_thresholds({std::numeric_limits<long>::max(), std::numeric_limits<long>::max()});
+
+        const int n_threads = omp_get_max_threads();
+        omp_set_num_threads(4);
+        for (long n = 0; n < 20; n ++) {
+            chain.do_step(0.01);
+            serial_chain.do_step(0.01);
+        }
+        omp_set_num_threads(n_threads);
+
+        if (chain.get_x() != serial_chain.get_x() || chain.get_v() != serial_chain.get_v())
+            return EXIT_FAILURE;
+    }
+
+    return 0;
+}
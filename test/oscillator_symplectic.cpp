@@ -0,0 +1,110 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <iostream>
+#include <cmath>
+#include <string>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/unary_system.h>
+
+// Undamped oscillator under a constant force that can be integrated with any of the splitting schemes
+template <
+    template <
+        typename _field_container_t,
+        typename _field_value_t,
+        typename _real_t,
+        typename _functor_t,
+        template <
+            typename __field_container_t,
+            typename __field_value_t>
+        typename _step_handler_t>
+    typename integrator_t>
+class OscillatorSystem : public unary_system<double, double, integrator_t, step_handler, OscillatorSystem<integrator_t>> {
+public:
+    OscillatorSystem(double k, double m, std::vector<double> x0, std::vector<double> v0, double t0) :
+            unary_system<double, double, integrator_t, step_handler, OscillatorSystem<integrator_t>>(std::move(x0), std::move(v0), t0, 0.0, 0.0, *this, step_handler_instance),
+            k(k), m(m) {}
+
+    double compute_acceleration(size_t i,
+                                std::vector<double> const & x [[maybe_unused]],
+                                std::vector<double> const & v [[maybe_unused]],
+                                double t [[maybe_unused]]) {
+        n_evaluations ++;
+
+        return 1.0 / this->m * (1.0 - this->k * this->get_x()[i]);
+    }
+
+    long n_evaluations = 0;
+
+private:
+    step_handler<std::vector<double>, double> step_handler_instance;
+    const double k, m;
+};
+
+// Integrates the oscillator over t_tot with time step dt, returns the error of the final position and the number of evaluations
+template <
+    template <
+        typename _field_container_t,
+        typename _field_value_t,
+        typename _real_t,
+        typename _functor_t,
+        template <
+            typename __field_container_t,
+            typename __field_value_t>
+        typename _step_handler_t>
+    typename integrator_t>
+std::pair<double, long> solve(double dt) {
+    const double t_tot = 5.0; // Integration span
+    const double k = 10.0; // Stiffness
+    const double m = 1.0; // Mass
+    const double omega_0 = sqrt(k / m); // Natural angular frequency
+
+    OscillatorSystem<integrator_t> oscillator(k, m, {0.0}, {0.0}, 0.0);
+    for (long n = 0; n < std::lround(t_tot / dt); n ++)
+        oscillator.do_step(dt);
+
+    const double x_exact = 1.0 / k * (1.0 - cos(omega_0 * t_tot));
+    return std::make_pair(std::abs(oscillator.get_x()[0] - x_exact), oscillator.n_evaluations);
+}
+
+// Checks that the error of the scheme decreases with the time step at least as fast as its order
+template <
+    template <
+        typename _field_container_t,
+        typename _field_value_t,
+        typename _real_t,
+        typename _functor_t,
+        template <
+            typename __field_container_t,
+            typename __field_value_t>
+        typename _step_handler_t>
+    typename integrator_t>
+bool check_order(std::string const & name, double expected_order) {
+    auto [coarse_error, coarse_evaluations] = solve<integrator_t>(0.05);
+    auto [fine_error, fine_evaluations] = solve<integrator_t>(0.025);
+    const double order = log2(coarse_error / fine_error);
+
+    std::cout << name << ": error " << coarse_error << " with " << coarse_evaluations << " evaluations, "
+              << fine_error << " with " << fine_evaluations << " evaluations, order " << order << std::endl;
+
+    return order > expected_order - 0.2;
+}
+
+int main() {
+    bool success = true;
+
+    success &= check_order<forest_ruth>("Forest-Ruth", 4.0);
+    success &= check_order<yoshida_4>("Yoshida", 4.0);
+    success &= check_order<omelyan_pefrl>("Omelyan PEFRL", 4.0);
+    success &= check_order<omelyan_2>("Omelyan 2nd order", 2.0);
+
+    // The optimized fourth order scheme is more accurate than Forest-Ruth with the same number of evaluations
+    if (solve<omelyan_pefrl>(0.1).first > solve<forest_ruth>(0.075).first)
+        success = false;
+
+    return success ? 0 : EXIT_FAILURE;
+}
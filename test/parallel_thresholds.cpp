@@ -0,0 +1,118 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <iostream>
+#include <atomic>
+#include <limits>
+#include <cstdlib>
+#include <utility>
+
+#include <omp.h>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/binary_system_omp.h>
+#include <libtimestep/parallel/parallel_thresholds.h>
+
+// Particles connected by weak springs, which count the interactions computed inside of a parallel region
+class SpringSystem : public binary_system_omp<Eigen::Vector3d, double, velocity_verlet_half_omp, step_handler, SpringSystem, false> {
+public:
+    SpringSystem(std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0) :
+            binary_system_omp<Eigen::Vector3d, double, velocity_verlet_half_omp, step_handler, SpringSystem, false>(std::move(x0), std::move(v0),
+                    0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance) {}
+
+    Eigen::Vector3d compute_acceleration(long i, long j,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) {
+        if (omp_in_parallel())
+            n_parallel_interactions ++;
+
+        return 0.01 * (x[j] - x[i]);
+    }
+
+    Eigen::Vector3d compute_acceleration(long i [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & x [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) {
+        return Eigen::Vector3d::Zero();
+    }
+
+    std::atomic<long> n_parallel_interactions = 0;
+
+private:
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+int main() {
+    const double dt = 0.01;         // Integration time step
+    const long n_steps = 10;        // Number of time steps
+    const long n_part = 10;         // Number of particles
+    constexpr long never = std::numeric_limits<long>::max();
+
+    // Only non-negative decimal numbers are accepted as thresholds
+    for (auto [value, expected] : {std::pair("0", 0L), std::pair("42", 42L)}) {
+        long threshold = -1;
+        if (!parse_parallel_threshold(value, threshold) || threshold != expected)
+            return EXIT_FAILURE;
+    }
+
+    for (char const * value : {(char const *) nullptr, "", "abc", "-5", "12x", " 7", "99999999999999999999999"}) {
+        long threshold = -1;
+        if (parse_parallel_threshold(value, threshold) || threshold != -1)
+            return EXIT_FAILURE;
+    }
+
+    // A valid override is used, an invalid one falls back to the calibrated threshold
+    // The variables are set before the default thresholds are read for the first time
+    setenv("LIBTIMESTEP_PARALLEL_MIN_PARTICLES", "123", 1);
+    setenv("LIBTIMESTEP_PARALLEL_MIN_PAIRS", "garbage", 1);
+
+    const int n_threads = omp_get_max_threads();
+    omp_set_num_threads(4);
+
+    const parallel_thresholds defaults = default_parallel_thresholds();
+    std::cout << "Default thresholds: " << defaults.min_particles << " particles, " << defaults.min_pairs << " pairs" << std::endl;
+    if (defaults.min_particles != 123 || defaults.min_pairs <= 0)
+        return EXIT_FAILURE;
+
+    // Calibration gives positive thresholds, which are never reached with a single thread
+    const parallel_thresholds calibrated = calibrate_parallel_thresholds();
+    if (calibrated.min_particles <= 0 || calibrated.min_pairs <= 0)
+        return EXIT_FAILURE;
+
+    omp_set_num_threads(1);
+    const parallel_thresholds single_thread = calibrate_parallel_thresholds();
+    if (single_thread.min_particles != never || single_thread.min_pairs != never)
+        return EXIT_FAILURE;
+    omp_set_num_threads(4);
+
+    // A system below the thresholds computes all interactions serially, and in parallel once the thresholds are lowered
+    std::vector<Eigen::Vector3d> x0(n_part), v0(n_part, Eigen::Vector3d::Zero());
+    for (long i = 0; i < n_part; i ++)
+        x0[i] = {double(i), double(i % 3), double(i % 5)};
+
+    SpringSystem system(x0, v0);
+    if (system.get_parallel_thresholds().min_particles != 123)
+        return EXIT_FAILURE;
+
+    system.set_parallel_thresholds({n_part + 1, n_part * n_part});
+    for (long n = 0; n < n_steps; n ++)
+        system.do_step(dt);
+    if (system.use_parallel_execution() || system.n_parallel_interactions != 0)
+        return EXIT_FAILURE;
+
+    system.set_parallel_thresholds({1, 1});
+    for (long n = 0; n < n_steps; n ++)
+        system.do_step(dt);
+    if (!system.use_parallel_execution() || system.n_parallel_interactions == 0)
+        return EXIT_FAILURE;
+
+    omp_set_num_threads(n_threads);
+
+    return 0;
+}
@@ -0,0 +1,229 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <iostream>
+#include <cmath>
+#include <atomic>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/binary_system_neighbors_omp.h>
+
+// Dilute granular gas without damping, integrated with block time steps
+// Most particles are nearly at rest and only a few fast particles collide with them
+class GranularSystem : public binary_system_neighbors_omp<Eigen::Vector3d, double, block_velocity_verlet, step_handler, GranularSystem, false> {
+public:
+    GranularSystem(double k, double m, double r_part, bool uniform_steps,
+                   std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0, double t0, size_t n_part) :
+            binary_system_neighbors_omp<Eigen::Vector3d, double, block_velocity_verlet, step_handler, GranularSystem, false>(n_part, 5.0 * r_part, std::move(x0), std::move(v0),
+                    t0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance),
+            k(k), m(m), r_part(r_part), uniform_steps(uniform_steps) {}
+
+    // Compute the acceleration of particle i due to its contact with particle j
+    Eigen::Vector3d compute_acceleration(long i, long j,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) {
+        n_pair_evaluations.fetch_add(1, std::memory_order_relaxed);
+
+        Eigen::Vector3d distance = x[j] - x[i];
+        double overlap = distance.norm() - 2.0 * r_part;
+
+        if (overlap >= 0.0)
+            return Eigen::Vector3d::Zero();
+
+        return k * overlap * distance.normalized() / m;
+    }
+
+    // Particles in contact, or about to collide, take a step resolving the contact oscillation
+    // The other particles take the largest step
+    double compute_time_step(long i,
+                             std::vector<Eigen::Vector3d> const & x,
+                             std::vector<Eigen::Vector3d> const & v) const {
+        if (uniform_steps)
+            return 0.0;
+
+        const double contact_step = 0.02 * std::sqrt(m / k);
+        double step = INFINITY;
+
+        for (long j = 0; j < (long) x.size(); j ++) {
+            if (i == j)
+                continue;
+
+            const double gap = (x[j] - x[i]).norm() - 2.0 * r_part;
+            const double approach_speed = -(v[j] - v[i]).dot((x[j] - x[i]).normalized());
+
+            if (gap < 0.0)
+                step = std::min(step, contact_step);
+            else if (approach_speed > 0.0)
+                step = std::min(step, std::max(0.5 * gap / approach_speed, contact_step));
+        }
+
+        return step;
+    }
+
+    // Compute the total (kinetic and potential) energy of the system
+    [[nodiscard]] double compute_energy() const {
+        double energy = 0.0;
+        for (long i = 0; i < (long) this->get_x().size(); i ++) {
+            energy += 0.5 * m * this->get_v()[i].squaredNorm();
+
+            for (long j = i + 1; j < (long) this->get_x().size(); j ++) {
+                double overlap = (this->get_x()[j] - this->get_x()[i]).norm() - 2.0 * r_part;
+                if (overlap < 0.0)
+                    energy += 0.5 * k * overlap * overlap;
+            }
+        }
+        return energy;
+    }
+
+    std::atomic<long> n_pair_evaluations = 0;
+
+private:
+    const double k, m, r_part;
+    const bool uniform_steps;
+
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+// Distant particles, of which the odd ones are tied to the origin by springs and the even ones move freely
+// The levels are chosen by the acceleration based criterion of the integrator
+class TetheredSystem : public binary_system_neighbors_omp<Eigen::Vector3d, double, block_velocity_verlet, step_handler, TetheredSystem, true> {
+public:
+    TetheredSystem(std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0, size_t n_part) :
+            binary_system_neighbors_omp<Eigen::Vector3d, double, block_velocity_verlet, step_handler, TetheredSystem, true>(n_part, 0.5, std::move(x0), std::move(v0),
+                    0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance) {}
+
+    Eigen::Vector3d compute_acceleration(long i [[maybe_unused]], long j [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & x [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) {
+        return Eigen::Vector3d::Zero();
+    }
+
+    Eigen::Vector3d compute_acceleration(long i,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) {
+        return i % 2 == 1 ? Eigen::Vector3d(-x[i]) : Eigen::Vector3d::Zero();
+    }
+
+private:
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+bool do_overlap(std::vector<Eigen::Vector3d> const & particles, Eigen::Vector3d const & x, double r_part) {
+    return std::any_of(particles.begin(), particles.end(), [&x, r_part] (auto const & particle) -> bool {
+        return (particle - x).norm() <= 2.0 * r_part;
+    });
+}
+
+int main() {
+    const double dt = 0.008;                        // Largest integration time step
+    const int max_level = 4;                        // Smallest time step is dt / 16
+    const double t_tot = 2.0;                       // Duration of the simulation
+    const auto n_steps = long(t_tot / dt);        // Number of time steps
+    const double r_part = 0.1;                      // Radius of a particle
+    const double k = 1000.0;                        // Elastic stiffness of a particle
+    const double m = 1.0;                           // Mass of a particle
+    const long n_fast = 5;                          // Number of fast particles
+
+    const long seed = 0;                          // Deterministic seed for pRNG for reproducibility
+
+    std::vector<Eigen::Vector3d> x0, v0;
+
+    std::mt19937_64 mt(seed);
+    std::uniform_real_distribution<double> dist(-2.0, 2.0);
+    std::normal_distribution<double> velocity_dist(0.0, 1.0);
+    for (long i = 0; i < 200; i ++) {
+        Eigen::Vector3d x_part;
+        do {
+            x_part = {dist(mt), dist(mt), dist(mt)};
+        } while (do_overlap(x0, x_part, r_part));
+        x0.emplace_back(x_part);
+
+        Eigen::Vector3d v_part = {velocity_dist(mt), velocity_dist(mt), velocity_dist(mt)};
+        v0.emplace_back(v_part * (i < n_fast ? 3.0 : 0.01));
+    }
+
+    GranularSystem block_system(k, m, r_part, false, x0, v0, 0.0, x0.size());
+    GranularSystem uniform_system(k, m, r_part, true, x0, v0, 0.0, x0.size());
+    block_system.get_integrator().set_max_level(max_level);
+    uniform_system.get_integrator().set_max_level(max_level);
+
+    const double initial_energy = block_system.compute_energy();
+
+    for (long n = 0; n < n_steps; n ++) {
+        if (n % 5 == 0) {
+            block_system.update_neighbor_list();
+            uniform_system.update_neighbor_list();
+        }
+        block_system.do_step(dt);
+        uniform_system.do_step(dt);
+    }
+
+    double max_deviation = 0.0;
+    for (long i = 0; i < (long) x0.size(); i ++)
+        max_deviation = std::max(max_deviation, (block_system.get_x()[i] - uniform_system.get_x()[i]).norm());
+
+    const double energy_error = std::abs(block_system.compute_energy() - initial_energy) / initial_energy;
+    const double evaluation_ratio = double(block_system.n_pair_evaluations) / double(uniform_system.n_pair_evaluations);
+
+    std::cout << "Largest deviation from uniform steps: " << max_deviation << std::endl;
+    std::cout << "Relative energy error: " << energy_error << std::endl;
+    std::cout << "Pair evaluations relative to uniform steps: " << evaluation_ratio << std::endl;
+
+    // Both integrations must follow the same trajectories
+    if (max_deviation > 1e-2 * r_part)
+        return EXIT_FAILURE;
+
+    if (energy_error > 1e-3)
+        return EXIT_FAILURE;
+
+    // Only the active particles are evaluated, which is a small fraction of the particles
+    if (evaluation_ratio > 0.25)
+        return EXIT_FAILURE;
+
+    // Particles without acceleration take the largest step, tethered particles take smaller ones
+    {
+        std::vector<Eigen::Vector3d> x_tethered, v_tethered;
+        for (long i = 0; i < 8; i ++) {
+            x_tethered.emplace_back(double(i + 1), 0.0, 0.0);
+            v_tethered.emplace_back(0.0, 0.01, 0.0);
+        }
+
+        TetheredSystem tethered_system(x_tethered, v_tethered, x_tethered.size());
+        tethered_system.get_integrator().set_max_level(max_level);
+
+        // The number of ticks of the deepest level has to fit in a long
+        for (int invalid_max_level : {-1, 63}) {
+            try {
+                tethered_system.get_integrator().set_max_level(invalid_max_level);
+                std::cout << "The deepest level was not checked" << std::endl;
+                return EXIT_FAILURE;
+            } catch (InvalidArgumentException const &) {}
+        }
+
+        if (tethered_system.get_integrator().get_max_level() != max_level)
+            return EXIT_FAILURE;
+        tethered_system.update_neighbor_list();
+
+        for (long n = 0; n < 3; n ++) {
+            tethered_system.do_step(1.0);
+
+            auto const & levels = tethered_system.get_integrator().get_levels();
+            for (long i = 0; i < (long) levels.size(); i ++) {
+                if (i % 2 == 0 ? levels[i] != 0 : levels[i] == 0)
+                    return EXIT_FAILURE;
+            }
+        }
+    }
+
+    return 0;
+}
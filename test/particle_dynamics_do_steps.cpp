@@ -0,0 +1,146 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <iostream>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/binary_system_neighbors_omp.h>
+
+#include "compute_energy.h"
+
+// Binary granular system where both the contact and the attraction have a finite range
+class GranularSystem : public binary_system_neighbors_omp<Eigen::Vector3d, double, velocity_verlet_half, step_handler, GranularSystem, false> {
+public:
+    GranularSystem(double k, double m, double g, double gamma_c, double r_part, double r_cutoff,
+                   std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0, double t0, size_t n_part) :
+            binary_system_neighbors_omp<Eigen::Vector3d, double, velocity_verlet_half, step_handler, GranularSystem, false>(n_part, 5.0 * r_part, std::move(x0), std::move(v0),
+                                                                                       t0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance),
+                    k(k), m(m), g(g), gamma_c(gamma_c), r_part(r_part), r_cutoff(r_cutoff) {}
+
+    // Compute the acceleration of particle i due to its interaction with particle j
+    Eigen::Vector3d compute_acceleration(long i, long j,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v,
+                                         double t [[maybe_unused]]) {
+        Eigen::Vector3d distance = x[j] - x[i];
+        double distance_norm = distance.norm();
+
+        if (distance_norm >= r_cutoff)
+            return Eigen::Vector3d::Zero();
+
+        Eigen::Vector3d n = distance / distance_norm;
+        Eigen::Vector3d force = g * n;
+
+        double overlap = distance_norm - 2.0 * r_part;
+        if (overlap < 0.0)
+            force += (k * overlap + gamma_c * (v[j] - v[i]).dot(n)) * n;
+
+        return force / m;
+    }
+
+    Eigen::Vector3d compute_acceleration(long i [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & x [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) {
+
+        return Eigen::Vector3d::Zero();
+    }
+
+private:
+    const double k, m, g, gamma_c, r_part, r_cutoff;
+
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+bool do_overlap(std::vector<Eigen::Vector3d> const & particles, Eigen::Vector3d const & x, double r_part) {
+    return std::any_of(particles.begin(), particles.end(), [&x, r_part] (auto const & particle) -> bool {
+        return (particle - x).norm() <= 2.0 * r_part;
+    });
+}
+
+int main() {
+    const double dt = 0.001;                        // Integration time step
+    const long n_steps = 10000;                     // Number of time steps
+    const double r_part = 0.1;                      // Radius of a particle
+    const double r_cutoff = 4.0 * r_part;           // Range of the attraction
+    const double k = 1000.0;                        // Elastic stiffness of a particle
+    const double m = 1.0;                           // Mass of a particle
+    const double g = 0.2;                           // Attraction acceleration between particles
+    const double gamma_c = 0.2;                     // Elastic (collision) damping coefficient
+
+    const long seed = 0;                          // Deterministic seed for pRNG for reproducibility
+
+    std::vector<Eigen::Vector3d> x0, v0;
+
+    std::mt19937_64 mt(seed);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (long i = 0; i < 100; i ++) {
+        Eigen::Vector3d x_part;
+        do {
+            x_part = {dist(mt), dist(mt), dist(mt)};
+        } while (do_overlap(x0, x_part, r_part));
+        x0.emplace_back(x_part);
+    }
+
+    v0.resize(x0.size(), Eigen::Vector3d::Zero());
+
+    // Reference: the lists are updated by the driver before every step
+    GranularSystem reference_system(k, m, g, gamma_c, r_part, r_cutoff, x0, v0, 0.0, x0.size());
+    for (long n = 0; n < n_steps; n ++) {
+        reference_system.update_neighbor_list();
+        reference_system.do_step(dt);
+    }
+
+    // The lists are updated by the system when the displacements require it
+    GranularSystem system(k, m, g, gamma_c, r_part, r_cutoff, x0, v0, 0.0, x0.size());
+    system.enable_automatic_neighbor_list_updates(r_cutoff);
+
+    long n_observations = 0;
+    std::vector<double> kinetic_energies;
+    system.do_steps(n_steps, dt,
+                    every(1000, [&system, &kinetic_energies, m] (long) {
+                        kinetic_energies.emplace_back(compute_kinetic_energy(system.get_v(), m));
+                    }),
+                    [&n_observations] (long step) {
+                        if (step == n_observations + 1)
+                            n_observations ++;
+                    });
+
+    std::cout << "Neighbor list updates: " << system.get_n_neighbor_list_updates() << " of " << n_steps << " steps" << std::endl;
+
+    // Every pair in the range of the interactions is in the lists at all times, so the trajectories are identical
+    if (system.get_x() != reference_system.get_x() || system.get_v() != reference_system.get_v())
+        return EXIT_FAILURE;
+
+    if (system.get_n_neighbor_list_updates() > n_steps / 10)
+        return EXIT_FAILURE;
+
+    // Observers are called after every step in order
+    if (n_observations != n_steps || (long) kinetic_energies.size() != n_steps / 1000)
+        return EXIT_FAILURE;
+
+    // Observers need a period of at least one step
+    for (long invalid_period : {0l, -1l}) {
+        try {
+            [[maybe_unused]] auto observer = every(invalid_period, [] (long) {});
+            return EXIT_FAILURE;
+        } catch (InvalidArgumentException const &) {}
+    }
+
+    // Automatic updates need a skin, i.e. an interaction range smaller than the radius of the lists
+    for (double invalid_range : {5.0 * r_part, 6.0 * r_part}) {
+        try {
+            system.enable_automatic_neighbor_list_updates(invalid_range);
+            return EXIT_FAILURE;
+        } catch (InvalidArgumentException const &) {}
+    }
+
+    return 0;
+}
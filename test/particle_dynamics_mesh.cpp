@@ -0,0 +1,220 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <random>
+#include <iostream>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/binary_system_omp.h>
+#include <libtimestep/system/binary_system_neighbors_omp.h>
+#include <libtimestep/mesh/particle_mesh.h>
+
+// Charged particles in a periodic box, the short range part of the Coulomb interaction is computed between neighbors
+// and the long range part on the mesh
+class MeshHandler {
+public:
+    MeshHandler(particle_mesh<Eigen::Vector3d, double> & mesh, std::vector<double> const & charges, double m, double r_cutoff) :
+            mesh(mesh), charges(charges), m(m), r_cutoff(r_cutoff) {}
+
+    // Neighbors are found with the minimum image distance
+    double compute_distance(Eigen::Vector3d const & x_i, Eigen::Vector3d const & x_j) const {
+        return mesh.minimum_image(x_i - x_j).norm();
+    }
+
+    // The long range field is computed once per evaluation of accelerations
+    void prepare_accelerations(std::vector<Eigen::Vector3d> const & x,
+                               std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                               double t [[maybe_unused]]) {
+        mesh.solve(x, charges);
+    }
+
+    Eigen::Vector3d compute_acceleration(long i, long j,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) const {
+        Eigen::Vector3d distance = mesh.minimum_image(x[i] - x[j]);
+        if (distance.norm() >= r_cutoff)
+            return Eigen::Vector3d::Zero();
+
+        return charges[i] * charges[j] * mesh.compute_short_range_field(distance) / m;
+    }
+
+    Eigen::Vector3d compute_acceleration(long i,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) const {
+        return charges[i] * mesh.get_field(x[i]) / m;
+    }
+
+private:
+    particle_mesh<Eigen::Vector3d, double> & mesh;
+    std::vector<double> const & charges;
+    const double m, r_cutoff;
+};
+
+template <
+    template <
+        typename _field_container_t,
+        typename _field_value_t,
+        typename _real_t,
+        typename _functor_t,
+        template <
+            typename __field_container_t,
+            typename __field_value_t>
+        typename _step_handler_t>
+    typename integrator_t>
+class MeshSystem : public binary_system_neighbors_omp<Eigen::Vector3d, double, integrator_t, step_handler, MeshHandler, true> {
+public:
+    MeshSystem(MeshHandler & handler, double r_verlet, std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0, long n_part) :
+            binary_system_neighbors_omp<Eigen::Vector3d, double, integrator_t, step_handler, MeshHandler, true>(n_part, r_verlet,
+                    std::move(x0), std::move(v0), 0.0, Eigen::Vector3d::Zero(), 0.0, handler, step_handler_instance) {}
+
+private:
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+// Brute force Ewald summation, the reciprocal space sum is written as a sum over pairs
+class EwaldSystem : public binary_system_omp<Eigen::Vector3d, double, velocity_verlet_half, step_handler, EwaldSystem, false> {
+public:
+    EwaldSystem(particle_mesh<Eigen::Vector3d, double> const & mesh, std::vector<double> const & charges, double m,
+                double box_length, double alpha, long n_max, std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0) :
+            binary_system_omp<Eigen::Vector3d, double, velocity_verlet_half, step_handler, EwaldSystem, false>(std::move(x0), std::move(v0),
+                    0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance),
+            mesh(mesh), charges(charges), m(m) {
+
+        // Wave vectors of one half space, the other half gives the same contribution
+        const double volume = box_length * box_length * box_length;
+        for (long n_x = 0; n_x <= n_max; n_x ++) {
+            for (long n_y = -n_max; n_y <= n_max; n_y ++) {
+                for (long n_z = -n_max; n_z <= n_max; n_z ++) {
+                    if (n_x * n_x + n_y * n_y + n_z * n_z > n_max * n_max)
+                        continue;
+                    if (n_x == 0 && (n_y < 0 || (n_y == 0 && n_z <= 0)))
+                        continue;
+
+                    Eigen::Vector3d k = 2.0 * M_PI / box_length * Eigen::Vector3d(double(n_x), double(n_y), double(n_z));
+                    wave_vectors.emplace_back(k);
+                    coefficients.emplace_back(2.0 * 4.0 * M_PI / volume * std::exp(-k.squaredNorm() / (4.0 * alpha * alpha)) / k.squaredNorm());
+                }
+            }
+        }
+    }
+
+    Eigen::Vector3d compute_acceleration(long i, long j,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) const {
+        Eigen::Vector3d distance = mesh.minimum_image(x[i] - x[j]);
+        Eigen::Vector3d field = mesh.compute_short_range_field(distance);
+
+        for (long k = 0; k < (long) wave_vectors.size(); k ++)
+            field += coefficients[k] * std::sin(wave_vectors[k].dot(distance)) * wave_vectors[k];
+
+        return charges[i] * charges[j] * field / m;
+    }
+
+private:
+    particle_mesh<Eigen::Vector3d, double> const & mesh;
+    std::vector<double> const & charges;
+    const double m;
+    std::vector<Eigen::Vector3d> wave_vectors;
+    std::vector<double> coefficients;
+
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+// Largest error of the accelerations relative to the root mean square of the reference accelerations
+double relative_error(std::vector<Eigen::Vector3d> const & a, std::vector<Eigen::Vector3d> const & reference) {
+    double max_error = 0.0, mean_square = 0.0;
+
+    for (long i = 0; i < (long) a.size(); i ++) {
+        max_error = std::max(max_error, (a[i] - reference[i]).norm());
+        mean_square += reference[i].squaredNorm();
+    }
+
+    return max_error / std::sqrt(mean_square / double(a.size()));
+}
+
+// Returns the time of a call in milliseconds
+template <typename callable_t>
+double time_call(callable_t && call) {
+    auto start = std::chrono::steady_clock::now();
+    call();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    const double box_length = 1.0;             // Side of the periodic box
+    const double alpha = 8.0;                   // Splitting parameter of the interaction
+    const long n_mesh = 32;                     // Number of mesh points along each axis
+    const double m = 1.0;                       // Mass of a particle
+    const double r_part = 0.02;                 // Radius of a particle
+    const long n_part = 200;                    // Number of particles, half of them are positive
+
+    // Meshes that cannot be transformed are rejected
+    try {
+        particle_mesh<Eigen::Vector3d, double> invalid_mesh(24, box_length, alpha);
+        return EXIT_FAILURE;
+    } catch (MeshSizeException const &) {}
+
+    particle_mesh<Eigen::Vector3d, double> mesh(n_mesh, box_length, alpha);
+    const double r_cutoff = mesh.get_cutoff(1.0e-6);
+    const double r_verlet = r_cutoff + 0.05;
+
+    std::mt19937_64 mt(0);
+    std::uniform_real_distribution<double> dist(0.0, box_length);
+
+    std::vector<Eigen::Vector3d> x0;
+    std::vector<double> charges;
+    while ((long) x0.size() < n_part) {
+        Eigen::Vector3d x_part(dist(mt), dist(mt), dist(mt));
+        if (std::any_of(x0.begin(), x0.end(), [&mesh, &x_part, r_part] (auto const & x) {
+            return mesh.minimum_image(x - x_part).norm() < 2.0 * r_part;
+        }))
+            continue;
+
+        x0.emplace_back(x_part);
+        charges.emplace_back(x0.size() % 2 == 0 ? 1.0 : -1.0);
+    }
+    std::vector<Eigen::Vector3d> v0(n_part, Eigen::Vector3d::Zero());
+
+    MeshHandler handler(mesh, charges, m, r_cutoff);
+    MeshSystem<velocity_verlet_half> mesh_system(handler, r_verlet, x0, v0, n_part);
+    EwaldSystem ewald_system(mesh, charges, m, box_length, alpha, 7, x0, v0);
+
+    mesh_system.update_neighbor_list();
+    const double mesh_time = time_call([&mesh_system] () { mesh_system(0, n_part, 0.0); });
+    const double ewald_time = time_call([&ewald_system] () { ewald_system(0, n_part, 0.0); });
+
+    const double error = relative_error(mesh_system.get_a(), ewald_system.get_a());
+    std::cout << "Largest relative error of the P3M accelerations: " << error << std::endl;
+    std::cout << "Time per evaluation: P3M " << mesh_time << " ms, Ewald sum over pairs " << ewald_time << " ms" << std::endl;
+
+    if (error > 0.01)
+        return EXIT_FAILURE;
+
+    // Short run inside of the single region step engine, the neighbor lists follow the periodic images
+    MeshSystem<velocity_verlet_half> reference_system(handler, r_verlet, x0, v0, n_part);
+    MeshSystem<velocity_verlet_half_omp> system(handler, r_verlet, x0, v0, n_part);
+    reference_system.enable_automatic_neighbor_list_updates(r_cutoff);
+    system.enable_automatic_neighbor_list_updates(r_cutoff);
+
+    for (long n = 0; n < 50; n ++) {
+        reference_system.do_step(1.0e-4);
+        system.do_step(1.0e-4);
+    }
+
+    // Weights of different threads are added to the mesh in a different order
+    if (relative_error(system.get_x(), reference_system.get_x()) > 1.0e-12)
+        return EXIT_FAILURE;
+
+    return 0;
+}
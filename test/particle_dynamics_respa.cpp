@@ -0,0 +1,160 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <iostream>
+#include <atomic>
+#include <cmath>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/binary_system_omp.h>
+
+// Binary granular system without damping, integrated with the multiple time step integrator
+// The stiff contact springs are the fast part of the accelerations and the soft attraction is the slow part
+class GranularSystem : public binary_system_omp<Eigen::Vector3d, double, respa_velocity_verlet, step_handler, GranularSystem, false> {
+public:
+    GranularSystem(double k, double m, double g, double r_part,
+                   std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0, double t0) :
+            binary_system_omp<Eigen::Vector3d, double, respa_velocity_verlet, step_handler, GranularSystem, false>(std::move(x0),
+                    std::move(v0), t0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance),
+            k(k), m(m), g(g), r_part(r_part) {}
+
+    // Compute the slowly varying acceleration of particle i due to its attraction to particle j
+    Eigen::Vector3d compute_acceleration(long i, long j,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) {
+        n_slow_evaluations.fetch_add(1, std::memory_order_relaxed);
+
+        return g * (x[j] - x[i]).normalized();
+    }
+
+    // Compute the rapidly varying acceleration of particle i due to its contact with particle j
+    Eigen::Vector3d compute_fast_acceleration(long i, long j,
+                                              std::vector<Eigen::Vector3d> const & x,
+                                              std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                              double t [[maybe_unused]]) {
+        n_fast_evaluations.fetch_add(1, std::memory_order_relaxed);
+
+        Eigen::Vector3d distance = x[j] - x[i];
+        double overlap = distance.norm() - 2.0 * r_part;
+
+        if (overlap >= 0.0)
+            return Eigen::Vector3d::Zero();
+
+        return k * overlap * distance.normalized() / m;
+    }
+
+    // Compute the total (kinetic and potential) energy of the system
+    [[nodiscard]] double compute_energy() const {
+        double energy = 0.0;
+        for (long i = 0; i < (long) this->get_x().size(); i ++) {
+            energy += 0.5 * m * this->get_v()[i].squaredNorm();
+
+            for (long j = i + 1; j < (long) this->get_x().size(); j ++) {
+                double distance = (this->get_x()[j] - this->get_x()[i]).norm();
+                double overlap = std::min(distance - 2.0 * r_part, 0.0);
+
+                energy += m * g * distance + 0.5 * k * overlap * overlap;
+            }
+        }
+
+        return energy;
+    }
+
+    std::atomic<long> n_slow_evaluations = 0, n_fast_evaluations = 0;
+
+private:
+    const double k, m, g, r_part;
+
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+bool do_overlap(std::vector<Eigen::Vector3d> const & particles, Eigen::Vector3d const & x, double r_part) {
+    return std::any_of(particles.begin(), particles.end(), [&x, r_part] (auto const & particle) -> bool {
+        return (particle - x).norm() <= 2.0 * r_part;
+    });
+}
+
+// Integrates the system for time t_tot with slow step dt and n_substeps fast substeps,
+// returns the largest relative deviation of the energy from its initial value
+double compute_energy_drift(GranularSystem & system, double dt, long n_substeps, double t_tot) {
+    system.get_integrator().set_substeps(n_substeps);
+
+    const double initial_energy = system.compute_energy();
+    double drift = 0.0;
+
+    for (long n = 0; n < std::lround(t_tot / dt); n ++) {
+        system.do_step(dt);
+        drift = std::max(drift, std::abs(system.compute_energy() - initial_energy) / std::abs(initial_energy));
+    }
+
+    return drift;
+}
+
+int main() {
+    const double t_tot = 0.5;                       // Integration span
+    const double dt_fast = 1e-4;                    // Time step that resolves the contacts
+    const long n_substeps = 10;                     // Number of contact substeps in a step of the attraction
+    const double r_part = 0.1;                      // Radius of a particle
+    const double k = 1000.0;                        // Elastic stiffness of aa particle
+    const double m = 1.0;                           // Mass of a particle
+    const double g = 0.2;                           // Attraction acceleration between particles
+
+    std::vector<Eigen::Vector3d> x0, v0;
+
+    std::mt19937_64 mt(0);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (long i = 0; i < 50; i ++) {
+        Eigen::Vector3d x_part;
+        do {
+            x_part = {dist(mt), dist(mt), dist(mt)};
+        } while (do_overlap(x0, x_part, r_part));
+        x0.emplace_back(x_part);
+    }
+
+    v0.resize(x0.size(), Eigen::Vector3d::Zero());
+
+    // Both forces are evaluated with the small time step
+    GranularSystem reference_system(k, m, g, r_part, x0, v0, 0.0);
+    double reference_drift = compute_energy_drift(reference_system, dt_fast, 1, t_tot);
+
+    // The attraction is evaluated once every n_substeps contact steps
+    GranularSystem system(k, m, g, r_part, x0, v0, 0.0);
+    double drift = compute_energy_drift(system, dt_fast * double(n_substeps), n_substeps, t_tot);
+
+    std::cout << "Single time step: energy drift " << reference_drift << ", slow pair evaluations "
+              << reference_system.n_slow_evaluations << ", fast pair evaluations " << reference_system.n_fast_evaluations << std::endl;
+    std::cout << "Multiple time step: energy drift " << drift << ", slow pair evaluations "
+              << system.n_slow_evaluations << ", fast pair evaluations " << system.n_fast_evaluations << std::endl;
+
+    if (system.n_slow_evaluations * (n_substeps / 2) > reference_system.n_slow_evaluations) {
+        std::cout << "The slow accelerations are evaluated too often" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (drift > 1e-4) {
+        std::cout << "Energy drift of the multiple time step integrator is too large" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // A step cannot be split into less than one substep
+    for (long invalid_n_substeps : {0l, -1l}) {
+        try {
+            system.get_integrator().set_substeps(invalid_n_substeps);
+            std::cout << "The number of substeps was not checked" << std::endl;
+            return EXIT_FAILURE;
+        } catch (InvalidArgumentException const &) {}
+    }
+
+    if (system.get_integrator().get_substeps() != n_substeps)
+        return EXIT_FAILURE;
+
+    return 0;
+}
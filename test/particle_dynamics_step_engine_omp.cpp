@@ -0,0 +1,106 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <iostream>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/binary_system_neighbors_omp.h>
+
+// Binary granular system that can be integrated with either velocity_verlet_half or velocity_verlet_half_omp
+// Both integrators implement the same scheme, so the trajectories must be identical
+template <
+    template <
+        typename _field_container_t,
+        typename _field_value_t,
+        typename _real_t,
+        typename _functor_t,
+        template <
+            typename __field_container_t,
+            typename __field_value_t>
+        typename _step_handler_t>
+    typename integrator_t>
+class GranularSystem : public binary_system_neighbors_omp<Eigen::Vector3d, double, integrator_t, step_handler, GranularSystem<integrator_t>, false> {
+public:
+    GranularSystem(double k, double m, double g, double gamma_c, double r_part,
+                   std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0, double t0, size_t n_part) :
+            binary_system_neighbors_omp<Eigen::Vector3d, double, integrator_t, step_handler, GranularSystem<integrator_t>, false>(n_part, 5.0 * r_part,
+                    std::move(x0), std::move(v0), t0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance),
+            k(k), m(m), g(g), gamma_c(gamma_c), r_part(r_part) {}
+
+    // Compute the acceleration of particle i due to its interaction with particle j
+    Eigen::Vector3d compute_acceleration(long i, long j,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v,
+                                         double t [[maybe_unused]]) const {
+        Eigen::Vector3d distance = x[j] - x[i];
+        double overlap = distance.norm() - 2.0 * r_part;
+        Eigen::Vector3d n = distance.normalized();
+
+        Eigen::Vector3d force = g * n;
+        if (overlap < 0.0)
+            force += (k * overlap + gamma_c * (v[j] - v[i]).dot(n)) * n;
+
+        return force / m;
+    }
+
+private:
+    const double k, m, g, gamma_c, r_part;
+
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+bool do_overlap(std::vector<Eigen::Vector3d> const & particles, Eigen::Vector3d const & x, double r_part) {
+    return std::any_of(particles.begin(), particles.end(), [&x, r_part] (auto const & particle) -> bool {
+        return (particle - x).norm() <= 2.0 * r_part;
+    });
+}
+
+int main() {
+    const double dt = 0.001;                        // Integration time step
+    const long n_steps = 2000;                      // Number of time steps
+    const double r_part = 0.1;                      // Radius of a particle
+    const double k = 1000.0;                        // Elastic stiffness of aa particle
+    const double m = 1.0;                           // Mass of a particle
+    const double g = 0.2;                           // Attraction acceleration between particles
+    const double gamma_c = 0.2;                     // Elastic (collision) damping coefficient
+
+    std::vector<Eigen::Vector3d> x0, v0;
+
+    std::mt19937_64 mt(0);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (long i = 0; i < 100; i ++) {
+        Eigen::Vector3d x_part;
+        do {
+            x_part = {dist(mt), dist(mt), dist(mt)};
+        } while (do_overlap(x0, x_part, r_part));
+        x0.emplace_back(x_part);
+    }
+
+    v0.resize(x0.size(), Eigen::Vector3d::Zero());
+
+    GranularSystem<velocity_verlet_half> reference_system(k, m, g, gamma_c, r_part, x0, v0, 0.0, x0.size());
+    GranularSystem<velocity_verlet_half_omp> system(k, m, g, gamma_c, r_part, x0, v0, 0.0, x0.size());
+
+    for (long n = 0; n < n_steps; n ++) {
+        if (n % 20 == 0) {
+            reference_system.schedule_neighbor_list_update();
+            system.schedule_neighbor_list_update();
+        }
+        reference_system.do_step(dt);
+        system.do_step(dt);
+    }
+
+    if (reference_system.get_x() != system.get_x() || reference_system.get_v() != system.get_v()) {
+        std::cout << "Trajectories of the single region step engine and of the reference integrator differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return 0;
+}
@@ -0,0 +1,250 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <random>
+#include <iostream>
+#include <cmath>
+#include <utility>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/binary_system_omp.h>
+#include <libtimestep/system/binary_system_tree_omp.h>
+#include <libtimestep/rotational_integrator/rotational_integrator.h>
+#include <libtimestep/rotational_step_handler/rotational_step_handler.h>
+#include <libtimestep/rotational_system/rotational_binary_system_omp.h>
+#include <libtimestep/rotational_system/rotational_binary_system_tree_omp.h>
+
+// Softened gravitational attraction between particles of equal mass
+struct GravityHandler {
+    const double G, epsilon;
+
+    Eigen::Vector3d compute_acceleration(long i, long j,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) const {
+        return compute_far_field_acceleration(i, x[j], 1.0, x, t);
+    }
+
+    // Attraction of particle i to weight particles at center_of_mass
+    Eigen::Vector3d compute_far_field_acceleration(long i,
+                                                   Eigen::Vector3d const & center_of_mass,
+                                                   double weight,
+                                                   std::vector<Eigen::Vector3d> const & x,
+                                                   double t [[maybe_unused]]) const {
+        Eigen::Vector3d distance = center_of_mass - x[i];
+        const double r2 = distance.squaredNorm() + epsilon * epsilon;
+        return G * weight * distance / (r2 * std::sqrt(r2));
+    }
+
+    // Gravity, and a short range coupling of angular velocities within r_spin
+    std::pair<Eigen::Vector3d, Eigen::Vector3d> compute_accelerations(long i, long j,
+                                                                      std::vector<Eigen::Vector3d> const & x,
+                                                                      std::vector<Eigen::Vector3d> const & v,
+                                                                      std::vector<Eigen::Vector3d> const & theta [[maybe_unused]],
+                                                                      std::vector<Eigen::Vector3d> const & omega,
+                                                                      double t) const {
+        Eigen::Vector3d alpha = Eigen::Vector3d::Zero();
+        if ((x[j] - x[i]).norm() < r_spin)
+            alpha = omega[j] - omega[i];
+
+        return {compute_acceleration(i, j, x, v, t), alpha};
+    }
+
+    std::pair<Eigen::Vector3d, Eigen::Vector3d> compute_far_field_accelerations(long i,
+                                                                                Eigen::Vector3d const & center_of_mass,
+                                                                                double weight,
+                                                                                std::vector<Eigen::Vector3d> const & x,
+                                                                                double t) const {
+        return {compute_far_field_acceleration(i, center_of_mass, weight, x, t), Eigen::Vector3d::Zero()};
+    }
+
+    static constexpr double r_spin = 0.1;
+};
+
+template <
+    template <
+        typename _field_container_t,
+        typename _field_value_t,
+        typename _real_t,
+        typename _functor_t,
+        template <
+            typename __field_container_t,
+            typename __field_value_t>
+        typename _step_handler_t>
+    typename integrator_t>
+class TreeSystem : public binary_system_tree_omp<Eigen::Vector3d, double, integrator_t, step_handler, GravityHandler, false> {
+public:
+    TreeSystem(GravityHandler & handler, double theta, double r_near, std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0) :
+            binary_system_tree_omp<Eigen::Vector3d, double, integrator_t, step_handler, GravityHandler, false>(theta, r_near,
+                    std::move(x0), std::move(v0), 0.0, Eigen::Vector3d::Zero(), 0.0, handler, step_handler_instance) {}
+
+private:
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+class DirectSystem : public binary_system_omp<Eigen::Vector3d, double, velocity_verlet_half, step_handler, GravityHandler, false> {
+public:
+    DirectSystem(GravityHandler & handler, std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0) :
+            binary_system_omp<Eigen::Vector3d, double, velocity_verlet_half, step_handler, GravityHandler, false>(
+                    std::move(x0), std::move(v0), 0.0, Eigen::Vector3d::Zero(), 0.0, handler, step_handler_instance) {}
+
+private:
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+class RotationalTreeSystem : public rotational_binary_system_tree_omp<Eigen::Vector3d, double, rotational_velocity_verlet_half, rotational_step_handler, GravityHandler, false> {
+public:
+    RotationalTreeSystem(GravityHandler & handler, double theta, double r_near, std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0,
+                         std::vector<Eigen::Vector3d> theta0, std::vector<Eigen::Vector3d> omega0) :
+            rotational_binary_system_tree_omp<Eigen::Vector3d, double, rotational_velocity_verlet_half, rotational_step_handler, GravityHandler, false>(theta, r_near,
+                    std::move(x0), std::move(v0), std::move(theta0), std::move(omega0), 0.0, Eigen::Vector3d::Zero(), 0.0, handler, step_handler_instance) {}
+
+private:
+    rotational_step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+class RotationalDirectSystem : public rotational_binary_system_omp<Eigen::Vector3d, double, rotational_velocity_verlet_half, rotational_step_handler, GravityHandler, false> {
+public:
+    RotationalDirectSystem(GravityHandler & handler, std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0,
+                           std::vector<Eigen::Vector3d> theta0, std::vector<Eigen::Vector3d> omega0) :
+            rotational_binary_system_omp<Eigen::Vector3d, double, rotational_velocity_verlet_half, rotational_step_handler, GravityHandler, false>(
+                    std::move(x0), std::move(v0), std::move(theta0), std::move(omega0), 0.0, Eigen::Vector3d::Zero(), 0.0, handler, step_handler_instance) {}
+
+private:
+    rotational_step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+// Positions of n particles in a few clusters, as in an aggregating suspension
+std::vector<Eigen::Vector3d> generate_clusters(long n, std::mt19937_64 & mt) {
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    std::normal_distribution<double> normal(0.0, 0.1);
+
+    std::vector<Eigen::Vector3d> centers(8);
+    for (auto & center : centers)
+        center = {uniform(mt), uniform(mt), uniform(mt)};
+
+    std::vector<Eigen::Vector3d> x(n);
+    for (long i = 0; i < n; i ++)
+        x[i] = centers[i % centers.size()] + Eigen::Vector3d(normal(mt), normal(mt), normal(mt));
+
+    return x;
+}
+
+// Largest error of the accelerations relative to the root mean square of the reference accelerations
+double relative_error(std::vector<Eigen::Vector3d> const & a, std::vector<Eigen::Vector3d> const & reference) {
+    double max_error = 0.0, mean_square = 0.0;
+
+    for (long i = 0; i < (long) a.size(); i ++) {
+        max_error = std::max(max_error, (a[i] - reference[i]).norm());
+        mean_square += reference[i].squaredNorm();
+    }
+
+    return max_error / std::sqrt(mean_square / double(a.size()));
+}
+
+int main() {
+    const double dt = 1.0e-3;                   // Integration time step
+    const double theta = 0.5;                   // Opening angle of the tree
+    const double r_near = 0.05;                 // Distance within which the particles always interact directly
+
+    GravityHandler handler {1.0e-3, 0.01};
+
+    std::mt19937_64 mt(0);
+
+    // Accelerations of the tree agree with the direct sum
+    const long n_part = 2000;
+    auto x0 = generate_clusters(n_part, mt);
+    std::vector<Eigen::Vector3d> v0(n_part, Eigen::Vector3d::Zero());
+
+    DirectSystem direct_system(handler, x0, v0);
+    TreeSystem<velocity_verlet_half> tree_system(handler, theta, r_near, x0, v0);
+    direct_system(0, n_part, 0.0);
+    tree_system(0, n_part, 0.0);
+
+    const double error = relative_error(tree_system.get_a(), direct_system.get_a());
+    std::cout << "Largest relative error of the accelerations: " << error << std::endl;
+
+    // Groups only carry their centers of mass, so the error is set by the quadrupole moments
+    if (error > 0.03)
+        return EXIT_FAILURE;
+
+    // With a zero opening angle every pair interacts directly
+    tree_system.set_opening_angle(0.0);
+    tree_system(0, n_part, 0.0);
+
+    if (relative_error(tree_system.get_a(), direct_system.get_a()) > 1.0e-12 || tree_system.get_n_interactions() != n_part * (n_part - 1))
+        return EXIT_FAILURE;
+
+    // Without a near range and with a wide opening angle, a field still never interacts with a group that contains it:
+    // every field is visited exactly once, and the field itself is visited directly
+    tree_system.set_opening_angle(2.0);
+    tree_system(0, n_part, 0.0);
+    for (long i = 0; i < n_part; i ++) {
+        bool self_visited = false;
+        double n_visited = 0.0;
+        tree_system.get_tree().traverse(x0[i], 2.0, 0.0, [i, &self_visited, &n_visited] (long j) {
+            self_visited = self_visited || i == j;
+            n_visited += 1.0;
+        }, [&n_visited] (Eigen::Vector3d const & center_of_mass [[maybe_unused]], double weight) {
+            n_visited += weight;
+        }, i);
+
+        if (!self_visited || n_visited != double(n_part))
+            return EXIT_FAILURE;
+    }
+    tree_system.set_opening_angle(theta);
+
+    // The number of interactions grows as N log N
+    std::vector<std::pair<long, long>> n_interactions;
+    for (long n : {2000l, 16000l}) {
+        TreeSystem<velocity_verlet_half> system(handler, theta, r_near, generate_clusters(n, mt), std::vector<Eigen::Vector3d>(n, Eigen::Vector3d::Zero()));
+        system(0, n, 0.0);
+        n_interactions.emplace_back(n, system.get_n_interactions());
+    }
+
+    for (auto [n, count] : n_interactions)
+        std::cout << "Interactions per particle for " << n << " particles: " << double(count) / double(n) << std::endl;
+
+    // Interactions per particle of a direct sum would grow 8 times, the tree adds a few levels
+    if (double(n_interactions[1].second) / double(n_interactions[0].second) > 3.0 * 8.0)
+        return EXIT_FAILURE;
+
+    // The tree is rebuilt by the whole team inside of the single region step engine
+    TreeSystem<velocity_verlet_half> reference_system(handler, theta, r_near, x0, v0);
+    TreeSystem<velocity_verlet_half_omp> system(handler, theta, r_near, x0, v0);
+    for (long n = 0; n < 100; n ++) {
+        reference_system.do_step(dt);
+        system.do_step(dt);
+    }
+
+    if (reference_system.get_x() != system.get_x() || reference_system.get_v() != system.get_v())
+        return EXIT_FAILURE;
+
+    // Rotational systems, the short range coupling of angular velocities is always computed directly
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    const long n_rotational = 500;
+    auto x0_rotational = generate_clusters(n_rotational, mt);
+    std::vector<Eigen::Vector3d> omega0(n_rotational);
+    for (auto & omega : omega0)
+        omega = {uniform(mt), uniform(mt), uniform(mt)};
+    std::vector<Eigen::Vector3d> zero(n_rotational, Eigen::Vector3d::Zero());
+
+    RotationalDirectSystem rotational_direct_system(handler, x0_rotational, zero, zero, omega0);
+    RotationalTreeSystem rotational_tree_system(handler, theta, GravityHandler::r_spin, x0_rotational, zero, zero, omega0);
+    rotational_direct_system(0, n_rotational, 0.0);
+    rotational_tree_system(0, n_rotational, 0.0);
+
+    const double rotational_error = relative_error(rotational_tree_system.get_a(), rotational_direct_system.get_a());
+    const double angular_error = relative_error(rotational_tree_system.get_alpha(), rotational_direct_system.get_alpha());
+    std::cout << "Largest relative errors of the rotational system: " << rotational_error << ", " << angular_error << std::endl;
+
+    if (rotational_error > 0.03 || angular_error > 1.0e-12)
+        return EXIT_FAILURE;
+
+    return 0;
+}
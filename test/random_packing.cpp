@@ -0,0 +1,129 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <random>
+#include <iostream>
+#include <chrono>
+#include <numeric>
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <cmath>
+
+#include <omp.h>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/packing/random_packing.h>
+
+// Returns true if any two spheres overlap, by sorting them into columns along the z axis that are as wide as the
+// largest sphere, and checking the neighboring columns
+bool any_overlap(std::vector<Eigen::Vector3d> const & x, std::vector<double> const & radii) {
+    const double width = 2.0 * *std::max_element(radii.begin(), radii.end());
+
+    auto column = [&x, width] (long i, long dx, long dy) {
+        return std::make_pair(long(std::floor(x[i][0] / width)) + dx, long(std::floor(x[i][1] / width)) + dy);
+    };
+    auto key = [&x, &column] (long i) {
+        return std::make_tuple(column(i, 0, 0), x[i][2]);
+    };
+
+    std::vector<long> order(x.size());
+    std::iota(order.begin(), order.end(), 0l);
+    std::sort(order.begin(), order.end(), [&key] (long i, long j) { return key(i) < key(j); });
+
+    for (long i = 0; i < (long) x.size(); i ++) {
+        for (long dx = -1; dx <= 1; dx ++) {
+            for (long dy = -1; dy <= 1; dy ++) {
+                const auto lower = std::make_tuple(column(i, dx, dy), x[i][2] - width);
+                auto itr = std::lower_bound(order.begin(), order.end(), lower, [&key] (long j, auto const & value) { return key(j) < value; });
+                for (; itr != order.end() && column(*itr, 0, 0) == column(i, dx, dy) && x[*itr][2] <= x[i][2] + width; itr ++) {
+                    if (*itr != i && (x[i] - x[*itr]).norm() <= radii[i] + radii[*itr])
+                        return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// Returns true if all centers are inside of the box
+bool inside(std::vector<Eigen::Vector3d> const & x, Eigen::Vector3d const & box_min, Eigen::Vector3d const & box_max) {
+    return std::all_of(x.begin(), x.end(), [&box_min, &box_max] (auto const & position) {
+        return (position.array() >= box_min.array()).all() && (position.array() <= box_max.array()).all();
+    });
+}
+
+// Returns the time of a call in seconds
+template <typename callable_t>
+double time_call(callable_t && call) {
+    auto start = std::chrono::steady_clock::now();
+    call();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    const size_t seed = 0;          // Deterministic seed for reproducibility
+
+    // A million equal spheres at a volume fraction of 0.25
+    {
+        const std::vector<double> radii(1000000, 0.5);
+        const double length = packing_box_length(radii, 0.25);
+        const Eigen::Vector3d box_min = Eigen::Vector3d::Zero(), box_max = Eigen::Vector3d::Constant(length);
+
+        std::vector<Eigen::Vector3d> x;
+        const double packing_time = time_call([&] () { x = random_packing(radii, box_min, box_max, seed); });
+        std::cout << "Placed " << x.size() << " spheres in " << packing_time << " s" << std::endl;
+
+        if (x.size() != radii.size() || !inside(x, box_min, box_max) || any_overlap(x, radii))
+            return EXIT_FAILURE;
+    }
+
+    // Spheres with radii between 0.5 and 1.5 at a volume fraction of 0.25, in a box that is not a cube
+    {
+        std::mt19937_64 mt(seed);
+        std::uniform_real_distribution<double> dist(0.5, 1.5);
+        std::vector<double> radii(100000);
+        for (auto & r : radii)
+            r = dist(mt);
+
+        const double length = packing_box_length(radii, 0.25);
+        const Eigen::Vector3d box_min(-length, -length / 4.0, 0.0), box_max(length, length / 4.0, length);
+
+        const auto x = random_packing(radii, box_min, box_max, seed);
+        if (!inside(x, box_min, box_max) || any_overlap(x, radii))
+            return EXIT_FAILURE;
+
+        // The check above finds an overlap of two spheres that only just touch
+        auto x_touching = x;
+        x_touching[1] = x_touching[0] + Eigen::Vector3d(radii[0] + radii[1], 0.0, 0.0);
+        if (!any_overlap(x_touching, radii))
+            return EXIT_FAILURE;
+
+        // The packing only depends on the seed, not on the number of threads
+        const int n_threads = omp_get_max_threads();
+        omp_set_num_threads(1);
+        const auto x_serial = random_packing(radii, box_min, box_max, seed);
+        omp_set_num_threads(4);
+        const auto x_parallel = random_packing(radii, box_min, box_max, seed);
+        omp_set_num_threads(n_threads);
+
+        if (x_serial != x || x_parallel != x)
+            return EXIT_FAILURE;
+
+        if (random_packing(radii, box_min, box_max, seed + 1) == x)
+            return EXIT_FAILURE;
+    }
+
+    // Random sequential addition cannot reach a volume fraction of 0.5
+    try {
+        const std::vector<double> radii(1000, 0.5);
+        const double length = packing_box_length(radii, 0.5);
+        [[maybe_unused]] auto x = random_packing(radii, Eigen::Vector3d::Zero().eval(), Eigen::Vector3d::Constant(length).eval(), seed, 100);
+        return EXIT_FAILURE;
+    } catch (PackingException const &) {}
+
+    return 0;
+}
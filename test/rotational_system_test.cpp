@@ -12,6 +12,8 @@
 #include <libtimestep/rotational_integrator/rotational_integrator.h>
 #include <libtimestep/rotational_system/rotational_binary_system.h>
 #include <libtimestep/rotational_step_handler/rotational_step_handler.h>
+#include <libtimestep/io/async_output.h>
+#include <libtimestep/io/trajectory_recorder.h>
 
 #include "compute_energy.h"
 #include "write_vtk.h"
@@ -124,8 +126,13 @@ int main() {
 
     RotationalGranularSystem system(k, g, r_part, m, gamma_c, x0, v0, theta0, omega0, 0.0);
 
-    std::vector<std::vector<Eigen::Vector3d>> solution_buffer;
-    std::vector<double> time_buffer;
+    // The positions of every 10th step are kept in memory, the storage is allocated once
+    trajectory_recorder<Eigen::Vector3d, double> recorder(system, long(n_steps / 10), 10);
+
+    // The dumps are written on a background thread while the time stepping continues
+    async_output<Eigen::Vector3d, double> output([r_part, dump_period] (auto const & snapshot) {
+        write_vtk(snapshot.x, r_part, snapshot.step / dump_period, "data");
+    });
 
     // Start the execution timer
     auto start_time = std::chrono::high_resolution_clock::now();
@@ -134,20 +141,21 @@ int main() {
     for (size_t n = 0; n < n_steps; n ++) {
 
         if (n % dump_period == 0) {
-            write_vtk(system.get_x(), r_part, n / dump_period, "data");
+            output.submit(system, long(n), t);
 
 //            std::cout << "Kinetic energy: " << compute_kinetic_energy(system.get_v(), m) << std::endl;
             std::cout << "Linear momentum: " << compute_linear_momentum(system.get_v(), m) << std::endl;
         }
 
-        time_buffer.emplace_back(t);
-        solution_buffer.emplace_back(system.get_x());
+        recorder.record(system, long(n), t);
 
         system.do_step(dt);
 
         t += dt;
     }
 
+    output.flush();
+
     // End the exceution times
     auto end_time = std::chrono::high_resolution_clock::now();
 
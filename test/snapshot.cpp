@@ -0,0 +1,193 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <random>
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <algorithm>
+#include <utility>
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/rotational_integrator/rotational_integrator.h>
+#include <libtimestep/rotational_step_handler/rotational_step_handler.h>
+#include <libtimestep/rotational_system/rotational_unary_system.h>
+#include <libtimestep/io/snapshot.h>
+
+// Independent translational and torsional oscillators
+class OscillatorSystem : public rotational_unary_system<Eigen::Vector3d, double, rotational_velocity_verlet_half, rotational_step_handler, OscillatorSystem> {
+public:
+    OscillatorSystem(std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0,
+                     std::vector<Eigen::Vector3d> theta0, std::vector<Eigen::Vector3d> omega0) :
+            rotational_unary_system<Eigen::Vector3d, double, rotational_velocity_verlet_half, rotational_step_handler, OscillatorSystem>(
+                    std::move(x0), std::move(v0), std::move(theta0), std::move(omega0), 0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance) {}
+
+    std::pair<Eigen::Vector3d, Eigen::Vector3d> compute_acceleration(size_t i,
+                                                                     std::vector<Eigen::Vector3d> const & x,
+                                                                     std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                                                     std::vector<Eigen::Vector3d> const & theta,
+                                                                     std::vector<Eigen::Vector3d> const & omega [[maybe_unused]],
+                                                                     double t [[maybe_unused]]) {
+        return {-x[i], -4.0 * theta[i]};
+    }
+
+private:
+    rotational_step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+// Fields that are all set to the index of the step, so that a snapshot mixing two steps is easy to detect
+class StepFields {
+public:
+    explicit StepFields(long n_part) : x(n_part), v(n_part) {}
+
+    void set_step(long step) {
+        std::fill(x.begin(), x.end(), Eigen::Vector3d::Constant(double(step)));
+        std::fill(v.begin(), v.end(), Eigen::Vector3d::Constant(-double(step)));
+    }
+
+    [[nodiscard]] std::vector<Eigen::Vector3d> const & get_x() const {
+        return x;
+    }
+
+    [[nodiscard]] std::vector<Eigen::Vector3d> const & get_v() const {
+        return v;
+    }
+
+private:
+    std::vector<Eigen::Vector3d> x, v;
+};
+
+// Returns true if the arrays seen by a reader all belong to the same step
+template <typename span_t>
+bool is_consistent(long step, double t, span_t const & x, span_t const & v) {
+    return t == 0.5 * double(step)
+           && std::all_of(x.begin(), x.end(), [step] (auto const & value) { return value == Eigen::Vector3d::Constant(double(step)); })
+           && std::all_of(v.begin(), v.end(), [step] (auto const & value) { return value == Eigen::Vector3d::Constant(-double(step)); });
+}
+
+int main() {
+    const long n_part = 20000;      // Number of particles
+    const long n_publish = 500;     // Number of snapshots published by the concurrent tests
+
+    StepFields fields(n_part);
+
+    // Another process maps the shared memory object and reads consistent snapshots while they are published
+    // (this runs first, so that no other threads exist when the process is forked)
+    {
+        const std::string name = "/libtimestep_snapshot_test_" + std::to_string(::getpid());
+        snapshot_publisher<Eigen::Vector3d, double> publisher(fields, 3, name);
+
+        const pid_t child = ::fork();
+        if (child == 0) {
+            try {
+                snapshot_reader<Eigen::Vector3d, double> reader(name);
+                long n_consistent = 0;
+                while (n_consistent < 100) {
+                    bool consistent = true;
+                    const bool valid = reader.visit([&consistent] (long step, double t, auto x, auto v, auto theta, auto) {
+                        consistent = is_consistent(step, t, x, v) && theta.empty();
+                    });
+                    // Only values that the reader validated have to be consistent
+                    if (valid && !consistent)
+                        ::_exit(EXIT_FAILURE);
+                    n_consistent += valid;
+                }
+                ::_exit(0);
+            } catch (...) {
+                ::_exit(EXIT_FAILURE);
+            }
+        }
+
+        int status = 0;
+        for (long step = 1; ::waitpid(child, &status, WNOHANG) == 0; step ++) {
+            fields.set_step(step);
+            publisher.publish(fields, step, 0.5 * double(step));
+        }
+
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            return EXIT_FAILURE;
+
+        std::cout << "Published " << publisher.get_n_published() << " snapshots to another process" << std::endl;
+    }
+
+    // Readers on another thread only see consistent snapshots, the publisher never waits for them
+    {
+        fields.set_step(0);
+        snapshot_publisher<Eigen::Vector3d, double> publisher(fields);
+        snapshot_reader<Eigen::Vector3d, double> reader(publisher);
+
+        std::atomic<bool> done = false, failed = false;
+        long n_reads = 0, n_overwritten = 0;
+        std::thread reader_thread([&] () {
+            output_snapshot<Eigen::Vector3d, double> snapshot;
+            while (!done.load()) {
+                if (reader.read(snapshot)) {
+                    if (!is_consistent(snapshot.step, snapshot.t, snapshot.x, snapshot.v))
+                        failed = true;
+                    n_reads ++;
+                }
+
+                if (reader.get_n_published() == 0)
+                    continue;
+
+                bool consistent = true;
+                const bool valid = reader.visit([&consistent] (long step, double t, auto x, auto v, auto, auto) {
+                    consistent = is_consistent(step, t, x, v);
+                });
+                if (valid && !consistent)
+                    failed = true;
+                n_overwritten += !valid;
+            }
+        });
+
+        for (long step = 1; step <= n_publish; step ++) {
+            fields.set_step(step);
+            publisher.publish(fields, step, 0.5 * double(step));
+        }
+        done = true;
+        reader_thread.join();
+
+        std::cout << n_reads << " consistent reads, " << n_overwritten << " visits discarded" << std::endl;
+
+        if (failed || publisher.get_n_published() != n_publish)
+            return EXIT_FAILURE;
+    }
+
+    // Snapshots of rotational systems hold the angular fields too
+    {
+        std::mt19937_64 mt(0);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        auto random_fields = [&mt, &dist] () {
+            std::vector<Eigen::Vector3d> values(100);
+            for (auto & value : values)
+                value = {dist(mt), dist(mt), dist(mt)};
+            return values;
+        };
+
+        OscillatorSystem system(random_fields(), random_fields(), random_fields(), random_fields());
+        snapshot_publisher<Eigen::Vector3d, double> publisher(system);
+        snapshot_reader<Eigen::Vector3d, double> reader(publisher);
+
+        output_snapshot<Eigen::Vector3d, double> snapshot;
+        if (reader.read(snapshot))
+            return EXIT_FAILURE;
+
+        for (long n = 0; n < 10; n ++) {
+            system.do_step(0.01);
+            publisher.publish(system, n, 0.01 * double(n + 1));
+        }
+
+        if (!reader.read(snapshot) || snapshot.step != 9 || snapshot.x != system.get_x() || snapshot.v != system.get_v()
+                || snapshot.theta != system.get_theta() || snapshot.omega != system.get_omega())
+            return EXIT_FAILURE;
+    }
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <random>
+#include <iostream>
+#include <filesystem>
+#include <utility>
+#include <map>
+#include <optional>
+#include <algorithm>
+#include <iterator>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/rotational_integrator/rotational_integrator.h>
+#include <libtimestep/rotational_step_handler/rotational_step_handler.h>
+#include <libtimestep/rotational_system/rotational_unary_system.h>
+#include <libtimestep/io/trajectory.h>
+
+// Independent translational and torsional oscillators
+class OscillatorSystem : public rotational_unary_system<Eigen::Vector3d, double, rotational_velocity_verlet_half, rotational_step_handler, OscillatorSystem> {
+public:
+    OscillatorSystem(std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0,
+                     std::vector<Eigen::Vector3d> theta0, std::vector<Eigen::Vector3d> omega0) :
+            rotational_unary_system<Eigen::Vector3d, double, rotational_velocity_verlet_half, rotational_step_handler, OscillatorSystem>(
+                    std::move(x0), std::move(v0), std::move(theta0), std::move(omega0), 0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance) {}
+
+    std::pair<Eigen::Vector3d, Eigen::Vector3d> compute_acceleration(size_t i,
+                                                                     std::vector<Eigen::Vector3d> const & x,
+                                                                     std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                                                     std::vector<Eigen::Vector3d> const & theta,
+                                                                     std::vector<Eigen::Vector3d> const & omega [[maybe_unused]],
+                                                                     double t [[maybe_unused]]) {
+        return {-x[i], -4.0 * theta[i]};
+    }
+
+private:
+    rotational_step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+int main() {
+    const double dt = 0.01;         // Integration time step
+    const long n_part = 1000;       // Number of particles
+    const long n_frames = 300;      // Number of frames, the file is extended 5 times by 64 frames
+
+    const auto path = std::filesystem::temp_directory_path() / "libtimestep_trajectory_test.traj";
+
+    std::mt19937_64 mt(0);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    auto random_fields = [&mt, &dist] () {
+        std::vector<Eigen::Vector3d> fields(n_part);
+        for (auto & field : fields)
+            field = {dist(mt), dist(mt), dist(mt)};
+        return fields;
+    };
+
+    OscillatorSystem system(random_fields(), random_fields(), random_fields(), random_fields());
+
+    // A few frames are kept in memory to check the file
+    std::map<long, std::vector<std::vector<Eigen::Vector3d>>> kept_frames;
+    const std::vector<long> frames_to_keep = {0, 63, 64, 137, n_frames - 1};
+
+    {
+        trajectory_writer<Eigen::Vector3d, double> writer(path.string(), system);
+        std::optional<trajectory_reader<Eigen::Vector3d, double>> follower;
+
+        for (long n = 0; n < n_frames; n ++) {
+            writer.write(system, n, double(n) * dt);
+
+            if (std::find(frames_to_keep.begin(), frames_to_keep.end(), n) != frames_to_keep.end())
+                kept_frames[n] = {system.get_x(), system.get_v(), system.get_theta(), system.get_omega()};
+
+            // A reader follows the trajectory as it is written
+            if (n == 99)
+                follower.emplace(path.string());
+
+            if (n == 99 || n == 199) {
+                follower->refresh();
+                if (follower->get_n_frames() != n + 1 || follower->get_step(n) != n)
+                    return EXIT_FAILURE;
+            }
+
+            system.do_step(dt);
+        }
+    }
+
+    // The unused part of the last chunk is cut off
+    trajectory_reader<Eigen::Vector3d, double> reader(path.string());
+    if (reader.get_n_frames() != n_frames || reader.get_n_particles() != n_part || !reader.has_rotation())
+        return EXIT_FAILURE;
+
+    const auto frame_size = (std::filesystem::file_size(path) - trajectory_header_size) / n_frames;
+    if (trajectory_header_size + n_frames * frame_size != std::filesystem::file_size(path) || frame_size < 4 * n_part * sizeof(Eigen::Vector3d))
+        return EXIT_FAILURE;
+
+    // Any frame and range of particles is read from the map without copying
+    for (auto const & [frame, fields] : kept_frames) {
+        if (reader.get_step(frame) != frame || reader.get_time(frame) != double(frame) * dt)
+            return EXIT_FAILURE;
+
+        for (auto field : {trajectory_field::x, trajectory_field::v, trajectory_field::theta, trajectory_field::omega}) {
+            auto values = reader.get_field(field, frame, 100, 200);
+            if (!std::equal(values.begin(), values.end(), fields[long(field)].begin() + 100))
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (reader.get_field(trajectory_field::x, 137, 0, n_part).data() != reader.get_field(trajectory_field::x, 137, 10, 20).data() - 10)
+        return EXIT_FAILURE;
+
+    // A reader with other types converts the values when copying, and cannot use the map directly
+    trajectory_reader<Eigen::Vector3f, float> float_reader(path.string());
+    auto float_values = float_reader.read_field(trajectory_field::omega, 137, 0, n_part);
+    for (long i = 0; i < n_part; i ++) {
+        if ((float_values[i].cast<double>() - kept_frames[137][3][i]).norm() > 1e-6)
+            return EXIT_FAILURE;
+    }
+
+    try {
+        [[maybe_unused]] auto values = float_reader.get_field(trajectory_field::x, 0, 0, n_part);
+        return EXIT_FAILURE;
+    } catch (InputException const &) {}
+
+    // Out of range accesses are rejected
+    try {
+        [[maybe_unused]] auto values = reader.get_field(trajectory_field::x, n_frames, 0, n_part);
+        return EXIT_FAILURE;
+    } catch (InputException const &) {}
+
+    // A failed refresh keeps the current map, a copy of the trajectory is cut short of a header to make it fail
+    const auto copy_path = std::filesystem::temp_directory_path() / "libtimestep_trajectory_test_copy.traj";
+    std::filesystem::copy_file(path, copy_path, std::filesystem::copy_options::overwrite_existing);
+    {
+        trajectory_reader<Eigen::Vector3d, double> copy_reader(copy_path.string());
+        std::filesystem::resize_file(copy_path, sizeof(trajectory_header));
+
+        try {
+            copy_reader.refresh();
+            return EXIT_FAILURE;
+        } catch (InputException const &) {}
+
+        if (copy_reader.get_n_frames() != n_frames || copy_reader.get_n_particles() != n_part)
+            return EXIT_FAILURE;
+    }
+
+    // A file that is not a trajectory is rejected, and is not left open
+    std::filesystem::resize_file(copy_path, 0);
+    std::filesystem::resize_file(copy_path, trajectory_header_size);
+    auto count_open_files = [] () {
+        return std::distance(std::filesystem::directory_iterator("/proc/self/fd"), std::filesystem::directory_iterator());
+    };
+    const auto n_open_files = count_open_files();
+    for (long k = 0; k < 10; k ++) {
+        try {
+            trajectory_reader<Eigen::Vector3d, double> invalid_reader(copy_path.string());
+            return EXIT_FAILURE;
+        } catch (InputException const &) {}
+    }
+    if (count_open_files() != n_open_files)
+        return EXIT_FAILURE;
+
+    std::filesystem::remove(copy_path);
+
+    std::cout << "Trajectory of " << n_frames << " frames: " << std::filesystem::file_size(path) << " bytes" << std::endl;
+
+    std::filesystem::remove(path);
+
+    return 0;
+}
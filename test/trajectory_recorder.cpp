@@ -0,0 +1,169 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <random>
+#include <iostream>
+#include <utility>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/unary_system.h>
+#include <libtimestep/rotational_integrator/rotational_integrator.h>
+#include <libtimestep/rotational_step_handler/rotational_step_handler.h>
+#include <libtimestep/rotational_system/rotational_unary_system.h>
+#include <libtimestep/io/trajectory_recorder.h>
+
+// Independent harmonic oscillators
+class OscillatorSystem : public unary_system<Eigen::Vector3d, double, velocity_verlet_half, step_handler, OscillatorSystem> {
+public:
+    OscillatorSystem(std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0) :
+            unary_system<Eigen::Vector3d, double, velocity_verlet_half, step_handler, OscillatorSystem>(std::move(x0), std::move(v0),
+                    0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance) {}
+
+    Eigen::Vector3d compute_acceleration(size_t i,
+                                         std::vector<Eigen::Vector3d> const & x,
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) {
+        return -x[i];
+    }
+
+private:
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+// Independent translational and torsional oscillators
+class RotationalOscillatorSystem : public rotational_unary_system<Eigen::Vector3d, double, rotational_velocity_verlet_half, rotational_step_handler, RotationalOscillatorSystem> {
+public:
+    RotationalOscillatorSystem(std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0,
+                               std::vector<Eigen::Vector3d> theta0, std::vector<Eigen::Vector3d> omega0) :
+            rotational_unary_system<Eigen::Vector3d, double, rotational_velocity_verlet_half, rotational_step_handler, RotationalOscillatorSystem>(
+                    std::move(x0), std::move(v0), std::move(theta0), std::move(omega0), 0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance) {}
+
+    std::pair<Eigen::Vector3d, Eigen::Vector3d> compute_acceleration(size_t i,
+                                                                     std::vector<Eigen::Vector3d> const & x,
+                                                                     std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                                                     std::vector<Eigen::Vector3d> const & theta,
+                                                                     std::vector<Eigen::Vector3d> const & omega [[maybe_unused]],
+                                                                     double t [[maybe_unused]]) {
+        return {-x[i], -4.0 * theta[i]};
+    }
+
+private:
+    rotational_step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+int main() {
+    const double dt = 0.01;         // Integration time step
+    const long n_part = 1000;       // Number of particles
+    const long n_steps = 200;       // Number of time steps
+
+    std::mt19937_64 mt(0);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    auto random_fields = [&mt, &dist] () {
+        std::vector<Eigen::Vector3d> fields(n_part);
+        for (auto & field : fields)
+            field = {dist(mt), dist(mt), dist(mt)};
+        return fields;
+    };
+
+    // A ring of 16 frames holds the positions and angular velocities of 3 particles at the last 16 steps divisible by 5
+    RotationalOscillatorSystem rotational_system(random_fields(), random_fields(), random_fields(), random_fields());
+    const std::vector<long> particles = {3, 7, 42};
+    trajectory_recorder<Eigen::Vector3d, double> recorder(rotational_system, 16, 5,
+                                                          {trajectory_field::x, trajectory_field::omega}, particles);
+
+    std::vector<std::vector<Eigen::Vector3d>> x_history, omega_history;
+    Eigen::Vector3d const * storage = nullptr;
+    for (long n = 0; n < n_steps; n ++) {
+        x_history.emplace_back(rotational_system.get_x());
+        omega_history.emplace_back(rotational_system.get_omega());
+
+        if (recorder.record(rotational_system, n, double(n) * dt) != (n % 5 == 0))
+            return EXIT_FAILURE;
+
+        // Recording does not allocate, the frames are in the storage allocated by the constructor
+        if (storage == nullptr)
+            storage = recorder.get_field(trajectory_field::x, 0).data();
+        if (recorder.get_field(trajectory_field::x, 0).data() < storage
+                || recorder.get_field(trajectory_field::x, 0).data() >= storage + 16 * 2 * 3)
+            return EXIT_FAILURE;
+
+        rotational_system.do_step(dt);
+    }
+
+    if (recorder.get_n_frames() != 16)
+        return EXIT_FAILURE;
+
+    for (long frame = 0; frame < 16; frame ++) {
+        const long step = n_steps - 5 * (16 - frame);
+        if (recorder.get_step(frame) != step || recorder.get_time(frame) != double(step) * dt)
+            return EXIT_FAILURE;
+
+        auto x = recorder.get_field(trajectory_field::x, frame);
+        auto omega = recorder.get_field(trajectory_field::omega, frame);
+        for (long k = 0; k < 3; k ++) {
+            if (x[k] != x_history[step][particles[k]] || omega[k] != omega_history[step][particles[k]])
+                return EXIT_FAILURE;
+        }
+    }
+
+    // Fields that are not recorded, and angular fields of systems without rotation, are rejected
+    OscillatorSystem system(random_fields(), random_fields());
+    try {
+        [[maybe_unused]] auto v = recorder.get_field(trajectory_field::v, 0);
+        return EXIT_FAILURE;
+    } catch (OutOfRangeException const &) {}
+
+    try {
+        trajectory_recorder<Eigen::Vector3d, double> theta_recorder(system, 16, 1, {trajectory_field::theta});
+        return EXIT_FAILURE;
+    } catch (OutOfRangeException const &) {}
+
+    // Particles that do not exist and frames that are not held are rejected
+    try {
+        trajectory_recorder<Eigen::Vector3d, double> invalid_recorder(system, 16, 1, {trajectory_field::x}, {0, n_part});
+        return EXIT_FAILURE;
+    } catch (OutOfRangeException const &) {}
+
+    for (long frame : {-1L, recorder.get_n_frames()}) {
+        try {
+            [[maybe_unused]] auto step = recorder.get_step(frame);
+            return EXIT_FAILURE;
+        } catch (OutOfRangeException const &) {}
+
+        try {
+            [[maybe_unused]] auto time = recorder.get_time(frame);
+            return EXIT_FAILURE;
+        } catch (OutOfRangeException const &) {}
+
+        try {
+            [[maybe_unused]] auto x = recorder.get_field(trajectory_field::x, frame);
+            return EXIT_FAILURE;
+        } catch (OutOfRangeException const &) {}
+    }
+
+    // A fixed recorder of all particles keeps the first frames and refuses to overwrite them
+    trajectory_recorder<Eigen::Vector3d, double> fixed_recorder(system, 10, 1, {trajectory_field::x, trajectory_field::v},
+                                                                {}, recorder_mode::fixed);
+    for (long n = 0; n < 10; n ++) {
+        fixed_recorder.record(system, n, double(n) * dt);
+        if (n == 0 && (fixed_recorder.get_field(trajectory_field::v, 0).size() != size_t(n_part)
+                       || !std::equal(system.get_v().begin(), system.get_v().end(), fixed_recorder.get_field(trajectory_field::v, 0).begin())))
+            return EXIT_FAILURE;
+        system.do_step(dt);
+    }
+
+    try {
+        fixed_recorder.record(system, 10, 10.0 * dt);
+        return EXIT_FAILURE;
+    } catch (CapacityExceededException const &) {}
+
+    if (fixed_recorder.get_n_frames() != 10 || fixed_recorder.get_step(9) != 9)
+        return EXIT_FAILURE;
+
+    return 0;
+}
@@ -0,0 +1,218 @@
+//
+// Created by egor on 10/18/26.
+//
+
+#include <vector>
+#include <random>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <utility>
+
+#include <Eigen/Eigen>
+
+#include <libtimestep/integrator/integrator.h>
+#include <libtimestep/step_handler/step_handler.h>
+#include <libtimestep/system/unary_system.h>
+#include <libtimestep/rotational_integrator/rotational_integrator.h>
+#include <libtimestep/rotational_step_handler/rotational_step_handler.h>
+#include <libtimestep/rotational_system/rotational_unary_system.h>
+#include <libtimestep/io/vtu_writer.h>
+
+#include "write_vtk.h"
+
+// Free particles
+class FreeSystem : public unary_system<Eigen::Vector3d, double, velocity_verlet_half, step_handler, FreeSystem> {
+public:
+    FreeSystem(std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0) :
+            unary_system<Eigen::Vector3d, double, velocity_verlet_half, step_handler, FreeSystem>(std::move(x0), std::move(v0),
+                    0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance) {}
+
+    Eigen::Vector3d compute_acceleration(size_t i [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & x [[maybe_unused]],
+                                         std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                         double t [[maybe_unused]]) {
+        return Eigen::Vector3d::Zero();
+    }
+
+private:
+    step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+// Free rotating particles
+class FreeRotationalSystem : public rotational_unary_system<Eigen::Vector3d, double, rotational_velocity_verlet_half, rotational_step_handler, FreeRotationalSystem> {
+public:
+    FreeRotationalSystem(std::vector<Eigen::Vector3d> x0, std::vector<Eigen::Vector3d> v0,
+                         std::vector<Eigen::Vector3d> theta0, std::vector<Eigen::Vector3d> omega0) :
+            rotational_unary_system<Eigen::Vector3d, double, rotational_velocity_verlet_half, rotational_step_handler, FreeRotationalSystem>(
+                    std::move(x0), std::move(v0), std::move(theta0), std::move(omega0), 0.0, Eigen::Vector3d::Zero(), 0.0, *this, step_handler_instance) {}
+
+    std::pair<Eigen::Vector3d, Eigen::Vector3d> compute_acceleration(size_t i [[maybe_unused]],
+                                                                     std::vector<Eigen::Vector3d> const & x [[maybe_unused]],
+                                                                     std::vector<Eigen::Vector3d> const & v [[maybe_unused]],
+                                                                     std::vector<Eigen::Vector3d> const & theta [[maybe_unused]],
+                                                                     std::vector<Eigen::Vector3d> const & omega [[maybe_unused]],
+                                                                     double t [[maybe_unused]]) {
+        return {Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero()};
+    }
+
+private:
+    rotational_step_handler<std::vector<Eigen::Vector3d>, Eigen::Vector3d> step_handler_instance;
+};
+
+// Reads the appended arrays of a .vtu file written by vtu_writer, in the order of their offsets
+std::vector<std::vector<char>> read_vtu_arrays(std::filesystem::path const & path) {
+    std::ifstream ifs(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+    const bool compressed = contents.find("vtkZLibDataCompressor") != std::string::npos;
+    const size_t data_start = contents.find("<AppendedData encoding=\"raw\">\n_") + std::strlen("<AppendedData encoding=\"raw\">\n_");
+
+    std::vector<std::vector<char>> arrays;
+    for (size_t position = contents.find("offset=\""); position < data_start; position = contents.find("offset=\"", position + 1)) {
+        size_t offset = data_start + std::stoul(contents.substr(position + std::strlen("offset=\"")));
+
+        auto read_header = [&contents, &offset] () {
+            std::uint64_t value;
+            std::memcpy(&value, contents.data() + offset, sizeof(value));
+            offset += sizeof(value);
+            return value;
+        };
+
+        std::vector<char> array;
+        if (!compressed) {
+            const std::uint64_t n_bytes = read_header();
+            array.assign(contents.begin() + long(offset), contents.begin() + long(offset + n_bytes));
+        } else {
+#ifdef LIBTIMESTEP_ZLIB
+            const std::uint64_t n_blocks = read_header(), block_size = read_header(), last_block_size = read_header();
+            std::vector<std::uint64_t> compressed_sizes;
+            for (std::uint64_t block = 0; block < n_blocks; block ++)
+                compressed_sizes.emplace_back(read_header());
+
+            for (std::uint64_t block = 0; block < n_blocks; block ++) {
+                uLongf size = block == n_blocks - 1 ? last_block_size : block_size;
+                const size_t begin = array.size();
+                array.resize(begin + size);
+                uncompress(reinterpret_cast<Bytef *>(array.data() + begin), &size, reinterpret_cast<Bytef const *>(contents.data() + offset), compressed_sizes[block]);
+                offset += compressed_sizes[block];
+            }
+#endif
+        }
+
+        arrays.emplace_back(std::move(array));
+    }
+
+    return arrays;
+}
+
+// Returns true if the bytes of an array are the same as the bytes of the fields in range [i_begin, i_end)
+bool same_bytes(std::vector<char> const & array, std::vector<Eigen::Vector3d> const & fields, long i_begin, long i_end) {
+    const auto n_bytes = size_t(i_end - i_begin) * sizeof(Eigen::Vector3d);
+    return array.size() == n_bytes && std::memcmp(array.data(), fields.data() + i_begin, n_bytes) == 0;
+}
+
+// Returns the time of a call in milliseconds
+template <typename callable_t>
+double time_call(callable_t && call) {
+    auto start = std::chrono::steady_clock::now();
+    call();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    const long n_part = 100000;     // Number of particles
+    const double r_part = 0.01;     // Radius of a particle, the legacy writer normalizes the coordinates with it
+
+    const auto directory = std::filesystem::temp_directory_path() / "libtimestep_vtu_writer_test";
+    std::filesystem::create_directories(directory);
+
+    std::mt19937_64 mt(0);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    auto random_fields = [&mt, &dist] (long n) {
+        std::vector<Eigen::Vector3d> fields(n);
+        for (auto & field : fields)
+            field = {dist(mt), dist(mt), dist(mt)};
+        return fields;
+    };
+
+    FreeSystem system(random_fields(n_part), random_fields(n_part));
+    FreeRotationalSystem rotational_system(random_fields(n_part), random_fields(n_part), random_fields(n_part), random_fields(n_part));
+
+    // Raw arrays are the bytes of the buffers: points, then v
+    vtu_writer<Eigen::Vector3d, double> writer(directory.string(), "particles");
+
+    std::string file_name;
+    const double vtu_time = time_call([&] () { file_name = writer.write(system, 0); });
+    auto arrays = read_vtu_arrays(directory / file_name);
+
+    if (arrays.size() != 5 || !same_bytes(arrays[0], system.get_v(), 0, n_part) || !same_bytes(arrays[1], system.get_x(), 0, n_part))
+        return EXIT_FAILURE;
+
+    // Rotational systems also write theta and omega, pieces hold contiguous ranges of the fields
+    const int n_pieces = 3;
+    const std::string parallel_file_name = writer.write_pieces(rotational_system, 1, n_pieces);
+
+    std::ifstream parallel_file(directory / parallel_file_name);
+    std::stringstream parallel_contents;
+    parallel_contents << parallel_file.rdbuf();
+    if (parallel_contents.str().find("Name=\"omega\"") == std::string::npos)
+        return EXIT_FAILURE;
+
+    for (int piece = 0; piece < n_pieces; piece ++) {
+        auto [i_begin, i_end] = static_partition(n_part, piece, n_pieces);
+        auto piece_arrays = read_vtu_arrays(directory / ("particles_1_" + std::to_string(piece) + ".vtu"));
+
+        if (parallel_contents.str().find("particles_1_" + std::to_string(piece) + ".vtu") == std::string::npos)
+            return EXIT_FAILURE;
+
+        if (piece_arrays.size() != 7 || !same_bytes(piece_arrays[0], rotational_system.get_v(), i_begin, i_end)
+                || !same_bytes(piece_arrays[1], rotational_system.get_theta(), i_begin, i_end)
+                || !same_bytes(piece_arrays[2], rotational_system.get_omega(), i_begin, i_end)
+                || !same_bytes(piece_arrays[3], rotational_system.get_x(), i_begin, i_end))
+            return EXIT_FAILURE;
+    }
+
+    // The legacy ASCII writer only writes the positions
+    const double vtk_time = time_call([&] () { write_vtk(system.get_x(), r_part, 0, directory.string()); });
+    std::cout << "Time per dump of " << n_part << " particles: binary VTU " << vtu_time << " ms (x and v), ASCII VTK "
+              << vtk_time << " ms (x only)" << std::endl;
+    std::cout << "File sizes: binary VTU " << std::filesystem::file_size(directory / file_name) << " bytes, ASCII VTK "
+              << std::filesystem::file_size(directory / "particles_0.vtk") << " bytes" << std::endl;
+
+#ifdef LIBTIMESTEP_ZLIB
+    // Compressed arrays decompress to the bytes of the buffers, a lattice compresses well
+    std::vector<Eigen::Vector3d> lattice(n_part);
+    for (long i = 0; i < n_part; i ++)
+        lattice[i] = {double(i % 100), double((i / 100) % 100), double(i / 10000)};
+
+    FreeSystem lattice_system(lattice, std::vector<Eigen::Vector3d>(n_part, Eigen::Vector3d::Zero()));
+    vtu_writer<Eigen::Vector3d, double> compressed_writer(directory.string(), "compressed", vtu_compression::zlib);
+
+    file_name = compressed_writer.write(lattice_system, 0);
+    arrays = read_vtu_arrays(directory / file_name);
+
+    if (arrays.size() != 5 || !same_bytes(arrays[0], lattice_system.get_v(), 0, n_part) || !same_bytes(arrays[1], lattice_system.get_x(), 0, n_part))
+        return EXIT_FAILURE;
+
+    const auto compressed_size = std::filesystem::file_size(directory / file_name);
+    std::cout << "Compressed lattice: " << compressed_size << " bytes" << std::endl;
+
+    if (compressed_size > 2 * n_part * sizeof(Eigen::Vector3d) / 4)
+        return EXIT_FAILURE;
+#else
+    // Compression is rejected if zlib is not compiled in
+    try {
+        vtu_writer<Eigen::Vector3d, double> compressed_writer(directory.string(), "compressed", vtu_compression::zlib);
+        return EXIT_FAILURE;
+    } catch (OutputException const &) {}
+#endif
+
+    std::filesystem::remove_all(directory);
+
+    return 0;
+}